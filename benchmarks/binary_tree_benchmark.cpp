@@ -0,0 +1,188 @@
+#include <benchmark/benchmark.h>
+
+import std;
+import data_structures;
+
+// keys in ascending order (range(1) == 0), the worst case for an unbalanced
+// tree, or shuffled
+static std::vector<int> tree_keys(const benchmark::State& state)
+{
+    std::vector<int> keys(static_cast<std::size_t>(state.range(0)));
+    std::iota(keys.begin(), keys.end(), 0);
+
+    if (state.range(1) != 0)
+    {
+        std::ranges::shuffle(keys, std::mt19937{ 42 });
+    }
+
+    return keys;
+}
+
+// builds a whole tree, so the time per item includes freeing it again
+template <typename Tree>
+static void BM_tree_insert(benchmark::State& state)
+{
+    const auto keys = tree_keys(state);
+
+    for (auto _ : state)
+    {
+        Tree tree;
+        for (const auto key : keys)
+        {
+            tree.insert(key);
+        }
+        benchmark::DoNotOptimize(tree);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// the same, with the range constructor building the tree in one go
+template <typename Tree>
+static void BM_tree_build(benchmark::State& state)
+{
+    const auto keys = tree_keys(state);
+
+    for (auto _ : state)
+    {
+        Tree tree(keys);
+        benchmark::DoNotOptimize(tree);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// an in-order walk of a tree built from the keys
+template <typename Tree>
+static void BM_tree_traverse(benchmark::State& state)
+{
+    Tree tree;
+    for (const auto key : tree_keys(state))
+    {
+        tree.insert(key);
+    }
+
+    for (auto _ : state)
+    {
+        long long sum{ 0 };
+        for (const auto value : tree)
+        {
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// a pre-order (range(2) == 0) or post-order walk of a red-black tree built
+// from the keys
+static void BM_tree_traverse_other_orders(benchmark::State& state)
+{
+    caff::binary_tree<int, caff::red_black_balancing> tree;
+    for (const auto key : tree_keys(state))
+    {
+        tree.insert(key);
+    }
+
+    const auto walk = [&tree](auto range)
+    {
+        long long sum{ 0 };
+        for (const auto value : range)
+        {
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    };
+
+    for (auto _ : state)
+    {
+        if (state.range(2) == 0)
+        {
+            walk(tree.pre_order());
+        }
+        else
+        {
+            walk(tree.post_order());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// short scans from a random starting key, where setting up the iterator
+// costs as much as the walk itself
+template <typename Tree>
+static void BM_tree_range_scan(benchmark::State& state)
+{
+    auto keys = tree_keys(state);
+
+    Tree tree;
+    for (const auto key : keys)
+    {
+        tree.insert(key);
+    }
+    std::ranges::shuffle(keys, std::mt19937{ 7 });
+
+    constexpr int scan_length{ 8 };
+    std::size_t next{ 0 };
+
+    for (auto _ : state)
+    {
+        long long sum{ 0 };
+        auto it = tree.lower_bound(keys[next++ % keys.size()]);
+        for (int i = 0; i < scan_length && it != tree.end(); ++i, ++it)
+        {
+            sum += *it;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * scan_length);
+}
+
+// looks up every key in a shuffled order
+template <typename Tree>
+static void BM_tree_find(benchmark::State& state)
+{
+    auto keys = tree_keys(state);
+
+    Tree tree;
+    for (const auto key : keys)
+    {
+        tree.insert(key);
+    }
+    std::ranges::shuffle(keys, std::mt19937{ 7 });
+
+    for (auto _ : state)
+    {
+        std::size_t found{ 0 };
+        for (const auto key : keys)
+        {
+            found += tree.contains(key) ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(found);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+using red_black_tree = caff::binary_tree<int, caff::red_black_balancing>;
+using avl_tree = caff::binary_tree<int, caff::avl_balancing>;
+
+BENCHMARK_TEMPLATE(BM_tree_insert, red_black_tree)->ArgsProduct({ { 1 << 10, 1 << 16 }, { 0, 1 } });
+BENCHMARK_TEMPLATE(BM_tree_insert, avl_tree)->ArgsProduct({ { 1 << 10, 1 << 16 }, { 0, 1 } });
+BENCHMARK_TEMPLATE(BM_tree_insert, std::set<int>)->ArgsProduct({ { 1 << 10, 1 << 16 }, { 0, 1 } });
+// sorted input makes the unbalanced tree quadratic, so it only gets a small one
+BENCHMARK_TEMPLATE(BM_tree_insert, caff::binary_tree<int>)->ArgsProduct({ { 1 << 10 }, { 0, 1 } });
+BENCHMARK_TEMPLATE(BM_tree_build, red_black_tree)->ArgsProduct({ { 1 << 10, 1 << 16, 1 << 20 }, { 0, 1 } });
+BENCHMARK_TEMPLATE(BM_tree_build, caff::binary_tree<int>)->ArgsProduct({ { 1 << 10, 1 << 16, 1 << 20 }, { 0, 1 } });
+BENCHMARK_TEMPLATE(BM_tree_traverse, red_black_tree)->ArgsProduct({ { 1 << 16 }, { 0, 1 } });
+BENCHMARK_TEMPLATE(BM_tree_traverse, avl_tree)->ArgsProduct({ { 1 << 16 }, { 0, 1 } });
+BENCHMARK_TEMPLATE(BM_tree_traverse, std::set<int>)->ArgsProduct({ { 1 << 16 }, { 0, 1 } });
+BENCHMARK_TEMPLATE(BM_tree_find, red_black_tree)->ArgsProduct({ { 1 << 16 }, { 0, 1 } });
+BENCHMARK_TEMPLATE(BM_tree_find, avl_tree)->ArgsProduct({ { 1 << 16 }, { 0, 1 } });
+BENCHMARK_TEMPLATE(BM_tree_find, std::set<int>)->ArgsProduct({ { 1 << 16 }, { 0, 1 } });
+BENCHMARK(BM_tree_traverse_other_orders)->ArgsProduct({ { 1 << 16 }, { 1 }, { 0, 1 } });
+BENCHMARK_TEMPLATE(BM_tree_range_scan, red_black_tree)->ArgsProduct({ { 1 << 16 }, { 1 } });
+BENCHMARK_TEMPLATE(BM_tree_range_scan, std::set<int>)->ArgsProduct({ { 1 << 16 }, { 1 } });
@@ -0,0 +1,177 @@
+#include <benchmark/benchmark.h>
+
+import std;
+import data_structures;
+
+// range(0) distinct keys in random order
+static std::vector<int> btree_set_keys(const benchmark::State& state)
+{
+    std::vector<int> keys(static_cast<std::size_t>(state.range(0)));
+    std::iota(keys.begin(), keys.end(), 0);
+    std::ranges::shuffle(keys, std::mt19937{ 42 });
+    return keys;
+}
+
+template <typename Set>
+static void run_set_insert(benchmark::State& state)
+{
+    const auto keys = btree_set_keys(state);
+
+    for (auto _ : state)
+    {
+        Set set;
+        for (const auto key : keys)
+        {
+            set.insert(key);
+        }
+        benchmark::DoNotOptimize(set);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Set>
+static void run_set_find(benchmark::State& state)
+{
+    const auto keys = btree_set_keys(state);
+    Set set;
+    for (const auto key : keys)
+    {
+        set.insert(key);
+    }
+
+    // the same keys, looked up in another random order
+    auto queries = keys;
+    std::ranges::shuffle(queries, std::mt19937{ 7 });
+
+    std::size_t next{ 0 };
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(set.find(queries[next]));
+        next = (next + 1 == queries.size()) ? 0 : next + 1;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Set>
+static void run_set_scan(benchmark::State& state)
+{
+    Set set;
+    for (const auto key : btree_set_keys(state))
+    {
+        set.insert(key);
+    }
+
+    for (auto _ : state)
+    {
+        long long sum{ 0 };
+        for (const auto value : set)
+        {
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Set>
+static void run_set_erase(benchmark::State& state)
+{
+    const auto keys = btree_set_keys(state);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        Set set;
+        for (const auto key : keys)
+        {
+            set.insert(key);
+        }
+        state.ResumeTiming();
+
+        for (const auto key : keys)
+        {
+            set.erase(key);
+        }
+        benchmark::DoNotOptimize(set);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+using red_black_tree = caff::binary_tree<int, caff::red_black_balancing>;
+
+static void BM_set_insert_btree_set(benchmark::State& state)
+{
+    run_set_insert<caff::btree_set<int>>(state);
+}
+
+static void BM_set_insert_red_black_tree(benchmark::State& state)
+{
+    run_set_insert<red_black_tree>(state);
+}
+
+static void BM_set_insert_std_set(benchmark::State& state)
+{
+    run_set_insert<std::set<int>>(state);
+}
+
+static void BM_set_find_btree_set(benchmark::State& state)
+{
+    run_set_find<caff::btree_set<int>>(state);
+}
+
+static void BM_set_find_red_black_tree(benchmark::State& state)
+{
+    run_set_find<red_black_tree>(state);
+}
+
+static void BM_set_find_std_set(benchmark::State& state)
+{
+    run_set_find<std::set<int>>(state);
+}
+
+static void BM_set_scan_btree_set(benchmark::State& state)
+{
+    run_set_scan<caff::btree_set<int>>(state);
+}
+
+static void BM_set_scan_red_black_tree(benchmark::State& state)
+{
+    run_set_scan<red_black_tree>(state);
+}
+
+static void BM_set_scan_std_set(benchmark::State& state)
+{
+    run_set_scan<std::set<int>>(state);
+}
+
+static void BM_set_erase_btree_set(benchmark::State& state)
+{
+    run_set_erase<caff::btree_set<int>>(state);
+}
+
+static void BM_set_erase_red_black_tree(benchmark::State& state)
+{
+    run_set_erase<red_black_tree>(state);
+}
+
+static void BM_set_erase_std_set(benchmark::State& state)
+{
+    run_set_erase<std::set<int>>(state);
+}
+
+BENCHMARK(BM_set_insert_btree_set)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_set_insert_red_black_tree)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_set_insert_std_set)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_set_find_btree_set)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_set_find_red_black_tree)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_set_find_std_set)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_set_scan_btree_set)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_set_scan_red_black_tree)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_set_scan_std_set)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_set_erase_btree_set)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_set_erase_red_black_tree)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_set_erase_std_set)->Arg(1 << 10)->Arg(1 << 20);
@@ -0,0 +1,55 @@
+#include <benchmark/benchmark.h>
+
+import std;
+import data_structures;
+
+namespace
+{
+    // the baseline: a linked_list used as a stack behind a single mutex
+    class mutex_linked_list
+    {
+    public:
+        void push(int value)
+        {
+            std::scoped_lock lock{ mutex_ };
+            list_.push_front(value);
+        }
+
+        std::optional<int> pop()
+        {
+            std::scoped_lock lock{ mutex_ };
+            if (list_.empty())
+            {
+                return std::nullopt;
+            }
+
+            const int value = list_.front();
+            list_.pop_front();
+            return value;
+        }
+
+    private:
+        std::mutex mutex_;
+        caff::linked_list<int> list_;
+    };
+}
+
+// every thread pushes and then pops one element per iteration against a
+// single shared container
+template <typename Container>
+static void BM_push_pop(benchmark::State& state)
+{
+    static Container container;
+
+    for (auto _ : state)
+    {
+        container.push(state.thread_index());
+        benchmark::DoNotOptimize(container.pop());
+    }
+
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+BENCHMARK_TEMPLATE(BM_push_pop, mutex_linked_list)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_push_pop, caff::lock_free_stack<int>)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_push_pop, caff::lock_free_queue<int>)->ThreadRange(1, 16)->UseRealTime();
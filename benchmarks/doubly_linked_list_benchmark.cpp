@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+
+import std;
+import data_structures;
+
+// a queue workload: the list stays at a steady size while elements go in at
+// the back and come out of the front
+template <typename List>
+static void BM_push_back_pop_front(benchmark::State& state)
+{
+    List list;
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+    {
+        list.push_back(static_cast<int>(i));
+    }
+
+    for (auto _ : state)
+    {
+        list.push_back(1);
+        benchmark::DoNotOptimize(list.front());
+        list.pop_front();
+    }
+
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+// inserts and erases in front of an iterator held in the middle of the list
+template <typename List>
+static void BM_insert_erase_middle(benchmark::State& state)
+{
+    List list;
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+    {
+        list.push_back(static_cast<int>(i));
+    }
+
+    const auto middle = std::next(list.begin(), state.range(0) / 2);
+
+    for (auto _ : state)
+    {
+        auto pos = list.insert(middle, 1);
+        benchmark::DoNotOptimize(*pos);
+        list.erase(pos);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+// walks a list whose nodes were scattered by sorting on a random key, either
+// as is (range(1) == 0) or after relayout() has put them back in order
+static void BM_traverse_scattered(benchmark::State& state)
+{
+    const auto size = static_cast<int>(state.range(0));
+
+    std::vector<int> keys(static_cast<std::size_t>(size));
+    std::iota(keys.begin(), keys.end(), 0);
+    std::ranges::shuffle(keys, std::mt19937{ 42 });
+
+    caff::doubly_linked_list<int> list;
+    for (int i = 0; i < size; ++i)
+    {
+        list.push_back(i);
+    }
+    list.sort([&keys](int lhs, int rhs) { return keys[lhs] < keys[rhs]; });
+
+    if (state.range(1) != 0)
+    {
+        list.relayout();
+    }
+    state.counters["locality"] = list.locality();
+
+    for (auto _ : state)
+    {
+        long long sum{ 0 };
+        for (const auto value : list)
+        {
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+BENCHMARK_TEMPLATE(BM_push_back_pop_front, caff::doubly_linked_list<int>)->Arg(16)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_push_back_pop_front, std::list<int>)->Arg(16)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_insert_erase_middle, caff::doubly_linked_list<int>)->Arg(16)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_insert_erase_middle, std::list<int>)->Arg(16)->Arg(4096);
+BENCHMARK(BM_traverse_scattered)->ArgsProduct({ { 1 << 12, 1 << 20 }, { 0, 1 } });
@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+
+import std;
+import data_structures;
+
+// the even numbers below 2 * range(0), so that half of the random queries
+// miss
+static std::vector<int> frozen_tree_keys(const benchmark::State& state)
+{
+    std::vector<int> keys(static_cast<std::size_t>(state.range(0)));
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+        keys[i] = static_cast<int>(2 * i);
+    }
+    return keys;
+}
+
+static std::vector<int> frozen_tree_queries(const benchmark::State& state)
+{
+    std::vector<int> queries(1 << 16);
+    // no query is past the last key, so every lower_bound finds one
+    std::uniform_int_distribution<int> distribution{ 0, static_cast<int>(2 * (state.range(0) - 1)) };
+    std::ranges::generate(queries, [&distribution, engine = std::mt19937{ 42 }]() mutable
+    {
+        return distribution(engine);
+    });
+    return queries;
+}
+
+// random lower_bound queries, each starting from the root
+template <typename Lookup>
+static void run_lower_bounds(benchmark::State& state, const std::vector<int>& queries, Lookup lookup)
+{
+    std::size_t next{ 0 };
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(lookup(queries[next++ & (queries.size() - 1)]));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_lower_bound_frozen_tree(benchmark::State& state)
+{
+    const caff::frozen_tree<int> tree(frozen_tree_keys(state));
+    run_lower_bounds(state, frozen_tree_queries(state), [&tree](int key)
+    {
+        return *tree.lower_bound(key);
+    });
+}
+
+static void BM_lower_bound_binary_tree(benchmark::State& state)
+{
+    caff::binary_tree<int, caff::red_black_balancing> tree;
+    for (const auto key : frozen_tree_keys(state))
+    {
+        tree.insert(key);
+    }
+
+    run_lower_bounds(state, frozen_tree_queries(state), [&tree](int key)
+    {
+        return *tree.lower_bound(key);
+    });
+}
+
+static void BM_lower_bound_sorted_vector(benchmark::State& state)
+{
+    const auto keys = frozen_tree_keys(state);
+    run_lower_bounds(state, frozen_tree_queries(state), [&keys](int key)
+    {
+        return *std::ranges::lower_bound(keys, key);
+    });
+}
+
+BENCHMARK(BM_lower_bound_frozen_tree)->Arg(1 << 10)->Arg(1 << 20)->Arg(1 << 24);
+BENCHMARK(BM_lower_bound_binary_tree)->Arg(1 << 10)->Arg(1 << 20)->Arg(1 << 24);
+BENCHMARK(BM_lower_bound_sorted_vector)->Arg(1 << 10)->Arg(1 << 20)->Arg(1 << 24);
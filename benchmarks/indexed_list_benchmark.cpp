@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+
+import std;
+import data_structures;
+
+namespace
+{
+    template <typename List>
+    List make_list(std::int64_t size)
+    {
+        List list;
+        for (std::int64_t i = 0; i < size; ++i)
+        {
+            list.push_back(static_cast<int>(i));
+        }
+        return list;
+    }
+}
+
+static void BM_nth_linear(benchmark::State& state)
+{
+    auto list = make_list<caff::doubly_linked_list<int>>(state.range(0));
+    std::mt19937 gen{ 42 };
+
+    for (auto _ : state)
+    {
+        const auto index = static_cast<std::ptrdiff_t>(gen() % list.size());
+        benchmark::DoNotOptimize(*std::next(list.begin(), index));
+    }
+}
+
+static void BM_nth_indexed(benchmark::State& state)
+{
+    auto list = make_list<caff::indexed_list<int>>(state.range(0));
+    std::mt19937 gen{ 42 };
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(list[gen() % list.size()]);
+    }
+}
+
+static void BM_index_of_linear(benchmark::State& state)
+{
+    auto list = make_list<caff::doubly_linked_list<int>>(state.range(0));
+    const auto pos = std::next(list.begin(), state.range(0) * 3 / 4);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(std::distance(list.begin(), pos));
+    }
+}
+
+static void BM_index_of_indexed(benchmark::State& state)
+{
+    auto list = make_list<caff::indexed_list<int>>(state.range(0));
+    const auto pos = list.nth(static_cast<std::size_t>(state.range(0) * 3 / 4));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(list.index_of(pos));
+    }
+}
+
+// inserts at a random position and erases from another one, so the size
+// stays the same
+template <typename List>
+static void BM_insert_erase_at(benchmark::State& state)
+{
+    auto list = make_list<List>(state.range(0));
+    std::mt19937 gen{ 42 };
+
+    const auto at = [&list](std::size_t index)
+    {
+        if constexpr (std::is_same_v<List, caff::indexed_list<int>>)
+        {
+            return list.nth(index);
+        }
+        else
+        {
+            return std::next(list.begin(), static_cast<std::ptrdiff_t>(index));
+        }
+    };
+
+    for (auto _ : state)
+    {
+        list.insert(at(gen() % (list.size() + 1)), 1);
+        list.erase(at(gen() % list.size()));
+    }
+
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+BENCHMARK(BM_nth_linear)->Range(1 << 8, 1 << 16);
+BENCHMARK(BM_nth_indexed)->Range(1 << 8, 1 << 16);
+BENCHMARK(BM_index_of_linear)->Range(1 << 8, 1 << 16);
+BENCHMARK(BM_index_of_indexed)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_insert_erase_at, caff::doubly_linked_list<int>)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_insert_erase_at, caff::indexed_list<int>)->Range(1 << 8, 1 << 16);
@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+
+import std;
+import data_structures;
+
+namespace
+{
+    // a list whose nodes are scattered across memory: the nodes are
+    // allocated in order and then sorted by a random key, so consecutive
+    // elements are rarely adjacent and the hardware prefetcher can't follow
+    caff::linked_list<std::uint64_t> make_scattered_list(std::size_t size)
+    {
+        caff::linked_list<std::uint64_t> list;
+        list.append_range(std::views::iota(std::uint64_t{ 0 }, std::uint64_t{ size }));
+
+        std::vector<std::uint64_t> keys(size);
+        std::iota(keys.begin(), keys.end(), std::uint64_t{ 0 });
+        std::ranges::shuffle(keys, std::mt19937_64{ 42 });
+
+        list.sort([&keys](std::uint64_t lhs, std::uint64_t rhs)
+        {
+            return keys[lhs] < keys[rhs];
+        });
+
+        return list;
+    }
+
+    // enough work per element for the look-ahead misses to hide behind
+    std::uint64_t mix(std::uint64_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            value ^= value >> 33;
+            value *= 0xff51afd7ed558ccdULL;
+        }
+        return value;
+    }
+}
+
+static void BM_traverse(benchmark::State& state)
+{
+    const auto list = make_scattered_list(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        std::uint64_t sum{ 0 };
+        for (const auto value : list)
+        {
+            sum += mix(value);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_traverse_prefetched(benchmark::State& state)
+{
+    const auto list = make_scattered_list(static_cast<std::size_t>(state.range(0)));
+    const auto distance = static_cast<std::size_t>(state.range(1));
+
+    for (auto _ : state)
+    {
+        std::uint64_t sum{ 0 };
+        for (const auto value : list.prefetched(distance))
+        {
+            sum += mix(value);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// 2^14 nodes fit in L2; 2^20 and 2^22 nodes (16 bytes each) don't
+BENCHMARK(BM_traverse)->Arg(1 << 14)->Arg(1 << 20)->Arg(1 << 22);
+BENCHMARK(BM_traverse_prefetched)->ArgsProduct({ { 1 << 14, 1 << 20, 1 << 22 }, { 2, 8, 32 } });
@@ -0,0 +1,101 @@
+#include <benchmark/benchmark.h>
+
+import std;
+import data_structures;
+
+namespace
+{
+    // below this, a subproblem is cheaper to solve than to hand out
+    constexpr int serial_cutoff{ 18 };
+
+    long long serial_fib(int n)
+    {
+        return (n < 2) ? n : serial_fib(n - 1) + serial_fib(n - 2);
+    }
+
+    // fork one half as a task, work on the other, then help with other tasks
+    // until the forked half is done
+    long long parallel_fib(caff::work_stealing_pool& pool, int n)
+    {
+        if (n < serial_cutoff)
+        {
+            return serial_fib(n);
+        }
+
+        long long x{ 0 };
+        std::atomic<bool> done{ false };
+
+        pool.submit([&]
+        {
+            x = parallel_fib(pool, n - 1);
+            done.store(true, std::memory_order_release);
+        });
+
+        const auto y = parallel_fib(pool, n - 2);
+        pool.run_until([&] { return done.load(std::memory_order_acquire); });
+        return x + y;
+    }
+
+    // a task tree of the given depth whose leaves each do a little work
+    void spawn_tree(caff::work_stealing_pool& pool, std::atomic<long long>& sum, int depth)
+    {
+        if (depth == 0)
+        {
+            sum.fetch_add(serial_fib(serial_cutoff), std::memory_order_relaxed);
+            return;
+        }
+
+        pool.submit([&pool, &sum, depth] { spawn_tree(pool, sum, depth - 1); });
+        pool.submit([&pool, &sum, depth] { spawn_tree(pool, sum, depth - 1); });
+    }
+
+    void thread_counts(benchmark::internal::Benchmark* b)
+    {
+        const auto cores = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+        for (int threads = 1; threads < cores; threads *= 2)
+        {
+            b->Arg(threads);
+        }
+        b->Arg(cores);
+    }
+}
+
+static void BM_fib_serial(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(serial_fib(32));
+    }
+}
+
+// fork and join: the calling thread takes part, so state.range(0) workers
+// plus the caller share the work
+static void BM_fib_work_stealing(benchmark::State& state)
+{
+    caff::work_stealing_pool pool{ static_cast<std::size_t>(state.range(0)) };
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(parallel_fib(pool, 32));
+    }
+}
+
+// fire and forget: 2^12 leaf tasks, all spawned from inside the pool
+static void BM_task_tree(benchmark::State& state)
+{
+    caff::work_stealing_pool pool{ static_cast<std::size_t>(state.range(0)) };
+    std::atomic<long long> sum{ 0 };
+
+    for (auto _ : state)
+    {
+        pool.submit([&] { spawn_tree(pool, sum, 12); });
+        pool.wait();
+    }
+
+    benchmark::DoNotOptimize(sum.load());
+    state.SetItemsProcessed(state.iterations() * ((1 << 13) - 1));
+}
+
+BENCHMARK(BM_fib_serial)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_fib_work_stealing)->Apply(thread_counts)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_task_tree)->Apply(thread_counts)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -10,42 +10,65 @@ namespace caff
         T value{};
         binary_tree_node* left{ nullptr };
         binary_tree_node* right{ nullptr };
+        binary_tree_node* parent{ nullptr };
+
+        // bookkeeping for the tree's balancing policy: a red-black colour or
+        // an AVL height
+        std::uint8_t balance{ 0 };
     };
 
+    export template <typename T, typename Balancing, typename Compare>
+    class binary_tree;
+
+    // NOTE: The iterators below follow the nodes' parent links, so they are
+    // a pointer or two, cheap to copy and never allocate.
+
+    // Also walks backwards: the iterator keeps a pointer to its tree's root
+    // link, so that end() can step back to the last element however the
+    // tree has been rebalanced since.
     export template <typename T>
     class in_order_iterator
     {
     public:
-        using iterator_category = std::forward_iterator_tag;
+        using iterator_category = std::bidirectional_iterator_tag;
         using difference_type = std::ptrdiff_t;
         using value_type = T;
         using pointer = const value_type*;
         using reference = const value_type&;
         using node = binary_tree_node<value_type>;
 
-        explicit in_order_iterator(node* n = nullptr)
+        in_order_iterator() = default;
+
+        in_order_iterator(node* current, node* const* root)
+            : current_{ current }, root_{ root }
         {
-            push_leftmost(n);
         }
 
         reference operator*() const
         {
-            return stack_.top()->value;
+            return current_->value;
         }
 
         pointer operator->() const
         {
-            return std::addressof(stack_.top()->value);
+            return std::addressof(current_->value);
         }
 
         in_order_iterator& operator++()
         {
-            node* current = stack_.top();
-            stack_.pop();
-
-            if (current->right != nullptr)
+            if (current_->right != nullptr)
             {
-                push_leftmost(current->right);
+                current_ = leftmost(current_->right);
+            }
+            else
+            {
+                // climb out of every subtree we were the last node of
+                auto* child = current_;
+                current_ = current_->parent;
+                while (current_ != nullptr && current_->right == child)
+                {
+                    child = std::exchange(current_, current_->parent);
+                }
             }
 
             return *this;
@@ -58,21 +81,69 @@ namespace caff
             return tmp;
         }
 
-        bool operator==(const in_order_iterator& rhs) const = default;
+        in_order_iterator& operator--()
+        {
+            if (current_ == nullptr)
+            {
+                current_ = rightmost(*root_);
+            }
+            else if (current_->left != nullptr)
+            {
+                current_ = rightmost(current_->left);
+            }
+            else
+            {
+                auto* child = current_;
+                current_ = current_->parent;
+                while (current_ != nullptr && current_->left == child)
+                {
+                    child = std::exchange(current_, current_->parent);
+                }
+            }
+
+            return *this;
+        }
+
+        in_order_iterator operator--(int)
+        {
+            in_order_iterator tmp = *this;
+            --(*this);
+            return tmp;
+        }
+
+        bool operator==(const in_order_iterator& rhs) const
+        {
+            return current_ == rhs.current_;
+        }
 
     private:
-        void push_leftmost(node* n)
+        template <typename, typename, typename>
+        friend class binary_tree;
+
+        static node* leftmost(node* n)
         {
-            while (n != nullptr)
+            while (n != nullptr && n->left != nullptr)
             {
-                stack_.push(n);
                 n = n->left;
             }
+            return n;
         }
 
-        std::stack<node*> stack_;
+        static node* rightmost(node* n)
+        {
+            while (n != nullptr && n->right != nullptr)
+            {
+                n = n->right;
+            }
+            return n;
+        }
+
+        node* current_{ nullptr };
+        node* const* root_{ nullptr };
     };
 
+    // NOTE: n has to be the root of its tree, as the walk climbs out of it
+    // through the parent links.
     export template <typename T>
     class pre_order_iterator
     {
@@ -84,37 +155,46 @@ namespace caff
         using reference = const value_type&;
         using node = binary_tree_node<value_type>;
 
-        explicit pre_order_iterator(node* n = nullptr)
+        explicit pre_order_iterator(node* n = nullptr) : current_{ n }
         {
-            if (n != nullptr)
-            {
-                stack_.push(n);
-            }
         }
 
         reference operator*() const
         {
-            return stack_.top()->value;
+            return current_->value;
         }
 
         pointer operator->() const
         {
-            return std::addressof(stack_.top()->value);
+            return std::addressof(current_->value);
         }
 
         pre_order_iterator& operator++()
         {
-            node* current = stack_.top();
-            stack_.pop();
-
-            if (current->right != nullptr)
+            if (current_->left != nullptr)
             {
-                stack_.push(current->right);
+                current_ = current_->left;
             }
-
-            if (current->left != nullptr)
+            else if (current_->right != nullptr)
             {
-                stack_.push(current->left);
+                current_ = current_->right;
+            }
+            else
+            {
+                // climb to the nearest ancestor with a right subtree still
+                // to visit
+                auto* child = current_;
+                current_ = current_->parent;
+                while (current_ != nullptr &&
+                    (current_->right == child || current_->right == nullptr))
+                {
+                    child = std::exchange(current_, current_->parent);
+                }
+
+                if (current_ != nullptr)
+                {
+                    current_ = current_->right;
+                }
             }
 
             return *this;
@@ -130,9 +210,11 @@ namespace caff
         bool operator==(const pre_order_iterator& rhs) const = default;
 
     private:
-        std::stack<node*> stack_;
+        node* current_{ nullptr };
     };
 
+    // NOTE: n has to be the root of its tree, as the walk climbs out of it
+    // through the parent links.
     export template <typename T>
     class post_order_iterator
     {
@@ -144,29 +226,31 @@ namespace caff
         using reference = value_type&;
         using node = binary_tree_node<value_type>;
 
-        explicit post_order_iterator(node* n = nullptr)
+        explicit post_order_iterator(node* n = nullptr) : current_{ first_leaf(n) }
         {
-            push_leftmost(n);
         }
 
         reference operator*() const
         {
-            return stack_.top()->value;
+            return current_->value;
         }
 
         pointer operator->() const
         {
-            return std::addressof(stack_.top()->value);
+            return std::addressof(current_->value);
         }
 
         post_order_iterator& operator++()
         {
-            node* current = stack_.top();
-            stack_.pop();
+            auto* parent = current_->parent;
 
-            if (!stack_.empty() && (stack_.top()->left == current))
+            if (parent != nullptr && parent->left == current_ && parent->right != nullptr)
+            {
+                current_ = first_leaf(parent->right);
+            }
+            else
             {
-                push_leftmost(stack_.top()->right);
+                current_ = parent;
             }
 
             return *this;
@@ -182,24 +266,28 @@ namespace caff
         bool operator==(const post_order_iterator& rhs) const = default;
 
     private:
-        void push_leftmost(node* n)
+        // the first node of n's subtree in post-order
+        static node* first_leaf(node* n)
         {
             while (n != nullptr)
             {
-                stack_.push(n);
-
                 if (n->left != nullptr)
                 {
                     n = n->left;
                 }
-                else
+                else if (n->right != nullptr)
                 {
                     n = n->right;
                 }
+                else
+                {
+                    break;
+                }
             }
+            return n;
         }
 
-        std::stack<node*> stack_;
+        node* current_{ nullptr };
     };
 
     export template <typename T>
@@ -262,32 +350,538 @@ namespace caff
         std::queue<node*> queue_;
     };
 
-    static_assert(std::forward_iterator<in_order_iterator<int>>);
+    static_assert(std::bidirectional_iterator<in_order_iterator<int>>);
     static_assert(std::forward_iterator<pre_order_iterator<int>>);
     static_assert(std::forward_iterator<post_order_iterator<int>>);
     static_assert(std::forward_iterator<level_order_iterator<int>>);
 
-    export template<typename T>
+    // Rotations shared by the balancing policies. Each lifts a child of n into
+    // n's place, keeping the parent links and root up to date.
+    template <typename Node>
+    void replace_child(Node*& root, Node* parent, Node* old_child, Node* new_child)
+    {
+        if (parent == nullptr)
+        {
+            root = new_child;
+        }
+        else if (parent->left == old_child)
+        {
+            parent->left = new_child;
+        }
+        else
+        {
+            parent->right = new_child;
+        }
+    }
+
+    template <typename Node>
+    void rotate_left(Node*& root, Node* n)
+    {
+        auto* pivot = n->right;
+
+        n->right = pivot->left;
+        if (pivot->left != nullptr)
+        {
+            pivot->left->parent = n;
+        }
+
+        pivot->parent = n->parent;
+        replace_child(root, n->parent, n, pivot);
+
+        pivot->left = n;
+        n->parent = pivot;
+    }
+
+    template <typename Node>
+    void rotate_right(Node*& root, Node* n)
+    {
+        auto* pivot = n->left;
+
+        n->left = pivot->right;
+        if (pivot->right != nullptr)
+        {
+            pivot->right->parent = n;
+        }
+
+        pivot->parent = n->parent;
+        replace_child(root, n->parent, n, pivot);
+
+        pivot->right = n;
+        n->parent = pivot;
+    }
+
+    // what erasing a node did to the shape of the tree, for the balancing
+    // policy to repair
+    template <typename Node>
+    struct unlinked_node
+    {
+        // the subtree, possibly empty, that moved up into the place the tree
+        // lost a node from, and its new parent
+        Node* child;
+        Node* parent;
+
+        // the balancing bookkeeping of the node that left that place
+        std::uint8_t balance;
+    };
+
+    // takes n out of the tree. A node with two children is replaced by its
+    // in-order successor, which takes over n's balancing bookkeeping, so the
+    // place the tree actually loses is the successor's old one.
+    template <typename Node>
+    unlinked_node<Node> unlink_node(Node*& root, Node* n)
+    {
+        if (n->left == nullptr || n->right == nullptr)
+        {
+            auto* child = (n->left != nullptr) ? n->left : n->right;
+            if (child != nullptr)
+            {
+                child->parent = n->parent;
+            }
+            replace_child(root, n->parent, n, child);
+
+            return { child, n->parent, n->balance };
+        }
+
+        auto* successor = n->right;
+        while (successor->left != nullptr)
+        {
+            successor = successor->left;
+        }
+
+        const unlinked_node<Node> result{ successor->right,
+            (successor->parent == n) ? successor : successor->parent,
+            successor->balance };
+
+        if (successor->parent != n)
+        {
+            successor->parent->left = successor->right;
+            if (successor->right != nullptr)
+            {
+                successor->right->parent = successor->parent;
+            }
+
+            successor->right = n->right;
+            successor->right->parent = successor;
+        }
+
+        successor->left = n->left;
+        successor->left->parent = successor;
+        successor->parent = n->parent;
+        successor->balance = n->balance;
+        replace_child(root, n->parent, n, successor);
+
+        return result;
+    }
+
+    // Leaves the tree shaped by the order of insertion. Sorted input
+    // degenerates into a list with O(n) insertion.
+    export struct no_balancing
+    {
+        template <typename Node>
+        static void rebalance_after_insert(Node*&, Node*)
+        {
+        }
+
+        template <typename Node>
+        static void rebalance_after_erase(Node*&, const unlinked_node<Node>&)
+        {
+        }
+
+        // A bulk-built tree is as short as it can be, with every empty child
+        // on its last two levels. depth counts from the root at 0, height is
+        // that of n's subtree and tree_height that of the whole tree.
+        template <typename Node>
+        static void balance_built_node(Node*, std::size_t, std::size_t, std::size_t)
+        {
+        }
+    };
+
+    // Keeps every path from the root to a leaf at the same number of black
+    // nodes, with no red node having a red child, so the height stays within
+    // 2 log2(n + 1). An insertion or erasure recolours up the tree and then
+    // does at most three rotations.
+    export struct red_black_balancing
+    {
+        static constexpr std::uint8_t black{ 0 };
+        static constexpr std::uint8_t red{ 1 };
+
+        template <typename Node>
+        static void rebalance_after_insert(Node*& root, Node* n)
+        {
+            n->balance = red;
+
+            // n is red; the root is black, so a red parent always has a
+            // parent of its own
+            while (is_red(n->parent))
+            {
+                auto* parent = n->parent;
+                auto* grandparent = parent->parent;
+                auto* uncle = (grandparent->left == parent) ?
+                    grandparent->right : grandparent->left;
+
+                if (is_red(uncle))
+                {
+                    // push the red up to the grandparent and look again there
+                    parent->balance = black;
+                    uncle->balance = black;
+                    grandparent->balance = red;
+                    n = grandparent;
+                    continue;
+                }
+
+                if (grandparent->left == parent)
+                {
+                    if (parent->right == n)
+                    {
+                        rotate_left(root, parent);
+                        parent = n;
+                    }
+                    rotate_right(root, grandparent);
+                }
+                else
+                {
+                    if (parent->left == n)
+                    {
+                        rotate_right(root, parent);
+                        parent = n;
+                    }
+                    rotate_left(root, grandparent);
+                }
+
+                parent->balance = black;
+                grandparent->balance = red;
+                break;
+            }
+
+            root->balance = black;
+        }
+
+        // every path from the root down to an empty child on the last level
+        // or the one above passes the same black nodes, those above the last
+        // level, when the last level is red
+        template <typename Node>
+        static void balance_built_node(Node* n, std::size_t depth, std::size_t, std::size_t tree_height)
+        {
+            n->balance = (depth > 0 && depth + 1 == tree_height) ? red : black;
+        }
+
+        template <typename Node>
+        static void rebalance_after_erase(Node*& root, const unlinked_node<Node>& removed)
+        {
+            if (removed.balance == red)
+            {
+                return;
+            }
+
+            // the paths through n are one black node short. n may be empty,
+            // but its sibling cannot be, as its paths have a black node more,
+            // so an empty n is on whichever side of parent has no child.
+            auto* n = removed.child;
+            auto* parent = removed.parent;
+
+            while (n != root && !is_red(n))
+            {
+                if (n == parent->left)
+                {
+                    auto* sibling = parent->right;
+                    if (is_red(sibling))
+                    {
+                        sibling->balance = black;
+                        parent->balance = red;
+                        rotate_left(root, parent);
+                        sibling = parent->right;
+                    }
+
+                    if (!is_red(sibling->left) && !is_red(sibling->right))
+                    {
+                        // shorten the sibling's side too and move the
+                        // problem up a level
+                        sibling->balance = red;
+                        n = parent;
+                        parent = n->parent;
+                        continue;
+                    }
+
+                    if (!is_red(sibling->right))
+                    {
+                        sibling->left->balance = black;
+                        sibling->balance = red;
+                        rotate_right(root, sibling);
+                        sibling = parent->right;
+                    }
+
+                    sibling->balance = parent->balance;
+                    parent->balance = black;
+                    sibling->right->balance = black;
+                    rotate_left(root, parent);
+                }
+                else
+                {
+                    auto* sibling = parent->left;
+                    if (is_red(sibling))
+                    {
+                        sibling->balance = black;
+                        parent->balance = red;
+                        rotate_right(root, parent);
+                        sibling = parent->left;
+                    }
+
+                    if (!is_red(sibling->left) && !is_red(sibling->right))
+                    {
+                        sibling->balance = red;
+                        n = parent;
+                        parent = n->parent;
+                        continue;
+                    }
+
+                    if (!is_red(sibling->left))
+                    {
+                        sibling->right->balance = black;
+                        sibling->balance = red;
+                        rotate_left(root, sibling);
+                        sibling = parent->left;
+                    }
+
+                    sibling->balance = parent->balance;
+                    parent->balance = black;
+                    sibling->left->balance = black;
+                    rotate_right(root, parent);
+                }
+
+                n = root;
+            }
+
+            if (n != nullptr)
+            {
+                n->balance = black;
+            }
+        }
+
+    private:
+        template <typename Node>
+        static bool is_red(const Node* n)
+        {
+            return n != nullptr && n->balance == red;
+        }
+    };
+
+    // Keeps the heights of every node's two subtrees within one of each
+    // other, so the height stays within 1.44 log2(n + 2): a little lower than
+    // red-black, for a few more rotations. balance holds the height of the
+    // node's subtree.
+    export struct avl_balancing
+    {
+        template <typename Node>
+        static void rebalance_after_insert(Node*& root, Node* n)
+        {
+            n->balance = 1;
+            retrace(root, n->parent);
+        }
+
+        template <typename Node>
+        static void rebalance_after_erase(Node*& root, const unlinked_node<Node>& removed)
+        {
+            retrace(root, removed.parent);
+        }
+
+        template <typename Node>
+        static void balance_built_node(Node* n, std::size_t, std::size_t height, std::size_t)
+        {
+            n->balance = static_cast<std::uint8_t>(height);
+        }
+
+    private:
+        template <typename Node>
+        static int height(const Node* n)
+        {
+            return (n != nullptr) ? n->balance : 0;
+        }
+
+        template <typename Node>
+        static void update_height(Node* n)
+        {
+            n->balance = static_cast<std::uint8_t>(
+                std::max(height(n->left), height(n->right)) + 1);
+        }
+
+        // fixes the heights from n up, rotating wherever a node's subtrees
+        // differ by two. Once a subtree is back at its old height nothing
+        // above it changes.
+        template <typename Node>
+        static void retrace(Node*& root, Node* n)
+        {
+            while (n != nullptr)
+            {
+                const auto old_height = n->balance;
+
+                n = rebalance(root, n);
+                if (n->balance == old_height)
+                {
+                    break;
+                }
+
+                n = n->parent;
+            }
+        }
+
+        // returns the root of n's subtree afterwards
+        template <typename Node>
+        static Node* rebalance(Node*& root, Node* n)
+        {
+            update_height(n);
+            const auto difference = height(n->left) - height(n->right);
+
+            if (difference > 1)
+            {
+                if (height(n->left->left) < height(n->left->right))
+                {
+                    rotate_left(root, n->left);
+                    update_height(n->left->left);
+                    update_height(n->left);
+                }
+
+                rotate_right(root, n);
+                update_height(n);
+                update_height(n->parent);
+                return n->parent;
+            }
+
+            if (difference < -1)
+            {
+                if (height(n->right->right) < height(n->right->left))
+                {
+                    rotate_right(root, n->right);
+                    update_height(n->right->right);
+                    update_height(n->right);
+                }
+
+                rotate_left(root, n);
+                update_height(n);
+                update_height(n->parent);
+                return n->parent;
+            }
+
+            return n;
+        }
+    };
+
+    template <typename Compare>
+    concept transparent_compare = requires { typename Compare::is_transparent; };
+
+    // runs f(0) to f(count - 1) each on its own thread, the last on this
+    // one, and rethrows the first exception any of them threw
+    template <typename F>
+    void run_in_parallel(std::size_t count, F f)
+    {
+        std::vector<std::exception_ptr> errors(count);
+        {
+            std::vector<std::jthread> threads;
+            threads.reserve(count - 1);
+
+            auto run = [&errors, &f](std::size_t i)
+            {
+                try
+                {
+                    f(i);
+                }
+                catch (...)
+                {
+                    errors[i] = std::current_exception();
+                }
+            };
+
+            for (std::size_t i = 0; i + 1 < count; ++i)
+            {
+                threads.emplace_back(run, i);
+            }
+            run(count - 1);
+        }
+
+        for (const auto& error : errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    // Sorts values stably. A large input is cut into a power of two chunks
+    // that are sorted on their own threads, and then merged pairwise, with
+    // the merges of each round also running in parallel.
+    template <typename T, typename Compare>
+    void parallel_stable_sort(std::vector<T>& values, const Compare& compare)
+    {
+        // below this a thread costs more than it saves
+        constexpr std::size_t min_chunk_size{ 1 << 14 };
+
+        const auto threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        const auto chunks = std::bit_floor(std::min(threads, values.size() / min_chunk_size));
+        if (chunks < 2)
+        {
+            std::stable_sort(values.begin(), values.end(), compare);
+            return;
+        }
+
+        const auto chunk_begin = [&values, chunks](std::size_t i)
+        {
+            return values.begin() + static_cast<std::ptrdiff_t>(values.size() * i / chunks);
+        };
+
+        run_in_parallel(chunks, [&](std::size_t i)
+        {
+            std::stable_sort(chunk_begin(i), chunk_begin(i + 1), compare);
+        });
+
+        for (std::size_t width = 1; width < chunks; width *= 2)
+        {
+            run_in_parallel(chunks / (2 * width), [&](std::size_t i)
+            {
+                const auto first = 2 * width * i;
+                std::inplace_merge(chunk_begin(first), chunk_begin(first + width),
+                    chunk_begin(first + 2 * width), compare);
+            });
+        }
+    }
+
+    // NOTE: Balancing is no_balancing, red_black_balancing or avl_balancing.
+    // The default keeps the shape given by the order of insertion.
+    //
+    // NOTE: Equal values are all kept, in the order they were inserted. With
+    // a transparent Compare, such as std::less<>, the lookups and erase(key)
+    // take any type the comparator accepts, so a tree of std::string can be
+    // searched with a std::string_view without making a string.
+    export template <typename T, typename Balancing = no_balancing, typename Compare = std::less<T>>
     class binary_tree
     {
     public:
+        using key_type = T;
         using value_type = T;
         using size_type = std::size_t;
         using difference_type = std::ptrdiff_t;
+        using key_compare = Compare;
+        using value_compare = Compare;
         using referernce = value_type&;
         using const_reference = const value_type&;
         using pointer = value_type*;
         using const_pointer = const value_type*;
         using iterator = in_order_iterator<value_type>;
         //using const_iterator = in_order_iterator<binary_tree_node<value_type>>;
-        //using reverse_iterator = std::reverse_iterator<iterator>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
         //using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
         using node = binary_tree_node<value_type>;
 
         binary_tree() = default;
 
-        binary_tree(std::initializer_list<T> values)
+        explicit binary_tree(const Compare& compare) : compare_{ compare }
+        {
+        }
+
+        // inserts the values one by one, so an unbalanced tree takes the
+        // shape of their order
+        binary_tree(std::initializer_list<T> values, const Compare& compare = Compare{})
+            : compare_{ compare }
         {
             for (const T& value : values)
             {
@@ -295,7 +889,24 @@ namespace caff
             }
         }
 
-        binary_tree(const binary_tree& other) : size_{ other.size_ }
+        // Builds a perfectly balanced tree in O(n), whatever the balancing
+        // policy, with the nodes in one block in sorted order. Values that
+        // are not already sorted, by this tree's comparator, are collected
+        // and sorted first, in parallel when there are many; equal values
+        // keep their order.
+        //
+        // NOTE: The sort calls the comparator from several threads at once.
+        template <std::ranges::input_range R>
+        requires (!std::same_as<std::remove_cvref_t<R>, binary_tree>) &&
+            std::convertible_to<std::ranges::range_reference_t<R>, T>
+        explicit binary_tree(R&& values, const Compare& compare = Compare{})
+            : compare_{ compare }
+        {
+            build(std::forward<R>(values));
+        }
+
+        binary_tree(const binary_tree& other)
+            : compare_{ other.compare_ }, size_{ other.size_ }
         {
             if (other.root_ != nullptr)
             {
@@ -312,17 +923,12 @@ namespace caff
         {
             if (this != std::addressof(other))
             {
-                clear_nodes(root_);
+                // copy first, so a throwing copy leaves this tree as it was
+                auto* copy = (other.root_ != nullptr) ? copy_nodes(other.root_) : nullptr;
+                clear();
+                root_ = copy;
                 size_ = other.size_;
-
-                if (other.root_ != nullptr)
-                {
-                    root_ = copy_nodes(other.root_);
-                }
-                else
-                {
-                    root_ = nullptr;
-                }
+                compare_ = other.compare_;
             }
 
             return *this;
@@ -339,22 +945,32 @@ namespace caff
 
         auto begin()
         {
-            return iterator{ root_ };
+            return make_iterator(iterator::leftmost(root_));
         }
 
         auto begin() const
         {
-            return iterator{ root_ };
+            return make_iterator(iterator::leftmost(root_));
         }
 
         auto end()
         {
-            return iterator{ };
+            return make_iterator(nullptr);
         }
 
         auto end() const
         {
-            return iterator{ };
+            return make_iterator(nullptr);
+        }
+
+        auto rbegin() const
+        {
+            return reverse_iterator{ end() };
+        }
+
+        auto rend() const
+        {
+            return reverse_iterator{ begin() };
         }
 
         bool empty() const
@@ -375,27 +991,158 @@ namespace caff
         void clear()
         {
             clear_nodes(root_);
+            if (block_ != nullptr)
+            {
+                std::allocator<node>{}.deallocate(block_, block_size_);
+            }
+
             root_ = nullptr;
+            block_ = nullptr;
+            block_size_ = 0;
             size_ = 0;
         }
 
+        // replaces the elements with values, built as the range constructor
+        // builds them. Throwing leaves the tree as it was.
+        template <std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+        void assign_range(R&& values)
+        {
+            binary_tree built{ compare_ };
+            built.build(std::forward<R>(values));
+
+            clear();
+            root_ = std::exchange(built.root_, nullptr);
+            block_ = std::exchange(built.block_, nullptr);
+            block_size_ = std::exchange(built.block_size_, 0);
+            size_ = std::exchange(built.size_, 0);
+        }
+
+        key_compare key_comp() const
+        {
+            return compare_;
+        }
+
+        value_compare value_comp() const
+        {
+            return compare_;
+        }
+
         void insert(const T& value)
         {
-            if (root_ == nullptr)
+            node* parent{ nullptr };
+            bool left{ false };
+            for (auto* current = root_; current != nullptr;
+                current = left ? current->left : current->right)
+            {
+                parent = current;
+                left = compare_(value, current->value);
+            }
+
+            auto* new_node = new node{ value, nullptr, nullptr, parent };
+            if (parent == nullptr)
+            {
+                root_ = new_node;
+            }
+            else if (left)
             {
-                root_ = new node{ value };
+                parent->left = new_node;
             }
             else
             {
-                insert_node(root_, value);
+                parent->right = new_node;
             }
             ++size_;
+
+            Balancing::rebalance_after_insert(root_, new_node);
+        }
+
+        // returns the element after the erased one
+        iterator erase(iterator pos)
+        {
+            return make_iterator(erase_node(pos.current_));
+        }
+
+        // erases every element equivalent to key and returns how many there
+        // were
+        size_type erase(const T& key)
+        {
+            return erase_key(key);
+        }
+
+        template <typename K>
+        requires transparent_compare<Compare> && (!std::is_convertible_v<const K&, iterator>)
+        size_type erase(const K& key)
+        {
+            return erase_key(key);
+        }
+
+        // the first element equivalent to key, or end()
+        iterator find(const T& key) const
+        {
+            return make_iterator(find_node(key));
+        }
+
+        template <typename K>
+        requires transparent_compare<Compare>
+        iterator find(const K& key) const
+        {
+            return make_iterator(find_node(key));
+        }
+
+        bool contains(const T& key) const
+        {
+            return find_node(key) != nullptr;
+        }
+
+        template <typename K>
+        requires transparent_compare<Compare>
+        bool contains(const K& key) const
+        {
+            return find_node(key) != nullptr;
+        }
+
+        // the first element not ordered before key
+        iterator lower_bound(const T& key) const
+        {
+            return make_iterator(lower_bound_node(key));
+        }
+
+        template <typename K>
+        requires transparent_compare<Compare>
+        iterator lower_bound(const K& key) const
+        {
+            return make_iterator(lower_bound_node(key));
+        }
+
+        // the first element ordered after key
+        iterator upper_bound(const T& key) const
+        {
+            return make_iterator(upper_bound_node(key));
+        }
+
+        template <typename K>
+        requires transparent_compare<Compare>
+        iterator upper_bound(const K& key) const
+        {
+            return make_iterator(upper_bound_node(key));
+        }
+
+        std::pair<iterator, iterator> equal_range(const T& key) const
+        {
+            return { lower_bound(key), upper_bound(key) };
+        }
+
+        template <typename K>
+        requires transparent_compare<Compare>
+        std::pair<iterator, iterator> equal_range(const K& key) const
+        {
+            return { lower_bound(key), upper_bound(key) };
         }
 
         auto in_order() const
         {
-            return std::ranges::subrange(in_order_iterator<T>{ root_ },
-                in_order_iterator<T>{});
+            return std::ranges::subrange(begin(), end());
         }
 
         auto pre_order() const
@@ -417,88 +1164,347 @@ namespace caff
         }
 
     private:
-        static bool compare_trees(node* lhs, node* rhs)
+        // NOTE: The helpers below walk the tree iteratively, because an
+        // unbalanced tree can be as deep as it is large.
+
+        iterator make_iterator(node* n) const
+        {
+            return iterator{ n, std::addressof(root_) };
+        }
+
+        template <typename K>
+        node* lower_bound_node(const K& key) const
         {
-            if (lhs == nullptr && rhs == nullptr)
+            node* result{ nullptr };
+            for (auto* current = root_; current != nullptr;)
             {
-                return true;
+                if (compare_(current->value, key))
+                {
+                    current = current->right;
+                }
+                else
+                {
+                    result = current;
+                    current = current->left;
+                }
             }
+            return result;
+        }
 
-            if (lhs == nullptr || rhs == nullptr)
+        template <typename K>
+        node* upper_bound_node(const K& key) const
+        {
+            node* result{ nullptr };
+            for (auto* current = root_; current != nullptr;)
             {
-                return false;
+                if (compare_(key, current->value))
+                {
+                    result = current;
+                    current = current->left;
+                }
+                else
+                {
+                    current = current->right;
+                }
             }
+            return result;
+        }
 
-            if (lhs->value != rhs->value)
+        template <typename K>
+        node* find_node(const K& key) const
+        {
+            auto* n = lower_bound_node(key);
+            return (n != nullptr && !compare_(key, n->value)) ? n : nullptr;
+        }
+
+        template <typename K>
+        size_type erase_key(const K& key)
+        {
+            size_type count{ 0 };
+            for (auto* n = lower_bound_node(key); n != nullptr && !compare_(key, n->value); ++count)
             {
-                return false;
+                n = erase_node(n);
             }
+            return count;
+        }
 
-            return compare_trees(lhs->left, rhs->left) &&
-                compare_trees(lhs->right, rhs->right);
+        // returns the node after n. The other nodes stay where they are in
+        // memory, only relinked.
+        node* erase_node(node* n)
+        {
+            auto* next = std::next(make_iterator(n)).current_;
+            Balancing::rebalance_after_erase(root_, unlink_node(root_, n));
+            free_node(n);
+            --size_;
+            return next;
         }
 
-        static void insert_node(node* current, const T& value)
+        static bool compare_trees(const node* lhs, const node* rhs)
         {
-            if (value < current->value)
+            std::vector<std::pair<const node*, const node*>> pending{ { lhs, rhs } };
+
+            while (!pending.empty())
             {
-                if (current->left == nullptr)
+                const auto [l, r] = pending.back();
+                pending.pop_back();
+
+                if (l == nullptr || r == nullptr)
                 {
-                    current->left = new node{ value };
+                    if (l != r)
+                    {
+                        return false;
+                    }
+                    continue;
                 }
-                else
+
+                if (l->value != r->value)
                 {
-                    insert_node(current->left, value);
+                    return false;
                 }
+
+                pending.emplace_back(l->right, r->right);
+                pending.emplace_back(l->left, r->left);
             }
-            else
+
+            return true;
+        }
+
+        template <typename R>
+        void build(R&& values)
+        {
+            if constexpr (std::ranges::forward_range<R>)
             {
-                if (current->right == nullptr)
+                // sorted values can be read straight off the range
+                if (std::ranges::is_sorted(values, compare_))
                 {
-                    current->right = new node{ value };
+                    build_sorted(std::ranges::begin(values),
+                        static_cast<size_type>(std::ranges::distance(values)));
+                    return;
                 }
-                else
+            }
+
+            std::vector<T> sorted;
+            if constexpr (std::ranges::sized_range<R>)
+            {
+                sorted.reserve(std::ranges::size(values));
+            }
+
+            for (auto&& value : values)
+            {
+                sorted.push_back(std::forward<decltype(value)>(value));
+            }
+
+            if (!std::ranges::is_sorted(sorted, compare_))
+            {
+                parallel_stable_sort(sorted, compare_);
+            }
+
+            build_sorted(std::make_move_iterator(sorted.begin()), sorted.size());
+        }
+
+        // fills an empty tree with count sorted values read from first
+        template <std::input_iterator I>
+        void build_sorted(I first, size_type count)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+
+            std::allocator<node> allocator;
+            auto* nodes = allocator.allocate(count);
+
+            size_type built{ 0 };
+            try
+            {
+                for (; built < count; ++built, ++first)
                 {
-                    insert_node(current->right, value);
+                    std::construct_at(nodes + built, *first);
                 }
             }
+            catch (...)
+            {
+                std::destroy_n(nodes, built);
+                allocator.deallocate(nodes, count);
+                throw;
+            }
+
+            root_ = link_balanced(nodes, count, nullptr, 0, std::bit_width(count));
+            block_ = nodes;
+            block_size_ = count;
+            size_ = count;
         }
 
-        static node* copy_nodes(node* current)
+        // Links the count nodes in sorted order at nodes into a subtree with
+        // the middle one at the top, and returns it. Halving the count at
+        // every level keeps the recursion O(log n) deep, and left subtrees
+        // are never smaller than right ones, so every subtree is as short as
+        // it can be.
+        static node* link_balanced(node* nodes, size_type count, node* parent,
+            size_type depth, size_type tree_height)
         {
-            if (current == nullptr)
+            if (count == 0)
             {
                 return nullptr;
             }
 
-            node* new_node = new node{ current->value };
-            new_node->left = copy_nodes(current->left);
-            new_node->right = copy_nodes(current->right);
-            return new_node;
+            const auto middle = count / 2;
+            auto* n = nodes + middle;
+            n->parent = parent;
+            n->left = link_balanced(nodes, middle, n, depth + 1, tree_height);
+            n->right = link_balanced(n + 1, count - middle - 1, n, depth + 1, tree_height);
+
+            Balancing::balance_built_node(n, depth, std::bit_width(count), tree_height);
+            return n;
         }
 
-        static void clear_nodes(node* current)
+        // a node from the block of a bulk build only has its value destroyed;
+        // the block goes when the tree is cleared
+        void free_node(node* n)
         {
-            if (current != nullptr)
+            const std::less<const node*> before;
+            if (!before(n, block_) && before(n, block_ + block_size_))
+            {
+                std::destroy_at(n);
+            }
+            else
             {
-                clear_nodes(current->left);
-                clear_nodes(current->right);
-                delete current;
+                delete n;
             }
         }
 
-        static std::size_t calculate_height(node* current)
+        node* copy_nodes(const node* source)
         {
-            if (current == nullptr)
+            struct pending_copy
+            {
+                const node* from;
+                node* parent;
+                node** to;
+            };
+
+            node* copy{ nullptr };
+            std::vector<pending_copy> pending{ { source, nullptr, std::addressof(copy) } };
+
+            try
+            {
+                while (!pending.empty())
+                {
+                    const auto [from, parent, to] = pending.back();
+                    pending.pop_back();
+
+                    if (from != nullptr)
+                    {
+                        *to = new node{ from->value, nullptr, nullptr, parent, from->balance };
+                        pending.push_back({ from->right, *to, std::addressof((*to)->right) });
+                        pending.push_back({ from->left, *to, std::addressof((*to)->left) });
+                    }
+                }
+            }
+            catch (...)
             {
-                return 0;
+                clear_nodes(copy);
+                throw;
             }
-            auto left_height = calculate_height(current->left);
-            auto right_height = calculate_height(current->right);
-            return std::max(left_height, right_height) + 1;
+
+            return copy;
         }
 
+        // rotates left children up until the current node has none, so it
+        // can be freed before moving on to its right: O(n) time and O(1)
+        // space whatever the shape
+        void clear_nodes(node* current)
+        {
+            while (current != nullptr)
+            {
+                if (auto* left = current->left; left != nullptr)
+                {
+                    current->left = left->right;
+                    left->right = current;
+                    current = left;
+                }
+                else
+                {
+                    free_node(std::exchange(current, current->right));
+                }
+            }
+        }
+
+        static std::size_t calculate_height(const node* root)
+        {
+            std::size_t height{ 0 };
+            std::vector<const node*> level;
+            std::vector<const node*> next_level;
+
+            if (root != nullptr)
+            {
+                level.push_back(root);
+            }
+
+            while (!level.empty())
+            {
+                ++height;
+
+                for (const auto* n : level)
+                {
+                    for (const auto* child : { n->left, n->right })
+                    {
+                        if (child != nullptr)
+                        {
+                            next_level.push_back(child);
+                        }
+                    }
+                }
+
+                level.swap(next_level);
+                next_level.clear();
+            }
+
+            return height;
+        }
+
+        [[no_unique_address]] Compare compare_{};
         node* root_{ nullptr };
         std::size_t size_{ 0 };
+
+        // the nodes of the last bulk build, if any
+        node* block_{ nullptr };
+        size_type block_size_{ 0 };
     };
+
+    // the range constructor cannot deduce the value type on its own
+    template <std::ranges::input_range R,
+        typename Compare = std::less<std::ranges::range_value_t<R>>>
+    binary_tree(R&&, Compare = Compare{})
+        -> binary_tree<std::ranges::range_value_t<R>, no_balancing, Compare>;
 }
+
+export template <typename T, typename Balancing, typename Compare>
+struct std::formatter<caff::binary_tree<T, Balancing, Compare>>
+{
+    template <typename ParseContext>
+    constexpr auto parse(ParseContext& ctx)
+    {
+        return ctx.begin();
+    }
+
+    // in order, as the set it holds
+    template <typename FormatContext>
+    auto format(const caff::binary_tree<T, Balancing, Compare>& tree, FormatContext& ctx) const
+    {
+        auto out = ctx.out();
+        out = std::format_to(out, "[");
+
+        if (auto pos = tree.begin(); pos != tree.end())
+        {
+            out = std::format_to(out, "{}", *pos);
+            ++pos;
+
+            for (; pos != tree.end(); ++pos)
+            {
+                out = std::format_to(out, ", {}", *pos);
+            }
+        }
+
+        return std::format_to(out, "]");
+    }
+};
@@ -0,0 +1,978 @@
+export module data_structures:btree_set;
+
+import std;
+import :binary_tree;
+
+namespace caff
+{
+    // the most values that fit in a leaf of about node_bytes, but at least four
+    template <typename T>
+    constexpr std::size_t btree_leaf_capacity(std::size_t node_bytes)
+    {
+        constexpr std::size_t header{ sizeof(std::size_t) + 2 * sizeof(void*) };
+        return std::max<std::size_t>(
+            (node_bytes > header) ? (node_bytes - header) / sizeof(T) : 0, 4);
+    }
+
+    // the most children an inner node of about node_bytes can hold, with one
+    // key fewer than children, but at least four
+    template <typename T>
+    constexpr std::size_t btree_fanout(std::size_t node_bytes)
+    {
+        constexpr std::size_t header{ sizeof(std::size_t) };
+        return std::max<std::size_t>(
+            (node_bytes > header) ? (node_bytes - header + sizeof(T)) / (sizeof(T) + sizeof(void*)) : 0, 4);
+    }
+
+    // leaves hold the values, and are linked in order for iteration
+    template <typename T, std::size_t Capacity>
+    struct btree_leaf
+    {
+        std::size_t count{ 0 };
+        btree_leaf* prev{ nullptr };
+        btree_leaf* next{ nullptr };
+        std::array<T, Capacity> values{};
+    };
+
+    // child i holds the values ordered before keys[i], and child i + 1 those
+    // not ordered before it. The children are leaves on the level above the
+    // leaves and inner nodes everywhere else, so they are kept untyped.
+    template <typename T, std::size_t Fanout>
+    struct btree_inner
+    {
+        // of keys; there is one child more
+        std::size_t count{ 0 };
+        std::array<T, Fanout - 1> keys{};
+        std::array<void*, Fanout> children{};
+    };
+
+    // An ordered set of unique values in a B+ tree. Each node is a block of
+    // about NodeBytes holding many sorted values, so a lookup touches one
+    // node per level of a tree a few levels deep, instead of one cache line
+    // per comparison as in a binary_tree, and iteration walks contiguous
+    // arrays along the linked leaves.
+    //
+    // NOTE: The API follows binary_tree's constructors, assign_range(),
+    // lookups, bounds, erase and in_order(), so the two can be swapped.
+    // Unlike binary_tree, equal values are stored once, insert() reports
+    // whether the value was new, and inserting or erasing shifts values
+    // within nodes, which invalidates iterators. There is no pre_order(),
+    // post_order() or level_order(), since the values aren't kept in binary
+    // nodes, and begin() and end() only give const iterators, since changing
+    // an element in place could break the order.
+    //
+    // NOTE: Nodes hold arrays of values, so T has to be default
+    // constructible and copyable.
+    export template <typename T, std::size_t NodeBytes = 256, typename Compare = std::less<T>>
+    requires std::semiregular<T>
+    class btree_set
+    {
+    public:
+        using key_type = T;
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using key_compare = Compare;
+        using value_compare = Compare;
+        using const_reference = const value_type&;
+        using const_pointer = const value_type*;
+
+        static constexpr size_type leaf_capacity{ btree_leaf_capacity<T>(NodeBytes) };
+        static constexpr size_type fanout{ btree_fanout<T>(NodeBytes) };
+
+    private:
+        using leaf = btree_leaf<T, leaf_capacity>;
+        using inner = btree_inner<T, fanout>;
+
+    public:
+        class const_iterator
+        {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = T;
+            using pointer = const value_type*;
+            using reference = const value_type&;
+
+            const_iterator() = default;
+
+            reference operator*() const
+            {
+                return leaf_->values[index_];
+            }
+
+            pointer operator->() const
+            {
+                return std::addressof(leaf_->values[index_]);
+            }
+
+            const_iterator& operator++()
+            {
+                if (++index_ == leaf_->count)
+                {
+                    leaf_ = leaf_->next;
+                    index_ = 0;
+                }
+                return *this;
+            }
+
+            const_iterator operator++(int)
+            {
+                auto tmp = *this;
+                ++(*this);
+                return tmp;
+            }
+
+            const_iterator& operator--()
+            {
+                if (leaf_ == nullptr)
+                {
+                    leaf_ = set_->last_;
+                    index_ = leaf_->count - 1;
+                }
+                else if (index_ == 0)
+                {
+                    leaf_ = leaf_->prev;
+                    index_ = leaf_->count - 1;
+                }
+                else
+                {
+                    --index_;
+                }
+                return *this;
+            }
+
+            const_iterator operator--(int)
+            {
+                auto tmp = *this;
+                --(*this);
+                return tmp;
+            }
+
+            bool operator==(const const_iterator& rhs) const
+            {
+                return leaf_ == rhs.leaf_ && index_ == rhs.index_;
+            }
+
+        private:
+            friend class btree_set;
+
+            const_iterator(const btree_set* set, leaf* l, size_type index)
+                : set_{ set }, leaf_{ l }, index_{ index }
+            {
+            }
+
+            // for stepping back from the end
+            const btree_set* set_{ nullptr };
+
+            // null at the end
+            leaf* leaf_{ nullptr };
+            size_type index_{ 0 };
+        };
+
+        using iterator = const_iterator;
+
+        btree_set() = default;
+
+        explicit btree_set(const Compare& compare) : compare_{ compare }
+        {
+        }
+
+        btree_set(std::initializer_list<T> values, const Compare& compare = Compare{})
+            : compare_{ compare }
+        {
+            for (const T& value : values)
+            {
+                insert(value);
+            }
+        }
+
+        // inserts the values one by one; duplicates are stored once
+        template <std::ranges::input_range R>
+        requires (!std::same_as<std::remove_cvref_t<R>, btree_set>) &&
+            std::convertible_to<std::ranges::range_reference_t<R>, T>
+        explicit btree_set(R&& values, const Compare& compare = Compare{})
+            : compare_{ compare }
+        {
+            for (const T& value : values)
+            {
+                insert(value);
+            }
+        }
+
+        btree_set(const btree_set& other) : compare_{ other.compare_ }
+        {
+            if (other.root_ != nullptr)
+            {
+                leaf* previous{ nullptr };
+                root_ = copy_subtree(other.root_, other.height_, previous);
+                height_ = other.height_;
+                size_ = other.size_;
+            }
+        }
+
+        btree_set(btree_set&& other) noexcept
+            : compare_{ other.compare_ },
+              root_{ std::exchange(other.root_, nullptr) },
+              first_{ std::exchange(other.first_, nullptr) },
+              last_{ std::exchange(other.last_, nullptr) },
+              height_{ std::exchange(other.height_, 0) },
+              size_{ std::exchange(other.size_, 0) }
+        {
+        }
+
+        ~btree_set()
+        {
+            clear();
+        }
+
+        btree_set& operator=(const btree_set& other)
+        {
+            if (this != std::addressof(other))
+            {
+                btree_set copy(other);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        btree_set& operator=(btree_set&& other) noexcept
+        {
+            if (this != std::addressof(other))
+            {
+                clear();
+                swap(other);
+            }
+            return *this;
+        }
+
+        void swap(btree_set& other) noexcept
+        {
+            using std::swap;
+            swap(compare_, other.compare_);
+            swap(root_, other.root_);
+            swap(first_, other.first_);
+            swap(last_, other.last_);
+            swap(height_, other.height_);
+            swap(size_, other.size_);
+        }
+
+        friend bool operator==(const btree_set& lhs, const btree_set& rhs)
+        {
+            return lhs.size_ == rhs.size_ && std::ranges::equal(lhs, rhs);
+        }
+
+        const_iterator begin() const
+        {
+            return { this, first_, 0 };
+        }
+
+        const_iterator end() const
+        {
+            return { this, nullptr, 0 };
+        }
+
+        auto rbegin() const
+        {
+            return std::reverse_iterator{ end() };
+        }
+
+        auto rend() const
+        {
+            return std::reverse_iterator{ begin() };
+        }
+
+        bool empty() const
+        {
+            return size_ == 0;
+        }
+
+        size_type size() const
+        {
+            return size_;
+        }
+
+        // in levels of nodes
+        size_type height() const
+        {
+            return height_;
+        }
+
+        key_compare key_comp() const
+        {
+            return compare_;
+        }
+
+        value_compare value_comp() const
+        {
+            return compare_;
+        }
+
+        void clear()
+        {
+            if (root_ != nullptr)
+            {
+                free_subtree(root_, height_);
+            }
+
+            root_ = nullptr;
+            first_ = nullptr;
+            last_ = nullptr;
+            height_ = 0;
+            size_ = 0;
+        }
+
+        // replaces the elements with values, built as the range constructor
+        // builds them. Throwing leaves the set as it was.
+        template <std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+        void assign_range(R&& values)
+        {
+            btree_set built(std::forward<R>(values), compare_);
+            swap(built);
+        }
+
+        // returns the element equivalent to value and whether it is the one
+        // just inserted
+        std::pair<iterator, bool> insert(const T& value)
+        {
+            if (root_ == nullptr)
+            {
+                auto* l = new leaf{};
+                root_ = first_ = last_ = l;
+                height_ = 1;
+            }
+
+            path_type path;
+            auto* l = descend(value, path);
+            auto pos = value_index(l, value);
+
+            if (pos < l->count && !compare_(value, l->values[pos]))
+            {
+                return { make_iterator(l, pos), false };
+            }
+
+            if (l->count < leaf_capacity)
+            {
+                std::move_backward(l->values.begin() + pos, l->values.begin() + l->count,
+                    l->values.begin() + l->count + 1);
+                l->values[pos] = value;
+                ++l->count;
+                ++size_;
+                return { make_iterator(l, pos), true };
+            }
+
+            return { split_leaf(l, pos, value, path), true };
+        }
+
+        // returns the element after the erased one
+        iterator erase(iterator pos)
+        {
+            const T value{ *pos };
+            erase_key(value);
+            return lower_bound(value);
+        }
+
+        // erases the element equivalent to key, if there is one, and returns
+        // how many were erased
+        size_type erase(const T& key)
+        {
+            return erase_key(key);
+        }
+
+        template <typename K>
+        requires transparent_compare<Compare> && (!std::is_convertible_v<const K&, iterator>)
+        size_type erase(const K& key)
+        {
+            return erase_key(key);
+        }
+
+        // the element equivalent to key, or end()
+        iterator find(const T& key) const
+        {
+            return find_key(key);
+        }
+
+        template <typename K>
+        requires transparent_compare<Compare>
+        iterator find(const K& key) const
+        {
+            return find_key(key);
+        }
+
+        bool contains(const T& key) const
+        {
+            return find_key(key) != end();
+        }
+
+        template <typename K>
+        requires transparent_compare<Compare>
+        bool contains(const K& key) const
+        {
+            return find_key(key) != end();
+        }
+
+        // the first element not ordered before key
+        iterator lower_bound(const T& key) const
+        {
+            return lower_bound_key(key);
+        }
+
+        template <typename K>
+        requires transparent_compare<Compare>
+        iterator lower_bound(const K& key) const
+        {
+            return lower_bound_key(key);
+        }
+
+        // the first element ordered after key
+        iterator upper_bound(const T& key) const
+        {
+            return upper_bound_key(key);
+        }
+
+        template <typename K>
+        requires transparent_compare<Compare>
+        iterator upper_bound(const K& key) const
+        {
+            return upper_bound_key(key);
+        }
+
+        std::pair<iterator, iterator> equal_range(const T& key) const
+        {
+            return { lower_bound(key), upper_bound(key) };
+        }
+
+        template <typename K>
+        requires transparent_compare<Compare>
+        std::pair<iterator, iterator> equal_range(const K& key) const
+        {
+            return { lower_bound(key), upper_bound(key) };
+        }
+
+        auto in_order() const
+        {
+            return std::ranges::subrange(begin(), end());
+        }
+
+    private:
+        // every inner node but the root has at least two children, so no
+        // tree that fits in memory is this tall
+        static constexpr size_type max_height{ 64 };
+
+        // below these a node borrows from or merges with a sibling
+        static constexpr size_type min_leaf_count{ leaf_capacity / 2 };
+        static constexpr size_type min_inner_count{ (fanout + 1) / 2 - 1 };
+
+        // an inner node on the way down to a leaf, and which child was taken
+        struct path_step
+        {
+            inner* node;
+            size_type child;
+        };
+
+        using path_type = std::array<path_step, max_height>;
+
+        iterator make_iterator(leaf* l, size_type index) const
+        {
+            if (index == l->count)
+            {
+                return { this, l->next, 0 };
+            }
+            return { this, l, index };
+        }
+
+        // the child a key is under: past every separator not ordered after it
+        template <typename K>
+        size_type child_index(const inner* n, const K& key) const
+        {
+            return static_cast<size_type>(std::upper_bound(n->keys.begin(),
+                n->keys.begin() + n->count, key, compare_) - n->keys.begin());
+        }
+
+        // the first value in l not ordered before key
+        template <typename K>
+        size_type value_index(const leaf* l, const K& key) const
+        {
+            return static_cast<size_type>(std::lower_bound(l->values.begin(),
+                l->values.begin() + l->count, key, compare_) - l->values.begin());
+        }
+
+        // the leaf where key is or would go
+        template <typename K>
+        leaf* find_leaf(const K& key) const
+        {
+            auto* n = root_;
+            for (size_type level = height_; level > 1; --level)
+            {
+                auto* in = static_cast<inner*>(n);
+                n = in->children[child_index(in, key)];
+            }
+            return static_cast<leaf*>(n);
+        }
+
+        // as find_leaf, recording the inner nodes on the way
+        template <typename K>
+        leaf* descend(const K& key, path_type& path) const
+        {
+            auto* n = root_;
+            for (size_type depth = 0; depth + 1 < height_; ++depth)
+            {
+                auto* in = static_cast<inner*>(n);
+                path[depth] = { in, child_index(in, key) };
+                n = in->children[path[depth].child];
+            }
+            return static_cast<leaf*>(n);
+        }
+
+        template <typename K>
+        iterator lower_bound_key(const K& key) const
+        {
+            if (root_ == nullptr)
+            {
+                return end();
+            }
+
+            auto* l = find_leaf(key);
+            return make_iterator(l, value_index(l, key));
+        }
+
+        template <typename K>
+        iterator upper_bound_key(const K& key) const
+        {
+            if (root_ == nullptr)
+            {
+                return end();
+            }
+
+            auto* l = find_leaf(key);
+            const auto index = std::upper_bound(l->values.begin(),
+                l->values.begin() + l->count, key, compare_) - l->values.begin();
+            return make_iterator(l, static_cast<size_type>(index));
+        }
+
+        template <typename K>
+        iterator find_key(const K& key) const
+        {
+            auto it = lower_bound_key(key);
+            return (it != end() && !compare_(key, *it)) ? it : end();
+        }
+
+        // Splits the full leaf l to make room for value at pos, and hands the
+        // new leaf up to the parent, splitting full ancestors in turn. Every
+        // node this needs is allocated first, so running out of memory leaves
+        // the set as it was.
+        iterator split_leaf(leaf* l, size_type pos, const T& value, path_type& path)
+        {
+            // the full inner nodes right above the leaf split too, and a new
+            // root is needed if they reach the top
+            size_type full_inners{ 0 };
+            while (full_inners + 1 < height_ &&
+                path[height_ - 2 - full_inners].node->count == fanout - 1)
+            {
+                ++full_inners;
+            }
+            const bool new_root{ full_inners + 1 == height_ };
+
+            std::array<inner*, max_height> spare_inners{};
+            auto* right = new leaf{};
+            try
+            {
+                for (size_type i = 0; i < full_inners + (new_root ? 1 : 0); ++i)
+                {
+                    spare_inners[i] = new inner{};
+                }
+            }
+            catch (...)
+            {
+                for (auto* spare : spare_inners)
+                {
+                    delete spare;
+                }
+                delete right;
+                throw;
+            }
+
+            // share the values and the new one out between the two leaves
+            std::array<T, leaf_capacity + 1> all;
+            std::move(l->values.begin(), l->values.begin() + pos, all.begin());
+            all[pos] = value;
+            std::move(l->values.begin() + pos, l->values.end(), all.begin() + pos + 1);
+
+            const auto left_count = (leaf_capacity + 1) / 2;
+            std::move(all.begin(), all.begin() + left_count, l->values.begin());
+            std::move(all.begin() + left_count, all.end(), right->values.begin());
+            l->count = left_count;
+            right->count = leaf_capacity + 1 - left_count;
+
+            right->prev = l;
+            right->next = l->next;
+            if (l->next != nullptr)
+            {
+                l->next->prev = right;
+            }
+            else
+            {
+                last_ = right;
+            }
+            l->next = right;
+            ++size_;
+
+            T separator{ right->values[0] };
+            void* new_child{ right };
+            size_type spare{ 0 };
+
+            for (auto depth = height_ - 1; depth-- > 0;)
+            {
+                auto [n, child] = path[depth];
+
+                if (n->count < fanout - 1)
+                {
+                    insert_child(n, child, std::move(separator), new_child);
+                    return (pos < left_count) ? iterator{ this, l, pos } :
+                        iterator{ this, right, pos - left_count };
+                }
+
+                // share the keys and children out as for the leaves, with the
+                // middle key moving up as the separator between the halves
+                std::array<T, fanout> keys;
+                std::array<void*, fanout + 1> children;
+                std::move(n->keys.begin(), n->keys.begin() + child, keys.begin());
+                keys[child] = std::move(separator);
+                std::move(n->keys.begin() + child, n->keys.end(), keys.begin() + child + 1);
+                std::copy(n->children.begin(), n->children.begin() + child + 1, children.begin());
+                children[child + 1] = new_child;
+                std::copy(n->children.begin() + child + 1, n->children.end(), children.begin() + child + 2);
+
+                auto* sibling = spare_inners[spare++];
+                const auto left_keys = (fanout - 1) / 2;
+
+                std::move(keys.begin(), keys.begin() + left_keys, n->keys.begin());
+                std::copy(children.begin(), children.begin() + left_keys + 1, n->children.begin());
+                n->count = left_keys;
+
+                std::move(keys.begin() + left_keys + 1, keys.end(), sibling->keys.begin());
+                std::copy(children.begin() + left_keys + 1, children.end(), sibling->children.begin());
+                sibling->count = fanout - 1 - left_keys;
+
+                separator = std::move(keys[left_keys]);
+                new_child = sibling;
+            }
+
+            auto* root = spare_inners[spare];
+            root->count = 1;
+            root->keys[0] = std::move(separator);
+            root->children[0] = root_;
+            root->children[1] = new_child;
+            root_ = root;
+            ++height_;
+
+            return (pos < left_count) ? iterator{ this, l, pos } :
+                iterator{ this, right, pos - left_count };
+        }
+
+        // puts key and child after n's child at index
+        static void insert_child(inner* n, size_type index, T key, void* child)
+        {
+            std::move_backward(n->keys.begin() + index, n->keys.begin() + n->count,
+                n->keys.begin() + n->count + 1);
+            std::copy_backward(n->children.begin() + index + 1, n->children.begin() + n->count + 1,
+                n->children.begin() + n->count + 2);
+            n->keys[index] = std::move(key);
+            n->children[index + 1] = child;
+            ++n->count;
+        }
+
+        // takes out n's key at index and the child after it
+        static void remove_child(inner* n, size_type index)
+        {
+            std::move(n->keys.begin() + index + 1, n->keys.begin() + n->count,
+                n->keys.begin() + index);
+            std::copy(n->children.begin() + index + 2, n->children.begin() + n->count + 1,
+                n->children.begin() + index + 1);
+            --n->count;
+        }
+
+        template <typename K>
+        size_type erase_key(const K& key)
+        {
+            if (root_ == nullptr)
+            {
+                return 0;
+            }
+
+            path_type path;
+            auto* l = descend(key, path);
+            const auto pos = value_index(l, key);
+
+            if (pos == l->count || compare_(key, l->values[pos]))
+            {
+                return 0;
+            }
+
+            std::move(l->values.begin() + pos + 1, l->values.begin() + l->count,
+                l->values.begin() + pos);
+            --l->count;
+            --size_;
+
+            if (height_ == 1)
+            {
+                if (l->count == 0)
+                {
+                    delete l;
+                    root_ = first_ = last_ = nullptr;
+                    height_ = 0;
+                }
+                return 1;
+            }
+
+            if (l->count < min_leaf_count && rebalance_leaf(l, path[height_ - 2]))
+            {
+                rebalance_inners(path);
+            }
+
+            return 1;
+        }
+
+        // Refills the leaf l from a sibling, or merges it with one. Returns
+        // whether the parent lost a child. A separator left behind by an
+        // erased value still divides its children correctly, so only
+        // borrowing changes them.
+        bool rebalance_leaf(leaf* l, path_step step)
+        {
+            auto [parent, i] = step;
+            auto* left = (i > 0) ? static_cast<leaf*>(parent->children[i - 1]) : nullptr;
+            auto* right = (i < parent->count) ? static_cast<leaf*>(parent->children[i + 1]) : nullptr;
+
+            if (left != nullptr && left->count > min_leaf_count)
+            {
+                std::move_backward(l->values.begin(), l->values.begin() + l->count,
+                    l->values.begin() + l->count + 1);
+                l->values[0] = std::move(left->values[--left->count]);
+                ++l->count;
+                parent->keys[i - 1] = l->values[0];
+                return false;
+            }
+
+            if (right != nullptr && right->count > min_leaf_count)
+            {
+                l->values[l->count++] = std::move(right->values[0]);
+                std::move(right->values.begin() + 1, right->values.begin() + right->count,
+                    right->values.begin());
+                --right->count;
+                parent->keys[i] = right->values[0];
+                return false;
+            }
+
+            if (left != nullptr)
+            {
+                merge_leaves(left, l);
+                remove_child(parent, i - 1);
+            }
+            else
+            {
+                merge_leaves(l, right);
+                remove_child(parent, i);
+            }
+            return true;
+        }
+
+        // moves the values of b, the leaf after a, into a and frees b
+        void merge_leaves(leaf* a, leaf* b)
+        {
+            std::move(b->values.begin(), b->values.begin() + b->count,
+                a->values.begin() + a->count);
+            a->count += b->count;
+
+            a->next = b->next;
+            if (b->next != nullptr)
+            {
+                b->next->prev = a;
+            }
+            else
+            {
+                last_ = a;
+            }
+            delete b;
+        }
+
+        // fixes the inner nodes on path from the bottom up, after the lowest
+        // lost a child
+        void rebalance_inners(const path_type& path)
+        {
+            for (auto depth = height_ - 2;; --depth)
+            {
+                auto* n = path[depth].node;
+
+                if (depth == 0)
+                {
+                    // a root with a single child hands the root over to it
+                    if (n->count == 0)
+                    {
+                        root_ = n->children[0];
+                        delete n;
+                        --height_;
+                    }
+                    return;
+                }
+
+                if (n->count >= min_inner_count)
+                {
+                    return;
+                }
+
+                auto [parent, i] = path[depth - 1];
+                auto* left = (i > 0) ? static_cast<inner*>(parent->children[i - 1]) : nullptr;
+                auto* right = (i < parent->count) ? static_cast<inner*>(parent->children[i + 1]) : nullptr;
+
+                if (left != nullptr && left->count > min_inner_count)
+                {
+                    // rotate left's last child over through the parent
+                    insert_child(n, 0, std::move(parent->keys[i - 1]), n->children[0]);
+                    n->children[0] = left->children[left->count];
+                    parent->keys[i - 1] = std::move(left->keys[left->count - 1]);
+                    --left->count;
+                    return;
+                }
+
+                if (right != nullptr && right->count > min_inner_count)
+                {
+                    insert_child(n, n->count, std::move(parent->keys[i]), right->children[0]);
+                    parent->keys[i] = std::move(right->keys[0]);
+                    right->children[0] = right->children[1];
+                    remove_child(right, 0);
+                    return;
+                }
+
+                if (left != nullptr)
+                {
+                    merge_inners(left, n, std::move(parent->keys[i - 1]));
+                    remove_child(parent, i - 1);
+                }
+                else
+                {
+                    merge_inners(n, right, std::move(parent->keys[i]));
+                    remove_child(parent, i);
+                }
+            }
+        }
+
+        // moves the separator and then the keys and children of b, the node
+        // after a, into a and frees b
+        static void merge_inners(inner* a, inner* b, T separator)
+        {
+            a->keys[a->count] = std::move(separator);
+            std::move(b->keys.begin(), b->keys.begin() + b->count, a->keys.begin() + a->count + 1);
+            std::copy(b->children.begin(), b->children.begin() + b->count + 1,
+                a->children.begin() + a->count + 1);
+            a->count += b->count + 1;
+            delete b;
+        }
+
+        // copies the subtree level levels tall at source, linking its leaves
+        // in after previous
+        void* copy_subtree(const void* source, size_type level, leaf*& previous)
+        {
+            if (level == 1)
+            {
+                auto* copy = new leaf{ *static_cast<const leaf*>(source) };
+                copy->prev = previous;
+                copy->next = nullptr;
+                if (previous != nullptr)
+                {
+                    previous->next = copy;
+                }
+                else
+                {
+                    first_ = copy;
+                }
+                previous = last_ = copy;
+                return copy;
+            }
+
+            const auto* from = static_cast<const inner*>(source);
+            auto* copy = new inner{};
+            copy->count = from->count;
+            copy->keys = from->keys;
+
+            try
+            {
+                for (size_type i = 0; i <= from->count; ++i)
+                {
+                    copy->children[i] = copy_subtree(from->children[i], level - 1, previous);
+                }
+            }
+            catch (...)
+            {
+                free_subtree(copy, level);
+                throw;
+            }
+
+            return copy;
+        }
+
+        // the recursion is as deep as the tree, a handful of levels
+        static void free_subtree(void* n, size_type level)
+        {
+            if (level == 1)
+            {
+                delete static_cast<leaf*>(n);
+                return;
+            }
+
+            auto* in = static_cast<inner*>(n);
+            for (size_type i = 0; i <= in->count; ++i)
+            {
+                // a copy that failed part way leaves the rest null
+                if (in->children[i] != nullptr)
+                {
+                    free_subtree(in->children[i], level - 1);
+                }
+            }
+            delete in;
+        }
+
+        [[no_unique_address]] Compare compare_{};
+        void* root_{ nullptr };
+        leaf* first_{ nullptr };
+        leaf* last_{ nullptr };
+        size_type height_{ 0 };
+        size_type size_{ 0 };
+    };
+
+    // the range constructor cannot deduce the value type on its own
+    template <std::ranges::input_range R,
+        typename Compare = std::less<std::ranges::range_value_t<R>>>
+    btree_set(R&&, Compare = Compare{})
+        -> btree_set<std::ranges::range_value_t<R>, 256, Compare>;
+}
+
+export template <typename T, std::size_t NodeBytes, typename Compare>
+struct std::formatter<caff::btree_set<T, NodeBytes, Compare>>
+{
+    template <typename ParseContext>
+    constexpr auto parse(ParseContext& ctx)
+    {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext>
+    auto format(const caff::btree_set<T, NodeBytes, Compare>& set, FormatContext& ctx) const
+    {
+        auto out = ctx.out();
+        out = std::format_to(out, "[");
+
+        if (auto pos = set.begin(); pos != set.end())
+        {
+            out = std::format_to(out, "{}", *pos);
+            ++pos;
+
+            for (; pos != set.end(); ++pos)
+            {
+                out = std::format_to(out, ", {}", *pos);
+            }
+        }
+
+        return std::format_to(out, "]");
+    }
+};
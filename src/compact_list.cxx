@@ -0,0 +1,802 @@
+export module data_structures:compact_list;
+
+import std;
+
+namespace caff
+{
+    // An element of a compact_list together with the indices of its
+    // neighbours. The value is only alive while the slot is linked into the
+    // list; free slots reuse next as the free list link.
+    export template <typename T>
+    struct compact_list_slot
+    {
+        std::uint32_t prev;
+        std::uint32_t next;
+        alignas(T) std::byte storage[sizeof(T)];
+
+        T* data()
+        {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+
+        const T* data() const
+        {
+            return std::launder(reinterpret_cast<const T*>(storage));
+        }
+    };
+
+    // NOTE: The iterators refer to the list's slot pointer rather than to the
+    // slots themselves, so they stay valid when the slots are reallocated.
+    export template <typename T>
+    struct compact_list_iterator
+    {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using pointer = value_type*;
+        using reference = value_type&;
+
+        using slots_pointer = compact_list_slot<value_type>* const*;
+
+        compact_list_iterator() = default;
+
+        compact_list_iterator(slots_pointer slots, std::uint32_t index)
+            : slots_{ slots }, index_{ index }
+        {
+        }
+
+        friend bool operator==(const compact_list_iterator& lhs,
+            const compact_list_iterator& rhs) = default;
+
+        reference operator*() const
+        {
+            return *(*slots_)[index_].data();
+        }
+
+        pointer operator->() const
+        {
+            return std::addressof(**this);
+        }
+
+        compact_list_iterator& operator--()
+        {
+            index_ = (*slots_)[index_].prev;
+            return *this;
+        }
+
+        compact_list_iterator operator--(int)
+        {
+            compact_list_iterator tmp{ *this };
+            --*this;
+            return tmp;
+        }
+
+        compact_list_iterator& operator++()
+        {
+            index_ = (*slots_)[index_].next;
+            return *this;
+        }
+
+        compact_list_iterator operator++(int)
+        {
+            compact_list_iterator tmp{ *this };
+            ++*this;
+            return tmp;
+        }
+
+        slots_pointer slots() const
+        {
+            return slots_;
+        }
+
+        std::uint32_t index() const
+        {
+            return index_;
+        }
+
+    private:
+        slots_pointer slots_{ nullptr };
+        std::uint32_t index_{ 0 };
+    };
+
+    export template <typename T>
+    struct compact_list_const_iterator
+    {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        using slots_pointer = const compact_list_slot<value_type>* const*;
+
+        compact_list_const_iterator() = default;
+
+        compact_list_const_iterator(slots_pointer slots, std::uint32_t index)
+            : slots_{ slots }, index_{ index }
+        {
+        }
+
+        compact_list_const_iterator(const compact_list_iterator<value_type>& pos)
+            : slots_{ pos.slots() }, index_{ pos.index() }
+        {
+        }
+
+        friend bool operator==(const compact_list_const_iterator& lhs,
+            const compact_list_const_iterator& rhs) = default;
+
+        reference operator*() const
+        {
+            return *(*slots_)[index_].data();
+        }
+
+        pointer operator->() const
+        {
+            return std::addressof(**this);
+        }
+
+        compact_list_const_iterator& operator--()
+        {
+            index_ = (*slots_)[index_].prev;
+            return *this;
+        }
+
+        compact_list_const_iterator operator--(int)
+        {
+            compact_list_const_iterator tmp{ *this };
+            --*this;
+            return tmp;
+        }
+
+        compact_list_const_iterator& operator++()
+        {
+            index_ = (*slots_)[index_].next;
+            return *this;
+        }
+
+        compact_list_const_iterator operator++(int)
+        {
+            compact_list_const_iterator tmp{ *this };
+            ++*this;
+            return tmp;
+        }
+
+        slots_pointer slots() const
+        {
+            return slots_;
+        }
+
+        std::uint32_t index() const
+        {
+            return index_;
+        }
+
+    private:
+        slots_pointer slots_{ nullptr };
+        std::uint32_t index_{ 0 };
+    };
+
+    static_assert(std::bidirectional_iterator<compact_list_iterator<int>>);
+    static_assert(std::bidirectional_iterator<compact_list_const_iterator<int>>);
+
+    // A doubly linked list whose nodes live in one contiguous array and link
+    // to each other with 32-bit indices. Slot 0 is the sentinel, which is
+    // end(), and erased slots go on a free list for reuse. For small T a
+    // node costs a fraction of a heap allocated doubly_linked_list node, and
+    // compact() renumbers the nodes in traversal order so that a scan walks
+    // the array sequentially.
+    //
+    // NOTE: Growing the array keeps every node at its index, so insertions
+    // only invalidate iterators to erased elements. compact() invalidates
+    // all iterators, and so do moves and swaps, because iterators refer to
+    // the list object.
+    export template <typename T, typename Allocator = std::allocator<T>>
+    class compact_list
+    {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using iterator = compact_list_iterator<value_type>;
+        using const_iterator = compact_list_const_iterator<value_type>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        using allocator_type = Allocator;
+        using index_type = std::uint32_t;
+
+        using slot = compact_list_slot<value_type>;
+        using slot_allocator_type = typename std::allocator_traits<
+            allocator_type>::template rebind_alloc<slot>;
+
+        compact_list() = default;
+
+        explicit compact_list(const allocator_type& alloc) : alloc_{ alloc }
+        {
+        }
+
+        compact_list(std::initializer_list<T> values,
+            const allocator_type& alloc = allocator_type())
+            : alloc_{ alloc }
+        {
+            reserve(values.size());
+            insert(end(), values.begin(), values.end());
+        }
+
+        compact_list(const compact_list& other)
+            : alloc_{ slot_traits::select_on_container_copy_construction(
+                other.alloc_) }
+        {
+            reserve(other.size());
+            insert(end(), other.begin(), other.end());
+        }
+
+        compact_list(compact_list&& other) noexcept
+            : slots_{ std::exchange(other.slots_, nullptr) },
+              capacity_{ std::exchange(other.capacity_, 0) },
+              used_{ std::exchange(other.used_, 0) },
+              free_{ std::exchange(other.free_, npos) },
+              size_{ std::exchange(other.size_, 0) },
+              alloc_{ std::move(other.alloc_) }
+        {
+        }
+
+        ~compact_list()
+        {
+            release();
+        }
+
+        compact_list& operator=(const compact_list& other)
+        {
+            if (this != std::addressof(other))
+            {
+                clear();
+
+                if constexpr (slot_traits::propagate_on_container_copy_assignment::value)
+                {
+                    if (alloc_ != other.alloc_)
+                    {
+                        release();
+                    }
+                    alloc_ = other.alloc_;
+                }
+
+                reserve(other.size());
+                insert(end(), other.begin(), other.end());
+            }
+
+            return *this;
+        }
+
+        compact_list& operator=(compact_list&& other) noexcept(
+            slot_traits::propagate_on_container_move_assignment::value ||
+            slot_traits::is_always_equal::value)
+        {
+            if (this != std::addressof(other))
+            {
+                if constexpr (!slot_traits::propagate_on_container_move_assignment::value)
+                {
+                    if (alloc_ != other.alloc_)
+                    {
+                        // the slots can't be stolen because this list can't
+                        // free them; move the elements instead
+                        clear();
+                        reserve(other.size());
+                        insert(end(), std::make_move_iterator(other.begin()),
+                            std::make_move_iterator(other.end()));
+                        other.clear();
+                        return *this;
+                    }
+                }
+
+                release();
+
+                if constexpr (slot_traits::propagate_on_container_move_assignment::value)
+                {
+                    alloc_ = std::move(other.alloc_);
+                }
+
+                slots_ = std::exchange(other.slots_, nullptr);
+                capacity_ = std::exchange(other.capacity_, 0);
+                used_ = std::exchange(other.used_, 0);
+                free_ = std::exchange(other.free_, npos);
+                size_ = std::exchange(other.size_, 0);
+            }
+
+            return *this;
+        }
+
+        compact_list& operator=(std::initializer_list<T> values)
+        {
+            clear();
+            reserve(values.size());
+            insert(end(), values.begin(), values.end());
+            return *this;
+        }
+
+        allocator_type get_allocator() const
+        {
+            return allocator_type(alloc_);
+        }
+
+        reference front()
+        {
+            return *begin();
+        }
+
+        const_reference front() const
+        {
+            return *begin();
+        }
+
+        reference back()
+        {
+            return *std::prev(end());
+        }
+
+        const_reference back() const
+        {
+            return *std::prev(end());
+        }
+
+        iterator begin()
+        {
+            return iterator{ std::addressof(slots_), first_index() };
+        }
+
+        const_iterator begin() const
+        {
+            return const_iterator{ std::addressof(slots_), first_index() };
+        }
+
+        const_iterator cbegin() const
+        {
+            return begin();
+        }
+
+        iterator end()
+        {
+            return iterator{ std::addressof(slots_), 0 };
+        }
+
+        const_iterator end() const
+        {
+            return const_iterator{ std::addressof(slots_), 0 };
+        }
+
+        const_iterator cend() const
+        {
+            return end();
+        }
+
+        reverse_iterator rbegin()
+        {
+            return reverse_iterator{ end() };
+        }
+
+        const_reverse_iterator rbegin() const
+        {
+            return const_reverse_iterator{ end() };
+        }
+
+        reverse_iterator rend()
+        {
+            return reverse_iterator{ begin() };
+        }
+
+        const_reverse_iterator rend() const
+        {
+            return const_reverse_iterator{ begin() };
+        }
+
+        bool empty() const
+        {
+            return size_ == 0;
+        }
+
+        size_type size() const
+        {
+            return size_;
+        }
+
+        // one index is the sentinel and one marks the end of the free list
+        static constexpr size_type max_size()
+        {
+            return std::numeric_limits<index_type>::max() - 1;
+        }
+
+        // the number of elements the list can hold without reallocating
+        size_type capacity() const
+        {
+            return (capacity_ == 0) ? 0 : capacity_ - 1;
+        }
+
+        void reserve(size_type new_capacity)
+        {
+            if (new_capacity > max_size())
+            {
+                throw std::length_error{ "compact_list::reserve" };
+            }
+
+            if (new_capacity + 1 > capacity_)
+            {
+                reallocate(static_cast<index_type>(new_capacity + 1));
+            }
+        }
+
+        // destroys the elements but keeps the slots for reuse
+        void clear()
+        {
+            for (auto index = first_index(); index != 0;)
+            {
+                auto& s = slots_[index];
+                std::destroy_at(s.data());
+                index = s.next;
+            }
+
+            if (slots_ != nullptr)
+            {
+                slots_[0].prev = 0;
+                slots_[0].next = 0;
+                used_ = 1;
+            }
+
+            free_ = npos;
+            size_ = 0;
+        }
+
+        iterator insert(const_iterator pos, const T& value)
+        {
+            return emplace(pos, value);
+        }
+
+        iterator insert(const_iterator pos, T&& value)
+        {
+            return emplace(pos, std::move(value));
+        }
+
+        // inserts all of the elements or, if a constructor throws, none
+        template <std::input_iterator InputIt>
+        requires (std::constructible_from<T, std::iter_reference_t<InputIt>>)
+        iterator insert(const_iterator pos, InputIt first, InputIt last)
+        {
+            if (first == last)
+            {
+                return iterator{ std::addressof(slots_), pos.index() };
+            }
+
+            auto result = emplace(pos, *first);
+
+            try
+            {
+                for (++first; first != last; ++first)
+                {
+                    emplace(pos, *first);
+                }
+            }
+            catch (...)
+            {
+                erase(result, pos);
+                throw;
+            }
+
+            return result;
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<T> values)
+        {
+            return insert(pos, values.begin(), values.end());
+        }
+
+        template <typename... Args>
+        requires (std::constructible_from<T, Args...>)
+        iterator emplace(const_iterator pos, Args&&... args)
+        {
+            // growing the array moves every element, so when it has to grow
+            // construct the value first, in case args refer to an element
+            if (free_ == npos && used_ == capacity_)
+            {
+                T value(std::forward<Args>(args)...);
+                return emplace_in_slot(pos, std::move(value));
+            }
+
+            return emplace_in_slot(pos, std::forward<Args>(args)...);
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            const auto index = pos.index();
+            auto& s = slots_[index];
+            const auto next_index = s.next;
+
+            slots_[s.prev].next = next_index;
+            slots_[next_index].prev = s.prev;
+
+            std::destroy_at(s.data());
+            release_slot(index);
+
+            --size_;
+            return iterator{ std::addressof(slots_), next_index };
+        }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            while (first != last)
+            {
+                first = erase(first);
+            }
+
+            return iterator{ std::addressof(slots_), last.index() };
+        }
+
+        void push_back(const T& value)
+        {
+            emplace(end(), value);
+        }
+
+        void push_back(T&& value)
+        {
+            emplace(end(), std::move(value));
+        }
+
+        void push_front(const T& value)
+        {
+            emplace(begin(), value);
+        }
+
+        void push_front(T&& value)
+        {
+            emplace(begin(), std::move(value));
+        }
+
+        template <typename... Args>
+        requires (std::constructible_from<T, Args...>)
+        reference emplace_back(Args&&... args)
+        {
+            return *emplace(end(), std::forward<Args>(args)...);
+        }
+
+        template <typename... Args>
+        requires (std::constructible_from<T, Args...>)
+        reference emplace_front(Args&&... args)
+        {
+            return *emplace(begin(), std::forward<Args>(args)...);
+        }
+
+        void pop_back()
+        {
+            erase(std::prev(end()));
+        }
+
+        void pop_front()
+        {
+            erase(begin());
+        }
+
+        // renumbers the nodes in traversal order into an array that fits the
+        // list exactly, so that a scan reads the array front to back; frees
+        // the array when the list is empty
+        void compact()
+        {
+            if (size_ == 0)
+            {
+                release();
+                return;
+            }
+
+            const auto new_capacity = static_cast<index_type>(size_ + 1);
+            auto* new_slots = slot_traits::allocate(alloc_, new_capacity);
+            index_type count{ 0 };
+
+            try
+            {
+                for (auto index = first_index(); index != 0;
+                    index = slots_[index].next)
+                {
+                    std::construct_at(new_slots[count + 1].data(),
+                        std::move_if_noexcept(*slots_[index].data()));
+                    ++count;
+                }
+            }
+            catch (...)
+            {
+                std::destroy_n(new_slots + 1, count);
+                slot_traits::deallocate(alloc_, new_slots, new_capacity);
+                throw;
+            }
+
+            for (index_type i = 0; i < new_capacity; ++i)
+            {
+                new_slots[i].prev = (i == 0) ? count : i - 1;
+                new_slots[i].next = (i == count) ? 0 : i + 1;
+            }
+
+            const auto new_size = size_;
+            release();
+
+            slots_ = new_slots;
+            capacity_ = new_capacity;
+            used_ = new_capacity;
+            size_ = new_size;
+        }
+
+        void swap(compact_list& other) noexcept
+        {
+            if constexpr (slot_traits::propagate_on_container_swap::value)
+            {
+                std::ranges::swap(alloc_, other.alloc_);
+            }
+
+            std::ranges::swap(slots_, other.slots_);
+            std::ranges::swap(capacity_, other.capacity_);
+            std::ranges::swap(used_, other.used_);
+            std::ranges::swap(free_, other.free_);
+            std::ranges::swap(size_, other.size_);
+        }
+
+        friend void swap(compact_list& lhs, compact_list& rhs) noexcept
+        {
+            lhs.swap(rhs);
+        }
+
+        friend bool operator==(const compact_list& lhs, const compact_list& rhs)
+        {
+            return std::ranges::equal(lhs, rhs);
+        }
+
+        friend auto operator<=>(const compact_list& lhs, const compact_list& rhs)
+        {
+            return std::lexicographical_compare_three_way(
+                lhs.begin(), lhs.end(),
+                rhs.begin(), rhs.end()
+            );
+        }
+
+    private:
+        using slot_traits = std::allocator_traits<slot_allocator_type>;
+
+        static constexpr index_type npos{ std::numeric_limits<index_type>::max() };
+
+        index_type first_index() const
+        {
+            return (slots_ != nullptr) ? slots_[0].next : 0;
+        }
+
+        // a free slot, growing the array when there are none left
+        index_type acquire_slot()
+        {
+            if (free_ != npos)
+            {
+                return std::exchange(free_, slots_[free_].next);
+            }
+
+            if (used_ == capacity_)
+            {
+                if (size_ == max_size())
+                {
+                    throw std::length_error{ "compact_list is full" };
+                }
+
+                const auto new_capacity = std::min<size_type>(
+                    std::max<size_type>(2 * static_cast<size_type>(capacity_), 16),
+                    max_size() + 1);
+                reallocate(static_cast<index_type>(new_capacity));
+            }
+
+            return used_++;
+        }
+
+        void release_slot(index_type index)
+        {
+            slots_[index].next = free_;
+            free_ = index;
+        }
+
+        // links in a new element before pos, constructed in a free slot
+        template <typename... Args>
+        iterator emplace_in_slot(const_iterator pos, Args&&... args)
+        {
+            const auto index = acquire_slot();
+
+            try
+            {
+                std::construct_at(slots_[index].data(), std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                release_slot(index);
+                throw;
+            }
+
+            const auto next_index = pos.index();
+            const auto prev_index = slots_[next_index].prev;
+
+            slots_[index].prev = prev_index;
+            slots_[index].next = next_index;
+            slots_[prev_index].next = index;
+            slots_[next_index].prev = index;
+
+            ++size_;
+            return iterator{ std::addressof(slots_), index };
+        }
+
+        // moves the slots into an array of new_capacity slots, keeping every
+        // node at its index
+        void reallocate(index_type new_capacity)
+        {
+            auto* new_slots = slot_traits::allocate(alloc_, new_capacity);
+
+            if (slots_ == nullptr)
+            {
+                new_slots[0].prev = 0;
+                new_slots[0].next = 0;
+                slots_ = new_slots;
+                capacity_ = new_capacity;
+                used_ = 1;
+                return;
+            }
+
+            // free slots only hold links, so only the linked slots have
+            // values to move
+            index_type index{ slots_[0].next };
+
+            try
+            {
+                for (; index != 0; index = slots_[index].next)
+                {
+                    std::construct_at(new_slots[index].data(),
+                        std::move_if_noexcept(*slots_[index].data()));
+                }
+            }
+            catch (...)
+            {
+                for (auto i = slots_[0].next; i != index; i = slots_[i].next)
+                {
+                    std::destroy_at(new_slots[i].data());
+                }
+
+                slot_traits::deallocate(alloc_, new_slots, new_capacity);
+                throw;
+            }
+
+            for (index_type i = 0; i < used_; ++i)
+            {
+                new_slots[i].prev = slots_[i].prev;
+                new_slots[i].next = slots_[i].next;
+            }
+
+            for (auto i = slots_[0].next; i != 0; i = slots_[i].next)
+            {
+                std::destroy_at(slots_[i].data());
+            }
+
+            slot_traits::deallocate(alloc_, slots_, capacity_);
+            slots_ = new_slots;
+            capacity_ = new_capacity;
+        }
+
+        // destroys the elements and frees the array
+        void release()
+        {
+            clear();
+
+            if (slots_ != nullptr)
+            {
+                slot_traits::deallocate(alloc_, slots_, capacity_);
+                slots_ = nullptr;
+                capacity_ = 0;
+                used_ = 0;
+            }
+        }
+
+        slot* slots_{ nullptr };
+        index_type capacity_{ 0 };
+        index_type used_{ 0 };
+        index_type free_{ npos };
+        size_type size_{ 0 };
+        [[no_unique_address]] slot_allocator_type alloc_{ };
+    };
+}
@@ -1,7 +1,21 @@
 export module data_structures;
 
 export import :binary_tree;
+export import :btree_set;
+export import :compact_list;
 export import :doubly_linked_list;
+export import :frozen_tree;
+export import :hazard_pointer;
+export import :indexed_list;
 export import :inplace_vector;
+export import :intrusive_linked_list;
 export import :linked_list;
+export import :lru_cache;
+export import :lock_free_queue;
+export import :lock_free_stack;
+export import :pool_allocator;
+export import :prefetch;
 export import :rope;
+export import :unrolled_linked_list;
+export import :work_stealing_deque;
+export import :work_stealing_pool;
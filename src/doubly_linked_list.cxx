@@ -1,24 +1,61 @@
 export module data_structures:doubly_linked_list;
 
 import std;
+import :prefetch;
 
 namespace caff
 {
-    export class doubly_linked_list
+    // NOTE: The list is a circular ring through an embedded sentinel node,
+    // which is end(). The first and last elements link to the sentinel
+    // rather than to null, so inserting and erasing never have to special
+    // case the ends of the list, and --end() is the last element without the
+    // iterator needing to know about the list.
+    export template <typename T, typename Allocator = std::allocator<T>>
+    class doubly_linked_list
     {
+    private:
+        struct node_base;
+        struct list_node;
+
     public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using allocator_type = Allocator;
+
+        using node_allocator_type = typename std::allocator_traits<
+            allocator_type>::template rebind_alloc<list_node>;
+
         doubly_linked_list() = default;
 
-        doubly_linked_list(std::initializer_list<int> values)
+        explicit doubly_linked_list(const allocator_type& alloc) : alloc_{ alloc }
+        {
+        }
+
+        doubly_linked_list(std::initializer_list<T> values,
+            const allocator_type& alloc = allocator_type())
+            : alloc_{ alloc }
         {
             insert(end(), values.begin(), values.end());
         }
 
         doubly_linked_list(const doubly_linked_list& other)
+            : alloc_{ node_traits::select_on_container_copy_construction(
+                other.alloc_) }
         {
             insert(end(), other.begin(), other.end());
         }
 
+        doubly_linked_list(doubly_linked_list&& other) noexcept
+            : alloc_{ std::move(other.alloc_) }
+        {
+            steal_nodes(other);
+        }
+
         ~doubly_linked_list()
         {
             clear();
@@ -29,36 +66,72 @@ namespace caff
             if (this != &other)
             {
                 clear();
+
+                if constexpr (node_traits::propagate_on_container_copy_assignment::value)
+                {
+                    alloc_ = other.alloc_;
+                }
+
                 insert(end(), other.begin(), other.end());
             }
 
             return *this;
         }
 
-        doubly_linked_list& operator=(std::initializer_list<int> values)
+        doubly_linked_list& operator=(doubly_linked_list&& other) noexcept(
+            node_traits::propagate_on_container_move_assignment::value ||
+            node_traits::is_always_equal::value)
+        {
+            if (this != &other)
+            {
+                clear();
+
+                if constexpr (node_traits::propagate_on_container_move_assignment::value)
+                {
+                    alloc_ = std::move(other.alloc_);
+                }
+                else if (alloc_ != other.alloc_)
+                {
+                    // the nodes can't be stolen because this list can't free
+                    // them; move the elements instead
+                    insert(end(), std::make_move_iterator(other.begin()),
+                        std::make_move_iterator(other.end()));
+                    other.clear();
+                    return *this;
+                }
+
+                steal_nodes(other);
+            }
+
+            return *this;
+        }
+
+        doubly_linked_list& operator=(std::initializer_list<T> values)
         {
             clear();
             insert(end(), values.begin(), values.end());
             return *this;
         }
 
-        class list_node;
+        allocator_type get_allocator() const
+        {
+            return allocator_type(alloc_);
+        }
 
         class iterator
         {
         public:
             using iterator_category = std::bidirectional_iterator_tag;
-            using value_type = int;
+            using value_type = T;
             using difference_type = std::ptrdiff_t;
-            using pointer = int*;
-            using reference = int&;
+            using pointer = value_type*;
+            using reference = value_type&;
 
-            using node_pointer = list_node*;
+            using node_pointer = node_base*;
 
             iterator() = default;
 
-            iterator(node_pointer n, doubly_linked_list* list) : node_{ n },
-                list_{ list }
+            explicit iterator(node_pointer n) : node_{ n }
             {
             }
 
@@ -66,24 +139,17 @@ namespace caff
 
             reference operator*() const
             {
-                return node_->value;
+                return static_cast<list_node*>(node_)->value;
             }
 
             pointer operator->() const
             {
-                return std::addressof(node_->value);
+                return std::addressof(**this);
             }
 
             iterator& operator--()
             {
-                if (node_ != nullptr)
-                {
-                    node_ = node_->prev;
-                }
-                else
-                {
-                    node_ = list_->tail_;
-                }
+                node_ = node_->prev;
                 return *this;
             }
 
@@ -96,10 +162,7 @@ namespace caff
 
             iterator& operator++()
             {
-                if (node_ != nullptr)
-                {
-                    node_ = node_->next;
-                }
+                node_ = node_->next;
                 return *this;
             }
 
@@ -115,36 +178,28 @@ namespace caff
                 return node_;
             }
 
-            doubly_linked_list* list() const
-            {
-                return list_;
-            }
-
         private:
             node_pointer node_{ nullptr };
-            doubly_linked_list* list_{ nullptr };
         };
 
         class const_iterator
         {
         public:
             using iterator_category = std::bidirectional_iterator_tag;
-            using value_type = const int;
+            using value_type = T;
             using difference_type = std::ptrdiff_t;
-            using pointer = const int*;
-            using reference = const int&;
+            using pointer = const value_type*;
+            using reference = const value_type&;
 
-            using node_pointer = const list_node*;
+            using node_pointer = const node_base*;
 
             const_iterator() = default;
 
-            const_iterator(node_pointer n, const doubly_linked_list* list) :
-                node_{ n }, list_{ list }
+            explicit const_iterator(node_pointer n) : node_{ n }
             {
             }
 
-            const_iterator(const iterator& pos) : node_{ pos.node() },
-                list_{ pos.list() }
+            const_iterator(const iterator& pos) : node_{ pos.node() }
             {
             }
 
@@ -152,24 +207,17 @@ namespace caff
 
             reference operator*() const
             {
-                return node_->value;
+                return static_cast<const list_node*>(node_)->value;
             }
 
             pointer operator->() const
             {
-                return std::addressof(node_->value);
+                return std::addressof(**this);
             }
 
             const_iterator& operator--()
             {
-                if (node_ != nullptr)
-                {
-                    node_ = node_->prev;
-                }
-                else
-                {
-                    node_ = list_->tail_;
-                }
+                node_ = node_->prev;
                 return *this;
             }
 
@@ -182,10 +230,7 @@ namespace caff
 
             const_iterator& operator++()
             {
-                if (node_ != nullptr)
-                {
-                    node_ = node_->next;
-                }
+                node_ = node_->next;
                 return *this;
             }
 
@@ -201,37 +246,51 @@ namespace caff
                 return node_;
             }
 
-            const doubly_linked_list* list() const
-            {
-                return list_;
-            }
-
         private:
             node_pointer node_{ nullptr };
-            const doubly_linked_list* list_{ nullptr };
         };
 
         using reverse_iterator = std::reverse_iterator<iterator>;
         using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
+        reference front()
+        {
+            return *begin();
+        }
+
+        const_reference front() const
+        {
+            return *begin();
+        }
+
+        reference back()
+        {
+            return *std::prev(end());
+        }
+
+        const_reference back() const
+        {
+            return *std::prev(end());
+        }
+
         iterator begin()
         {
-            return iterator{ head_, this };
+            return iterator{ sentinel_.next };
         }
 
         iterator end()
         {
-            return iterator{ nullptr, this };
+            return iterator{ std::addressof(sentinel_) };
         }
 
         const_iterator begin() const
         {
-            return const_iterator{ head_, this };
+            return const_iterator{ sentinel_.next };
         }
 
         const_iterator end() const
         {
-            return const_iterator{ nullptr, this };
+            return const_iterator{ std::addressof(sentinel_) };
         }
 
         reverse_iterator rbegin()
@@ -256,7 +315,7 @@ namespace caff
 
         bool empty() const
         {
-            return head_ == nullptr && tail_ == nullptr;
+            return sentinel_.next == std::addressof(sentinel_);
         }
 
         std::size_t size() const
@@ -266,269 +325,661 @@ namespace caff
 
         void clear()
         {
-            auto* node = head_;
-            head_ = nullptr;
-            tail_ = nullptr;
+            auto* node = sentinel_.next;
+            sentinel_.prev = std::addressof(sentinel_);
+            sentinel_.next = std::addressof(sentinel_);
             size_ = 0;
 
-            while (node != nullptr)
+            while (node != std::addressof(sentinel_))
             {
                 auto* temp = node;
                 node = node->next;
-                delete temp;
+                destroy_node(static_cast<list_node*>(temp));
             }
         }
 
-        iterator insert(const_iterator pos, int value)
+        iterator insert(const_iterator pos, const T& value)
+        {
+            return emplace(pos, value);
+        }
+
+        iterator insert(const_iterator pos, T&& value)
         {
-            auto* new_node = new list_node
+            return emplace(pos, std::move(value));
+        }
+
+        template <typename... Args>
+        requires (std::constructible_from<T, Args...>)
+        iterator emplace(const_iterator pos, Args&&... args)
+        {
+            auto* new_node = create_node(std::forward<Args>(args)...);
+            link_before(pos, new_node, new_node, 1);
+            return iterator{ new_node };
+        }
+
+        template <std::input_iterator InputIt>
+        requires (std::constructible_from<T, std::iter_reference_t<InputIt>>)
+        iterator insert(const_iterator pos, InputIt first, InputIt last)
+        {
+            if (first == last)
             {
-                .value = value,
-                .prev = nullptr,
-                .next = nullptr
-            };
+                return iterator{ mutable_node(pos) };
+            }
+
+            // construct the new nodes as a separate chain, keeping track of
+            // the first, last and count, so the list is untouched if a
+            // constructor throws
+            auto* first_node = create_node(*first);
+            auto* last_node = first_node;
+            std::size_t new_node_count{ 1 };
 
-            // the new node is the new head_
-            if (pos == begin())
+            try
+            {
+                for (++first; first != last; ++first)
+                {
+                    auto* new_node = create_node(*first);
+                    new_node->prev = last_node;
+                    last_node->next = new_node;
+                    last_node = new_node;
+                    ++new_node_count;
+                }
+            }
+            catch (...)
             {
-                if (head_ != nullptr)
+                // the chain isn't linked into the ring yet, so it ends in null
+                for (node_base* n = first_node; n != nullptr;)
                 {
-                    new_node->next = head_;
-                    head_->prev = new_node;
+                    destroy_node(static_cast<list_node*>(std::exchange(n, n->next)));
                 }
+                throw;
+            }
+
+            link_before(pos, first_node, last_node, new_node_count);
+            return iterator{ first_node };
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<T> values)
+        {
+            return insert(pos, values.begin(), values.end());
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            auto* erased_node = mutable_node(pos);
+            auto* prev_node = erased_node->prev;
+            auto* next_node = erased_node->next;
+
+            prev_node->next = next_node;
+            next_node->prev = prev_node;
+
+            destroy_node(static_cast<list_node*>(erased_node));
+            --size_;
+            return iterator{ next_node };
+        }
+
+        void push_back(const T& value)
+        {
+            insert(end(), value);
+        }
+
+        void push_back(T&& value)
+        {
+            insert(end(), std::move(value));
+        }
+
+        void push_front(const T& value)
+        {
+            insert(begin(), value);
+        }
+
+        void push_front(T&& value)
+        {
+            insert(begin(), std::move(value));
+        }
+
+        template <typename... Args>
+        requires (std::constructible_from<T, Args...>)
+        reference emplace_back(Args&&... args)
+        {
+            return *emplace(end(), std::forward<Args>(args)...);
+        }
+
+        template <typename... Args>
+        requires (std::constructible_from<T, Args...>)
+        reference emplace_front(Args&&... args)
+        {
+            return *emplace(begin(), std::forward<Args>(args)...);
+        }
+
+        void pop_back()
+        {
+            erase(std::prev(end()));
+        }
+
+        void pop_front()
+        {
+            erase(begin());
+        }
+
+        // moves the element at it from other to before pos without copying
+        // or reallocating it; other may be this list, and the two lists must
+        // use equal allocators
+        void splice(const_iterator pos, doubly_linked_list& other,
+            const_iterator it)
+        {
+            auto* moved_node = mutable_node(it);
+            auto* next_node = mutable_node(pos);
+
+            if (moved_node == next_node || moved_node->next == next_node)
+            {
+                return;
+            }
+
+            moved_node->prev->next = moved_node->next;
+            moved_node->next->prev = moved_node->prev;
+            --other.size_;
+
+            link_before(pos, moved_node, moved_node, 1);
+        }
+
+        void splice(const_iterator pos, doubly_linked_list&& other,
+            const_iterator it)
+        {
+            splice(pos, other, it);
+        }
+
+        // moves all of other's elements to before pos in O(1); other must not
+        // be this list
+        void splice(const_iterator pos, doubly_linked_list& other)
+        {
+            if (other.empty())
+            {
+                return;
+            }
+
+            auto* first_node = other.sentinel_.next;
+            auto* last_node = other.sentinel_.prev;
+            const auto count = std::exchange(other.size_, 0);
+            other.relink_sentinel();
+
+            link_before(pos, first_node, last_node, count);
+        }
+
+        void splice(const_iterator pos, doubly_linked_list&& other)
+        {
+            splice(pos, other);
+        }
 
-                head_ = new_node;
+        // moves the elements in [first, last) from other to before pos. O(1)
+        // within a list; between lists the range has to be counted. pos must
+        // not be in the range.
+        void splice(const_iterator pos, doubly_linked_list& other,
+            const_iterator first, const_iterator last)
+        {
+            if (first == last)
+            {
+                return;
+            }
+
+            const auto count = (std::addressof(other) == this) ? 0 :
+                static_cast<std::size_t>(std::distance(first, last));
+
+            auto* first_node = mutable_node(first);
+            auto* last_node = mutable_node(last)->prev;
+
+            first_node->prev->next = last_node->next;
+            last_node->next->prev = first_node->prev;
+            other.size_ -= count;
+
+            link_before(pos, first_node, last_node, count);
+        }
+
+        void splice(const_iterator pos, doubly_linked_list&& other,
+            const_iterator first, const_iterator last)
+        {
+            splice(pos, other, first, last);
+        }
 
-                if (tail_ == nullptr)
+        // merges the sorted other list into this sorted list by relinking
+        // nodes; equivalent elements from this list precede those from other.
+        // If comp throws, this list keeps the elements of both, in no
+        // particular order, and other is left empty.
+        void merge(doubly_linked_list& other)
+        {
+            merge(other, std::less<>{});
+        }
+
+        void merge(doubly_linked_list&& other)
+        {
+            merge(other, std::less<>{});
+        }
+
+        template <typename Compare>
+        void merge(doubly_linked_list& other, Compare comp)
+        {
+            if (this == std::addressof(other) || other.empty())
+            {
+                return;
+            }
+
+            auto* merged = unlink_all();
+            auto* other_nodes = other.unlink_all();
+            size_ += std::exchange(other.size_, 0);
+
+            try
+            {
+                merged = merge_nodes(merged, other_nodes, comp);
+            }
+            catch (...)
+            {
+                link_chain(merged);
+                throw;
+            }
+
+            link_chain(merged);
+        }
+
+        template <typename Compare>
+        void merge(doubly_linked_list&& other, Compare comp)
+        {
+            merge(other, comp);
+        }
+
+        // stable bottom-up merge sort that only relinks nodes: O(n log n)
+        // comparisons and O(1) extra space. The runs are merged through the
+        // next links alone, and the prev links are restored in one final pass.
+        // If comp throws, the list keeps every element, in no particular
+        // order.
+        void sort()
+        {
+            sort(std::less<>{});
+        }
+
+        template <typename Compare>
+        void sort(Compare comp)
+        {
+            // runs[i] is either empty or a sorted run of 2^i nodes; runs with
+            // a higher index hold earlier elements, which keeps the sort
+            // stable
+            std::array<node_base*, std::numeric_limits<std::size_t>::digits> runs{};
+
+            auto* current = unlink_all();
+            node_base* carry{ nullptr };
+
+            try
+            {
+                while (current != nullptr)
                 {
-                    tail_ = head_;
+                    carry = current;
+                    current = current->next;
+                    carry->next = nullptr;
+
+                    std::size_t i{ 0 };
+                    for (; runs[i] != nullptr; ++i)
+                    {
+                        carry = merge_nodes(runs[i], carry, comp);
+                    }
+                    runs[i] = std::exchange(carry, nullptr);
+                }
+
+                for (auto& run : runs)
+                {
+                    if (run != nullptr)
+                    {
+                        carry = merge_nodes(run, carry, comp);
+                    }
                 }
-                ++size_;
-                return iterator{ head_, this };
             }
-            // the new node is the new tail_
-            else if (pos == end())
+            catch (...)
             {
-                if (tail_ != nullptr)
+                // the merge that threw left its nodes in one chain in its
+                // run, so relinking the runs, carry and the unsorted rest
+                // loses nothing
+                for (auto* run : runs)
                 {
-                    new_node->prev = tail_;
-                    tail_->next = new_node;
+                    carry = concatenate(run, carry);
                 }
+                link_chain(concatenate(carry, current));
+                throw;
+            }
+
+            link_chain(carry);
+        }
+
+        // moves every element into a new node, allocating all of the new
+        // nodes in traversal order before the old ones are freed. The list
+        // is only as contiguous as the allocator makes it: a bump allocator
+        // or the top of a fresh heap hands out consecutive memory, and so
+        // does a pool_allocator whose free list is empty, but one holding
+        // freed nodes hands them back most recently freed first, wherever
+        // they are, and locality() barely improves. Iteration in either
+        // direction benefits from a contiguous layout.
+        //
+        // NOTE: Invalidates every iterator, pointer and reference into the
+        // list. Every new node is allocated before any element is moved,
+        // and elements are copied if moving them could throw, so if
+        // anything throws the list is left unchanged.
+        void relayout()
+        {
+            std::vector<list_node*> nodes;
+            nodes.reserve(size_);
 
-                tail_ = new_node;
+            const auto deallocate_nodes = [this, &nodes]
+            {
+                for (auto* p : nodes)
+                {
+                    node_traits::deallocate(alloc_, p, 1);
+                }
+            };
 
-                //assert(head_ != nullptr);
-                if (head_ == nullptr)
+            try
+            {
+                for (std::size_t i = 0; i < size_; ++i)
                 {
-                    head_ = tail_;
+                    nodes.push_back(node_traits::allocate(alloc_, 1));
                 }
-                ++size_;
-                return iterator{ tail_, this };
             }
-            else
+            catch (...)
             {
-                for (auto current_pos = std::next(begin()); current_pos != end();
-                    ++current_pos)
+                deallocate_nodes();
+                throw;
+            }
+
+            std::size_t constructed{ 0 };
+            try
+            {
+                for (auto& value : *this)
                 {
-                    // found the insertion position
-                    if (current_pos == pos)
+                    ::new (static_cast<void*>(nodes[constructed])) list_node
                     {
-                        auto* prev_node = current_pos.node()->prev;
-                        auto* next_node = current_pos.node();
-
-                        new_node->prev = prev_node;
-                        new_node->next = next_node;
-
-                        prev_node->next = new_node;
-                        next_node->prev = new_node;
-                    
-                        ++size_;
-                        return current_pos;
-                    }
+                        { .prev = nullptr, .next = nullptr },
+                        T(std::move_if_noexcept(value))
+                    };
+                    ++constructed;
+                }
+            }
+            catch (...)
+            {
+                for (std::size_t i = 0; i < constructed; ++i)
+                {
+                    std::destroy_at(nodes[i]);
                 }
+                deallocate_nodes();
+                throw;
             }
 
-            // should never happen
-            return end();
+            node_base* first{ nullptr };
+            for (auto* n : nodes | std::views::reverse)
+            {
+                n->next = std::exchange(first, n);
+            }
+
+            auto* old_first = unlink_all();
+            link_chain(first);
+            destroy_chain(old_first);
         }
 
-        template <std::input_iterator InputIt>
-        requires (std::same_as<std::iter_value_t<InputIt>, int>)
-        iterator insert(const_iterator pos, InputIt first, InputIt last)
+        // the fraction of links that lead to a node starting after the
+        // current one and less than a cache line past its end: 1 when the
+        // list is laid out contiguously in traversal order, and close to 0
+        // when its nodes are scattered. Useful for deciding when relayout()
+        // is worth running. O(n).
+        double locality() const
         {
-            if (first == last)
+            if (size_ < 2)
+            {
+                return 1.0;
+            }
+
+            constexpr std::uintptr_t max_gap{ cache_line_bytes };
+            std::size_t sequential{ 0 };
+
+            for (auto* n = sentinel_.next; n->next != std::addressof(sentinel_); n = n->next)
             {
-                // TODO: use const_cast on pos.node()?
-                for (auto current_pos = begin(); current_pos != end();
-                    ++current_pos)
+                const auto end = reinterpret_cast<std::uintptr_t>(n) + sizeof(list_node);
+                const auto next = reinterpret_cast<std::uintptr_t>(n->next);
+
+                if (next >= end && next - end < max_gap)
                 {
-                    if (current_pos == pos)
-                    {
-                        return current_pos;
-                    }
+                    ++sequential;
                 }
+            }
 
-                // should never happen
-                return end();
+            return static_cast<double>(sequential) / static_cast<double>(size_ - 1);
+        }
+
+        void swap(doubly_linked_list& other) noexcept
+        {
+            if constexpr (node_traits::propagate_on_container_swap::value)
+            {
+                std::ranges::swap(alloc_, other.alloc_);
             }
 
-    #if 0
-            // construct the new nodes, keeping track of the first, last and count
-            auto* first_node = new list_node{ .value = *first, .next = nullptr };
-            auto* last_node = first_node;
-            std::size_t new_node_count{ 1 };
-            
-            for (auto pos = std::next(first); pos != last; ++pos)
+            std::ranges::swap(sentinel_, other.sentinel_);
+            std::ranges::swap(size_, other.size_);
+            relink_sentinel();
+            other.relink_sentinel();
+        }
+
+        friend void swap(doubly_linked_list& lhs, doubly_linked_list& rhs) noexcept
+        {
+            lhs.swap(rhs);
+        }
+
+    private:
+        struct node_base
+        {
+            node_base* prev{ nullptr };
+            node_base* next{ nullptr };
+        };
+
+        // NOTE: The value is initialized from a prvalue, which constructs it
+        // directly in the node's storage; T does not need to be default
+        // constructible.
+        struct list_node : node_base
+        {
+            T value{};
+        };
+
+        using node_traits = std::allocator_traits<node_allocator_type>;
+
+        template <typename... Args>
+        list_node* create_node(Args&&... args)
+        {
+            auto* p = node_traits::allocate(alloc_, 1);
+
+            try
+            {
+                return ::new (static_cast<void*>(p)) list_node
+                {
+                    { .prev = nullptr, .next = nullptr },
+                    T(std::forward<Args>(args)...)
+                };
+            }
+            catch (...)
             {
-                auto* new_node = new list_node{ .value = *pos, .next = nullptr };
-                last_node->next = new_node;
-                last_node = new_node;
-                ++new_node_count;
+                node_traits::deallocate(alloc_, p, 1);
+                throw;
             }
+        }
+
+        void destroy_node(list_node* n)
+        {
+            std::destroy_at(n);
+            node_traits::deallocate(alloc_, n, 1);
+        }
+
+        // links the chain [first, last] of count nodes in before pos
+        void link_before(const_iterator pos, node_base* first, node_base* last,
+            std::size_t count)
+        {
+            auto* next_node = mutable_node(pos);
+            auto* prev_node = next_node->prev;
+
+            first->prev = prev_node;
+            last->next = next_node;
+            prev_node->next = first;
+            next_node->prev = last;
 
-            // the new nodes are inserted at the front
-            if (pos == begin())
+            size_ += count;
+        }
+
+        // takes other's nodes; this list has to be empty
+        void steal_nodes(doubly_linked_list& other) noexcept
+        {
+            sentinel_ = other.sentinel_;
+            size_ = std::exchange(other.size_, 0);
+            relink_sentinel();
+            other.relink_sentinel();
+        }
+
+        // points the ends of the ring back at this list's sentinel after its
+        // links were copied from another list's sentinel
+        void relink_sentinel() noexcept
+        {
+            if (size_ == 0)
             {
-                last_node->next = head_;
-                head_ = first_node;
-                size_ += new_node_count;
-                return begin();
+                sentinel_.prev = std::addressof(sentinel_);
+                sentinel_.next = std::addressof(sentinel_);
             }
             else
             {
-                for (auto current_pos = begin(); current_pos != end();
-                    ++current_pos)
-                {
-                    // next is the insert position; insert the new nodes in between
-                    // the current and the next
-                    if (current_pos.node()->next == pos.node())
-                    {
-                        last_node->next = current_pos.node()->next;
-                        current_pos.node()->next = first_node;
-                        size_ += new_node_count;
-                        return current_pos++;
-                    }
-                }
+                sentinel_.next->prev = std::addressof(sentinel_);
+                sentinel_.prev->next = std::addressof(sentinel_);
             }
-            #endif
+        }
 
-            // should never happen
-            return end();
+        // detaches the nodes from the sentinel as a null terminated chain
+        // linked through next alone; size_ is left for the caller to settle
+        node_base* unlink_all() noexcept
+        {
+            if (sentinel_.next == std::addressof(sentinel_))
+            {
+                return nullptr;
+            }
+
+            sentinel_.prev->next = nullptr;
+            auto* first = std::exchange(sentinel_.next, std::addressof(sentinel_));
+            sentinel_.prev = std::addressof(sentinel_);
+            return first;
         }
 
-        iterator erase(const_iterator pos)
+        // makes the null terminated chain starting at first the contents of
+        // this list, restoring every prev link
+        void link_chain(node_base* first) noexcept
         {
-            // erase the head
-            if (pos == begin())
+            node_base* last = std::addressof(sentinel_);
+
+            for (auto* n = first; n != nullptr; n = n->next)
             {
-                if (auto* old_head = head_; old_head != nullptr)
-                {
-                    head_ = old_head->next;
-                    if (head_ != nullptr)
-                    {
-                        head_->prev = nullptr;
-                    }
-                    else
-                    {
-                        tail_ = nullptr;
-                    }
+                n->prev = last;
+                last->next = n;
+                last = n;
+            }
 
-                    delete old_head;
-                }
+            last->next = std::addressof(sentinel_);
+            sentinel_.prev = last;
+        }
 
-                --size_;
-                return begin();
+        void destroy_chain(node_base* first)
+        {
+            while (first != nullptr)
+            {
+                destroy_node(static_cast<list_node*>(std::exchange(first, first->next)));
             }
-            // erase the tail
-            else if (pos.node() == tail_)
+        }
+
+        // merges the sorted chains lhs and rhs, taking them over. If comp
+        // throws, every node of both is left in one chain in lhs.
+        template <typename Compare>
+        static node_base* merge_nodes(node_base*& lhs, node_base*& rhs, Compare& comp)
+        {
+            node_base merged{ };
+            node_base* last = std::addressof(merged);
+
+            try
             {
-                if (auto* old_tail = tail_; old_tail != nullptr)
+                while (lhs != nullptr && rhs != nullptr)
                 {
-                    tail_ = old_tail->prev;
-                    if (tail_ != nullptr)
+                    if (comp(value_of(rhs), value_of(lhs)))
                     {
-                        tail_->next = nullptr;
+                        last->next = rhs;
+                        rhs = rhs->next;
                     }
                     else
                     {
-                        head_ = nullptr;
+                        last->next = lhs;
+                        lhs = lhs->next;
                     }
-
-                    delete old_tail;
+                    last = last->next;
                 }
-
-                --size_;
-                return rbegin().base();
             }
-            else
+            catch (...)
             {
-                for (auto current_pos = begin(); current_pos != end();
-                    ++current_pos)
-                {
-                    // found the erase position
-                    if (current_pos == pos)
-                    {
-                        auto* current_node = current_pos.node();
-                        auto* prev_node = current_node->prev;
-                        auto* next_node = current_node->next;
-
-                        if (prev_node != nullptr)
-                        {
-                            prev_node->next = next_node;
-                        }
-                        if (next_node != nullptr)
-                        {
-                            next_node->prev = prev_node;
-                        }
-
-                        delete current_node;
-
-                        --size_;
-                        return iterator{ next_node, this};
-                    }
-                }
+                last->next = concatenate(lhs, rhs);
+                lhs = merged.next;
+                rhs = nullptr;
+                throw;
             }
 
-            return end();
+            last->next = (lhs != nullptr) ? lhs : rhs;
+            lhs = nullptr;
+            rhs = nullptr;
+            return merged.next;
         }
 
-        void push_back(int value)
+        // joins two null terminated chains, either of which may be empty
+        static node_base* concatenate(node_base* first, node_base* second) noexcept
         {
-            insert(end(), value);
+            if (first == nullptr)
+            {
+                return second;
+            }
+
+            auto* last = first;
+            while (last->next != nullptr)
+            {
+                last = last->next;
+            }
+            last->next = second;
+            return first;
         }
 
-        void push_front(int value)
+        static T& value_of(node_base* n)
         {
-            insert(begin(), value);
+            return static_cast<list_node*>(n)->value;
         }
 
-    private:
-        struct list_node
+        // const_iterators only refer to nodes owned by this list, so it is
+        // safe to hand out a mutable pointer to the node
+        static node_base* mutable_node(const_iterator pos)
         {
-            int value{ 0 };
-            list_node* prev{ nullptr };
-            list_node* next{ nullptr };
-        };
+            return const_cast<node_base*>(pos.node());
+        }
 
-        list_node* head_{ nullptr };
-        list_node* tail_{ nullptr };
+        node_base sentinel_{ std::addressof(sentinel_), std::addressof(sentinel_) };
         std::size_t size_{ 0 };
+        [[no_unique_address]] node_allocator_type alloc_{ };
     };
 
-    export bool operator==(const doubly_linked_list& lhs, const doubly_linked_list& rhs)
+    export template <typename T, typename Allocator>
+    bool operator==(const doubly_linked_list<T, Allocator>& lhs,
+        const doubly_linked_list<T, Allocator>& rhs)
     {
         return std::ranges::equal(lhs, rhs);
     }
 
-    export auto operator<=>(const doubly_linked_list& lhs, const doubly_linked_list& rhs)
+    export template <typename T, typename Allocator>
+    auto operator<=>(const doubly_linked_list<T, Allocator>& lhs,
+        const doubly_linked_list<T, Allocator>& rhs)
     {
         return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(),
             rhs.begin(), rhs.end());
     }
 }
 
-export template <>
-struct std::formatter<caff::doubly_linked_list>
+export template <typename T, typename Allocator>
+struct std::formatter<caff::doubly_linked_list<T, Allocator>>
 {
     template <typename ParseContext>
     constexpr auto parse(ParseContext& ctx)
@@ -537,7 +988,7 @@ struct std::formatter<caff::doubly_linked_list>
     }
 
     template <typename FormatContext>
-    auto format(const caff::doubly_linked_list& list, FormatContext& ctx) const
+    auto format(const caff::doubly_linked_list<T, Allocator>& list, FormatContext& ctx) const
     {
         // TODO: Use range formatter?
         auto out = ctx.out();
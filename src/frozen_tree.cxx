@@ -0,0 +1,406 @@
+export module data_structures:frozen_tree;
+
+import std;
+import :binary_tree;
+import :prefetch;
+
+namespace caff
+{
+    // hands out storage aligned to a cache line, so that the slots a search
+    // prefetches together share one
+    template <typename T>
+    struct cache_aligned_allocator
+    {
+        using value_type = T;
+
+        static constexpr std::size_t alignment{ std::max(cache_line_bytes, alignof(T)) };
+
+        cache_aligned_allocator() = default;
+
+        template <typename U>
+        cache_aligned_allocator(const cache_aligned_allocator<U>&) noexcept
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{ alignment }));
+        }
+
+        void deallocate(T* p, std::size_t) noexcept
+        {
+            ::operator delete(p, std::align_val_t{ alignment });
+        }
+
+        template <typename U>
+        bool operator==(const cache_aligned_allocator<U>&) const noexcept
+        {
+            return true;
+        }
+    };
+
+    // A read-only ordered set, built once and laid out for lookups. The
+    // values sit in one array in Eytzinger order, the order a breadth-first
+    // walk visits a complete binary search tree: the children of slot k are
+    // slots 2k and 2k + 1. A search is a loop of one comparison and one
+    // shift-and-add per level, with no branch to mispredict, and since the
+    // descendants four levels down of a slot holding ints fill one cache
+    // line, that line is prefetched while the search is still above it. Deep
+    // searches then wait on memory once every few levels rather than at every
+    // node, as they do in a binary_tree.
+    //
+    // Ref: Khuong and Morin, "Array Layouts for Comparison-Based Searching"
+    // (2017).
+    //
+    // NOTE: Build it from a binary_tree, or any other range. Unsorted values
+    // are sorted first, and equal values are all kept. Pass the comparator of
+    // a tree that does not use the default one.
+    export template <typename T, typename Compare = std::less<T>>
+    class frozen_tree
+    {
+    public:
+        using key_type = T;
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using key_compare = Compare;
+        using value_compare = Compare;
+        using const_reference = const value_type&;
+        using const_pointer = const value_type*;
+
+        // walks the values in sorted order, which hops around the array
+        class const_iterator
+        {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = T;
+            using pointer = const value_type*;
+            using reference = const value_type&;
+
+            const_iterator() = default;
+
+            reference operator*() const
+            {
+                return tree_->slots_[slot_];
+            }
+
+            pointer operator->() const
+            {
+                return std::addressof(tree_->slots_[slot_]);
+            }
+
+            const_iterator& operator++()
+            {
+                slot_ = tree_->next_slot(slot_);
+                return *this;
+            }
+
+            const_iterator operator++(int)
+            {
+                auto tmp = *this;
+                ++(*this);
+                return tmp;
+            }
+
+            const_iterator& operator--()
+            {
+                slot_ = tree_->previous_slot(slot_);
+                return *this;
+            }
+
+            const_iterator operator--(int)
+            {
+                auto tmp = *this;
+                --(*this);
+                return tmp;
+            }
+
+            bool operator==(const const_iterator& rhs) const
+            {
+                return slot_ == rhs.slot_;
+            }
+
+        private:
+            friend class frozen_tree;
+
+            const_iterator(const frozen_tree* tree, size_type slot)
+                : tree_{ tree }, slot_{ slot }
+            {
+            }
+
+            const frozen_tree* tree_{ nullptr };
+
+            // 0 is the end
+            size_type slot_{ 0 };
+        };
+
+        using iterator = const_iterator;
+
+        frozen_tree() = default;
+
+        template <std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+        explicit frozen_tree(R&& values, const Compare& compare = Compare{})
+            : compare_{ compare }
+        {
+            std::vector<T> sorted;
+            for (auto&& value : values)
+            {
+                sorted.push_back(std::forward<decltype(value)>(value));
+            }
+
+            if (!std::ranges::is_sorted(sorted, compare_))
+            {
+                std::ranges::stable_sort(sorted, compare_);
+            }
+
+            if (sorted.empty())
+            {
+                return;
+            }
+
+            // slot 0 is never searched, it only makes the arithmetic 1-based
+            size_ = sorted.size();
+            slots_.assign(size_ + 1, sorted.front());
+
+            // an in-order walk of the implicit tree hands out the values in
+            // sorted order
+            auto slot = first_slot();
+            for (auto& value : sorted)
+            {
+                slots_[slot] = std::move(value);
+                slot = next_slot(slot);
+            }
+        }
+
+        frozen_tree(std::initializer_list<T> values, const Compare& compare = Compare{})
+            : frozen_tree(std::views::all(values), compare)
+        {
+        }
+
+        const_iterator begin() const
+        {
+            return { this, first_slot() };
+        }
+
+        const_iterator end() const
+        {
+            return { this, 0 };
+        }
+
+        bool empty() const
+        {
+            return size_ == 0;
+        }
+
+        size_type size() const
+        {
+            return size_;
+        }
+
+        key_compare key_comp() const
+        {
+            return compare_;
+        }
+
+        value_compare value_comp() const
+        {
+            return compare_;
+        }
+
+        auto in_order() const
+        {
+            return std::ranges::subrange(begin(), end());
+        }
+
+        // the first value equivalent to key, or end()
+        const_iterator find(const T& key) const
+        {
+            return { this, find_slot(key) };
+        }
+
+        template <typename K>
+        requires transparent_compare<Compare>
+        const_iterator find(const K& key) const
+        {
+            return { this, find_slot(key) };
+        }
+
+        bool contains(const T& key) const
+        {
+            return find_slot(key) != 0;
+        }
+
+        template <typename K>
+        requires transparent_compare<Compare>
+        bool contains(const K& key) const
+        {
+            return find_slot(key) != 0;
+        }
+
+        // the first value not ordered before key
+        const_iterator lower_bound(const T& key) const
+        {
+            return { this, lower_bound_slot(key) };
+        }
+
+        template <typename K>
+        requires transparent_compare<Compare>
+        const_iterator lower_bound(const K& key) const
+        {
+            return { this, lower_bound_slot(key) };
+        }
+
+        // the first value ordered after key
+        const_iterator upper_bound(const T& key) const
+        {
+            return { this, upper_bound_slot(key) };
+        }
+
+        template <typename K>
+        requires transparent_compare<Compare>
+        const_iterator upper_bound(const K& key) const
+        {
+            return { this, upper_bound_slot(key) };
+        }
+
+        std::pair<const_iterator, const_iterator> equal_range(const T& key) const
+        {
+            return { lower_bound(key), upper_bound(key) };
+        }
+
+        template <typename K>
+        requires transparent_compare<Compare>
+        std::pair<const_iterator, const_iterator> equal_range(const K& key) const
+        {
+            return { lower_bound(key), upper_bound(key) };
+        }
+
+    private:
+        // the slots four or so levels below slot k start at k * stride and
+        // fill a cache line
+        static constexpr size_type prefetch_stride{
+            std::bit_floor(std::max<size_type>(cache_line_bytes / sizeof(T), 1)) };
+
+        template <typename K>
+        size_type lower_bound_slot(const K& key) const
+        {
+            // go right past every value ordered before key
+            size_type k{ 1 };
+            while (k <= size_)
+            {
+                prefetch_descendants(k);
+                k = 2 * k + static_cast<size_type>(compare_(slots_[k], key));
+            }
+            return last_left_turn(k);
+        }
+
+        template <typename K>
+        size_type upper_bound_slot(const K& key) const
+        {
+            // go right past every value not ordered after key
+            size_type k{ 1 };
+            while (k <= size_)
+            {
+                prefetch_descendants(k);
+                k = 2 * k + static_cast<size_type>(!compare_(key, slots_[k]));
+            }
+            return last_left_turn(k);
+        }
+
+        template <typename K>
+        size_type find_slot(const K& key) const
+        {
+            const auto k = lower_bound_slot(key);
+            return (k != 0 && !compare_(key, slots_[k])) ? k : 0;
+        }
+
+        // a search ends below a leaf, at k. The answer is the last slot it
+        // went left from: drop the trailing right turns, the 1 bits, and then
+        // that left turn. All right turns leave 0, the end.
+        static size_type last_left_turn(size_type k)
+        {
+            return k >> (std::countr_one(k) + 1);
+        }
+
+        // prefetch never faults, so the address may be past the end; it is
+        // worked out as an integer so that forming it is not undefined
+        void prefetch_descendants(size_type k) const
+        {
+            const auto address = reinterpret_cast<std::uintptr_t>(slots_.data()) +
+                k * prefetch_stride * sizeof(T);
+            prefetch(reinterpret_cast<const void*>(address));
+        }
+
+        size_type first_slot() const
+        {
+            if (size_ == 0)
+            {
+                return 0;
+            }
+
+            size_type k{ 1 };
+            while (2 * k <= size_)
+            {
+                k = 2 * k;
+            }
+            return k;
+        }
+
+        size_type next_slot(size_type k) const
+        {
+            if (2 * k + 1 <= size_)
+            {
+                // the leftmost slot of the right subtree
+                k = 2 * k + 1;
+                while (2 * k <= size_)
+                {
+                    k = 2 * k;
+                }
+                return k;
+            }
+
+            // climb out of every subtree k was the last slot of
+            return last_left_turn(k);
+        }
+
+        size_type previous_slot(size_type k) const
+        {
+            if (k == 0)
+            {
+                // back from the end: the rightmost slot
+                k = 1;
+                while (2 * k + 1 <= size_)
+                {
+                    k = 2 * k + 1;
+                }
+                return k;
+            }
+
+            if (2 * k <= size_)
+            {
+                // the rightmost slot of the left subtree
+                k = 2 * k;
+                while (2 * k + 1 <= size_)
+                {
+                    k = 2 * k + 1;
+                }
+                return k;
+            }
+
+            // climb out of every subtree k was the first slot of
+            return k >> (std::countr_zero(k) + 1);
+        }
+
+        [[no_unique_address]] Compare compare_{};
+        std::vector<T, cache_aligned_allocator<T>> slots_;
+        size_type size_{ 0 };
+    };
+
+    // the range constructor cannot deduce the value type on its own
+    template <std::ranges::input_range R,
+        typename Compare = std::less<std::ranges::range_value_t<R>>>
+    frozen_tree(R&&, Compare = Compare{})
+        -> frozen_tree<std::ranges::range_value_t<R>, Compare>;
+}
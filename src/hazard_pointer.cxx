@@ -0,0 +1,284 @@
+export module data_structures:hazard_pointer;
+
+import std;
+
+namespace caff
+{
+    // A published hazard: while pointer holds an address, no thread may free
+    // the object at that address. Records are never freed; a record whose
+    // owner releases it is recycled by the next thread that needs one.
+    struct hazard_record
+    {
+        std::atomic<const void*> pointer{ nullptr };
+        std::atomic<bool> active{ false };
+        hazard_record* next{ nullptr };
+    };
+
+    struct retired_object
+    {
+        void* pointer{ nullptr };
+        void (*deleter)(void*){ nullptr };
+    };
+
+    // The process-wide set of hazard records, plus the objects retired by
+    // threads that exited before they could be freed.
+    class hazard_domain
+    {
+    public:
+        static hazard_domain& instance()
+        {
+            static hazard_domain domain;
+            return domain;
+        }
+
+        hazard_domain(const hazard_domain&) = delete;
+        hazard_domain& operator=(const hazard_domain&) = delete;
+
+        ~hazard_domain()
+        {
+            // no other threads can be running during static destruction
+            for (const auto& retired : orphans_)
+            {
+                retired.deleter(retired.pointer);
+            }
+
+            auto* record = records_.load();
+            while (record != nullptr)
+            {
+                delete std::exchange(record, record->next);
+            }
+        }
+
+        hazard_record* acquire()
+        {
+            for (auto* record = records_.load(); record != nullptr;
+                record = record->next)
+            {
+                bool expected{ false };
+                if (!record->active.load(std::memory_order_relaxed) &&
+                    record->active.compare_exchange_strong(expected, true))
+                {
+                    return record;
+                }
+            }
+
+            auto* record = new hazard_record{ };
+            record->active.store(true, std::memory_order_relaxed);
+            record->next = records_.load();
+            while (!records_.compare_exchange_weak(record->next, record))
+            {
+            }
+
+            record_count_.fetch_add(1, std::memory_order_relaxed);
+            return record;
+        }
+
+        void release(hazard_record* record)
+        {
+            record->pointer.store(nullptr, std::memory_order_release);
+            record->active.store(false, std::memory_order_release);
+        }
+
+        // appends the currently protected addresses to hazards
+        void collect(std::vector<const void*>& hazards) const
+        {
+            for (auto* record = records_.load(); record != nullptr;
+                record = record->next)
+            {
+                if (const auto* p = record->pointer.load(); p != nullptr)
+                {
+                    hazards.push_back(p);
+                }
+            }
+        }
+
+        std::size_t record_count() const
+        {
+            return record_count_.load(std::memory_order_relaxed);
+        }
+
+        void add_orphans(std::vector<retired_object>& retired)
+        {
+            std::scoped_lock lock{ orphans_mutex_ };
+            orphans_.insert(orphans_.end(), retired.begin(), retired.end());
+            retired.clear();
+        }
+
+        void adopt_orphans(std::vector<retired_object>& retired)
+        {
+            if (std::unique_lock lock{ orphans_mutex_, std::try_to_lock };
+                lock.owns_lock() && !orphans_.empty())
+            {
+                retired.insert(retired.end(), orphans_.begin(), orphans_.end());
+                orphans_.clear();
+            }
+        }
+
+    private:
+        hazard_domain() = default;
+
+        std::atomic<hazard_record*> records_{ nullptr };
+        std::atomic<std::size_t> record_count_{ 0 };
+
+        std::mutex orphans_mutex_;
+        std::vector<retired_object> orphans_;
+    };
+
+    // Per-thread cache of hazard records and the list of objects this thread
+    // has retired but not yet freed. The vectors keep their capacity, so the
+    // steady state does not allocate.
+    class hazard_thread_state
+    {
+    public:
+        static hazard_thread_state& instance()
+        {
+            thread_local hazard_thread_state state;
+            return state;
+        }
+
+        hazard_thread_state(const hazard_thread_state&) = delete;
+        hazard_thread_state& operator=(const hazard_thread_state&) = delete;
+
+        ~hazard_thread_state()
+        {
+            auto& domain = hazard_domain::instance();
+
+            for (auto* record : cache_)
+            {
+                domain.release(record);
+            }
+
+            scan();
+            if (!retired_.empty())
+            {
+                domain.add_orphans(retired_);
+            }
+        }
+
+        hazard_record* acquire()
+        {
+            if (cache_.empty())
+            {
+                return hazard_domain::instance().acquire();
+            }
+
+            auto* record = cache_.back();
+            cache_.pop_back();
+            return record;
+        }
+
+        void release(hazard_record* record)
+        {
+            record->pointer.store(nullptr, std::memory_order_release);
+            cache_.push_back(record);
+        }
+
+        void retire(void* p, void (*deleter)(void*))
+        {
+            retired_.push_back({ p, deleter });
+
+            // amortize the cost of a scan over a number of retirements that
+            // grows with the number of hazards that could block them
+            if (retired_.size() >= 2 * hazard_domain::instance().record_count() + 64)
+            {
+                scan();
+            }
+        }
+
+        // frees every retired object that is not protected by a hazard
+        void scan()
+        {
+            auto& domain = hazard_domain::instance();
+            domain.adopt_orphans(retired_);
+
+            hazards_.clear();
+            domain.collect(hazards_);
+            std::ranges::sort(hazards_);
+
+            const auto [first, last] = std::ranges::remove_if(retired_,
+                [this](const retired_object& retired)
+                {
+                    if (std::ranges::binary_search(hazards_, retired.pointer))
+                    {
+                        return false;
+                    }
+
+                    retired.deleter(retired.pointer);
+                    return true;
+                });
+            retired_.erase(first, last);
+        }
+
+    private:
+        hazard_thread_state() = default;
+
+        std::vector<hazard_record*> cache_;
+        std::vector<retired_object> retired_;
+        std::vector<const void*> hazards_;
+    };
+
+    // Owns a single hazard for the lifetime of the object. An object that is
+    // protected by any hazard_pointer is not freed by hazard_retire() until
+    // the protection is reset.
+    export class hazard_pointer
+    {
+    public:
+        hazard_pointer() : record_{ hazard_thread_state::instance().acquire() }
+        {
+        }
+
+        hazard_pointer(const hazard_pointer&) = delete;
+        hazard_pointer& operator=(const hazard_pointer&) = delete;
+
+        ~hazard_pointer()
+        {
+            hazard_thread_state::instance().release(record_);
+        }
+
+        // loads src and publishes it as a hazard, retrying until src is
+        // unchanged after publication so the object cannot have been retired
+        // in between
+        template <typename Atomic>
+        auto protect(const Atomic& src)
+        {
+            auto* p = src.load(std::memory_order_relaxed);
+
+            while (true)
+            {
+                record_->pointer.store(p);
+
+                auto* current = src.load();
+                if (current == p)
+                {
+                    return p;
+                }
+                p = current;
+            }
+        }
+
+        // protects p, which the caller has to know is not yet retired
+        template <typename T>
+        void reset_protection(const T* p)
+        {
+            record_->pointer.store(p);
+        }
+
+        void reset_protection()
+        {
+            record_->pointer.store(nullptr, std::memory_order_release);
+        }
+
+    private:
+        hazard_record* record_{ nullptr };
+    };
+
+    // Frees p with delete once no hazard_pointer protects it.
+    export template <typename T>
+    void hazard_retire(T* p)
+    {
+        hazard_thread_state::instance().retire(p, [](void* q)
+        {
+            delete static_cast<T*>(q);
+        });
+    }
+}
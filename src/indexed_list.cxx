@@ -0,0 +1,799 @@
+export module data_structures:indexed_list;
+
+import std;
+
+namespace caff
+{
+    // A doubly linked list that can also find elements by position. Besides
+    // the usual prev/next ring through a sentinel, which keeps iteration O(1)
+    // per step, the nodes form an implicit treap: a binary tree whose
+    // in-order traversal is the list order, balanced by random priorities,
+    // with every node counting the nodes in its subtree. That makes nth(),
+    // index_of() and inserting or erasing at a position O(log n) expected,
+    // where a doubly_linked_list has to walk from begin().
+    //
+    // NOTE: Iterators, pointers and references stay valid until their
+    // element is erased, as in doubly_linked_list. The price is three more
+    // pointers, a count and a priority per node, and O(log n) rather than
+    // O(1) insertion and erasure.
+    //
+    // NOTE: This is not a drop-in replacement for doubly_linked_list. It
+    // covers iteration, front/back access, insert, emplace, erase, the
+    // push and pop functions, clear and swap, but has no splice, merge,
+    // sort, remove_if/erase_if or unique: relinking runs of nodes would
+    // also have to rebuild the subtree counts.
+    export template <typename T, typename Allocator = std::allocator<T>>
+    class indexed_list
+    {
+    private:
+        struct node_base;
+        struct list_node;
+
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using allocator_type = Allocator;
+
+        using node_allocator_type = typename std::allocator_traits<
+            allocator_type>::template rebind_alloc<list_node>;
+
+        indexed_list() = default;
+
+        explicit indexed_list(const allocator_type& alloc) : alloc_{ alloc }
+        {
+        }
+
+        indexed_list(std::initializer_list<T> values,
+            const allocator_type& alloc = allocator_type())
+            : alloc_{ alloc }
+        {
+            insert(end(), values.begin(), values.end());
+        }
+
+        indexed_list(const indexed_list& other)
+            : alloc_{ node_traits::select_on_container_copy_construction(
+                other.alloc_) }
+        {
+            insert(end(), other.begin(), other.end());
+        }
+
+        indexed_list(indexed_list&& other) noexcept
+            : alloc_{ std::move(other.alloc_) }
+        {
+            steal_nodes(other);
+        }
+
+        ~indexed_list()
+        {
+            clear();
+        }
+
+        indexed_list& operator=(const indexed_list& other)
+        {
+            if (this != &other)
+            {
+                clear();
+
+                if constexpr (node_traits::propagate_on_container_copy_assignment::value)
+                {
+                    alloc_ = other.alloc_;
+                }
+
+                insert(end(), other.begin(), other.end());
+            }
+
+            return *this;
+        }
+
+        indexed_list& operator=(indexed_list&& other) noexcept(
+            node_traits::propagate_on_container_move_assignment::value ||
+            node_traits::is_always_equal::value)
+        {
+            if (this != &other)
+            {
+                clear();
+
+                if constexpr (node_traits::propagate_on_container_move_assignment::value)
+                {
+                    alloc_ = std::move(other.alloc_);
+                }
+                else if (alloc_ != other.alloc_)
+                {
+                    // the nodes can't be stolen because this list can't free
+                    // them; move the elements instead
+                    insert(end(), std::make_move_iterator(other.begin()),
+                        std::make_move_iterator(other.end()));
+                    other.clear();
+                    return *this;
+                }
+
+                steal_nodes(other);
+            }
+
+            return *this;
+        }
+
+        indexed_list& operator=(std::initializer_list<T> values)
+        {
+            clear();
+            insert(end(), values.begin(), values.end());
+            return *this;
+        }
+
+        allocator_type get_allocator() const
+        {
+            return allocator_type(alloc_);
+        }
+
+        class iterator
+        {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = value_type*;
+            using reference = value_type&;
+
+            using node_pointer = node_base*;
+
+            iterator() = default;
+
+            explicit iterator(node_pointer n) : node_{ n }
+            {
+            }
+
+            bool operator==(const iterator& other) const = default;
+
+            reference operator*() const
+            {
+                return static_cast<list_node*>(node_)->value;
+            }
+
+            pointer operator->() const
+            {
+                return std::addressof(**this);
+            }
+
+            iterator& operator--()
+            {
+                node_ = node_->prev;
+                return *this;
+            }
+
+            iterator operator--(int)
+            {
+                iterator temp{ *this };
+                --(*this);
+                return temp;
+            }
+
+            iterator& operator++()
+            {
+                node_ = node_->next;
+                return *this;
+            }
+
+            iterator operator++(int)
+            {
+                iterator temp{ *this };
+                ++(*this);
+                return temp;
+            }
+
+            node_pointer node() const
+            {
+                return node_;
+            }
+
+        private:
+            node_pointer node_{ nullptr };
+        };
+
+        class const_iterator
+        {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const value_type*;
+            using reference = const value_type&;
+
+            using node_pointer = const node_base*;
+
+            const_iterator() = default;
+
+            explicit const_iterator(node_pointer n) : node_{ n }
+            {
+            }
+
+            const_iterator(const iterator& pos) : node_{ pos.node() }
+            {
+            }
+
+            bool operator==(const const_iterator& other) const = default;
+
+            reference operator*() const
+            {
+                return static_cast<const list_node*>(node_)->value;
+            }
+
+            pointer operator->() const
+            {
+                return std::addressof(**this);
+            }
+
+            const_iterator& operator--()
+            {
+                node_ = node_->prev;
+                return *this;
+            }
+
+            const_iterator operator--(int)
+            {
+                const_iterator temp{ *this };
+                --(*this);
+                return temp;
+            }
+
+            const_iterator& operator++()
+            {
+                node_ = node_->next;
+                return *this;
+            }
+
+            const_iterator operator++(int)
+            {
+                const_iterator temp{ *this };
+                ++(*this);
+                return temp;
+            }
+
+            node_pointer node() const
+            {
+                return node_;
+            }
+
+        private:
+            node_pointer node_{ nullptr };
+        };
+
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        reference front()
+        {
+            return *begin();
+        }
+
+        const_reference front() const
+        {
+            return *begin();
+        }
+
+        reference back()
+        {
+            return *std::prev(end());
+        }
+
+        const_reference back() const
+        {
+            return *std::prev(end());
+        }
+
+        // O(log n): the element at index
+        reference operator[](size_type index)
+        {
+            return *nth(index);
+        }
+
+        const_reference operator[](size_type index) const
+        {
+            return *nth(index);
+        }
+
+        iterator begin()
+        {
+            return iterator{ sentinel_.next };
+        }
+
+        iterator end()
+        {
+            return iterator{ std::addressof(sentinel_) };
+        }
+
+        const_iterator begin() const
+        {
+            return const_iterator{ sentinel_.next };
+        }
+
+        const_iterator end() const
+        {
+            return const_iterator{ std::addressof(sentinel_) };
+        }
+
+        reverse_iterator rbegin()
+        {
+            return reverse_iterator{ end() };
+        }
+
+        reverse_iterator rend()
+        {
+            return reverse_iterator{ begin() };
+        }
+
+        const_reverse_iterator rbegin() const
+        {
+            return const_reverse_iterator{ end() };
+        }
+
+        const_reverse_iterator rend() const
+        {
+            return const_reverse_iterator{ begin() };
+        }
+
+        // O(log n): an iterator to the element at index, or end() if index
+        // is size()
+        iterator nth(size_type index)
+        {
+            return iterator{ mutable_node(std::as_const(*this).nth(index)) };
+        }
+
+        const_iterator nth(size_type index) const
+        {
+            if (index >= size_)
+            {
+                return end();
+            }
+
+            const node_base* n = root_;
+            while (true)
+            {
+                const auto left_size = subtree_size(n->left);
+
+                if (index < left_size)
+                {
+                    n = n->left;
+                }
+                else if (index == left_size)
+                {
+                    return const_iterator{ n };
+                }
+                else
+                {
+                    index -= left_size + 1;
+                    n = n->right;
+                }
+            }
+        }
+
+        // O(log n): the position of pos, or size() for end()
+        size_type index_of(const_iterator pos) const
+        {
+            const node_base* n = pos.node();
+            if (n == std::addressof(sentinel_))
+            {
+                return size_;
+            }
+
+            auto index = subtree_size(n->left);
+            for (; n->parent != nullptr; n = n->parent)
+            {
+                if (n == n->parent->right)
+                {
+                    index += subtree_size(n->parent->left) + 1;
+                }
+            }
+
+            return index;
+        }
+
+        bool empty() const
+        {
+            return size_ == 0;
+        }
+
+        size_type size() const
+        {
+            return size_;
+        }
+
+        void clear()
+        {
+            auto* n = sentinel_.next;
+            while (n != std::addressof(sentinel_))
+            {
+                destroy_node(static_cast<list_node*>(std::exchange(n, n->next)));
+            }
+
+            sentinel_.prev = std::addressof(sentinel_);
+            sentinel_.next = std::addressof(sentinel_);
+            root_ = nullptr;
+            size_ = 0;
+        }
+
+        iterator insert(const_iterator pos, const T& value)
+        {
+            return emplace(pos, value);
+        }
+
+        iterator insert(const_iterator pos, T&& value)
+        {
+            return emplace(pos, std::move(value));
+        }
+
+        // O(log n) expected
+        template <typename... Args>
+        requires (std::constructible_from<T, Args...>)
+        iterator emplace(const_iterator pos, Args&&... args)
+        {
+            node_base* new_node = create_node(std::forward<Args>(args)...);
+            link_before(mutable_node(pos), new_node);
+            return iterator{ new_node };
+        }
+
+        // inserts the elements of [first, last) before pos; if constructing
+        // one of them throws, the ones already inserted are erased again
+        template <std::input_iterator InputIt>
+        requires (std::constructible_from<T, std::iter_reference_t<InputIt>>)
+        iterator insert(const_iterator pos, InputIt first, InputIt last)
+        {
+            auto result = iterator{ mutable_node(pos) };
+            if (first == last)
+            {
+                return result;
+            }
+
+            result = emplace(pos, *first);
+
+            try
+            {
+                for (++first; first != last; ++first)
+                {
+                    emplace(pos, *first);
+                }
+            }
+            catch (...)
+            {
+                erase(result, pos);
+                throw;
+            }
+
+            return result;
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<T> values)
+        {
+            return insert(pos, values.begin(), values.end());
+        }
+
+        // O(log n) expected
+        iterator erase(const_iterator pos)
+        {
+            auto* erased_node = mutable_node(pos);
+            auto* next_node = erased_node->next;
+
+            unlink(erased_node);
+            destroy_node(static_cast<list_node*>(erased_node));
+            return iterator{ next_node };
+        }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            while (first != last)
+            {
+                first = erase(first);
+            }
+
+            return iterator{ mutable_node(last) };
+        }
+
+        void push_back(const T& value)
+        {
+            emplace(end(), value);
+        }
+
+        void push_back(T&& value)
+        {
+            emplace(end(), std::move(value));
+        }
+
+        void push_front(const T& value)
+        {
+            emplace(begin(), value);
+        }
+
+        void push_front(T&& value)
+        {
+            emplace(begin(), std::move(value));
+        }
+
+        template <typename... Args>
+        requires (std::constructible_from<T, Args...>)
+        reference emplace_back(Args&&... args)
+        {
+            return *emplace(end(), std::forward<Args>(args)...);
+        }
+
+        template <typename... Args>
+        requires (std::constructible_from<T, Args...>)
+        reference emplace_front(Args&&... args)
+        {
+            return *emplace(begin(), std::forward<Args>(args)...);
+        }
+
+        void pop_back()
+        {
+            erase(std::prev(end()));
+        }
+
+        void pop_front()
+        {
+            erase(begin());
+        }
+
+        void swap(indexed_list& other) noexcept
+        {
+            if constexpr (node_traits::propagate_on_container_swap::value)
+            {
+                std::ranges::swap(alloc_, other.alloc_);
+            }
+
+            std::ranges::swap(sentinel_, other.sentinel_);
+            std::ranges::swap(root_, other.root_);
+            std::ranges::swap(size_, other.size_);
+            std::ranges::swap(seed_, other.seed_);
+            relink_sentinel();
+            other.relink_sentinel();
+        }
+
+        friend void swap(indexed_list& lhs, indexed_list& rhs) noexcept
+        {
+            lhs.swap(rhs);
+        }
+
+    private:
+        // prev and next thread the elements in list order through the
+        // sentinel; parent, left and right are the treap, which the sentinel
+        // is not part of
+        struct node_base
+        {
+            node_base* prev{ nullptr };
+            node_base* next{ nullptr };
+            node_base* parent{ nullptr };
+            node_base* left{ nullptr };
+            node_base* right{ nullptr };
+            std::size_t size{ 1 };
+            std::uint32_t priority{ 0 };
+        };
+
+        // NOTE: The value is initialized from a prvalue, which constructs it
+        // directly in the node's storage; T does not need to be default
+        // constructible.
+        struct list_node : node_base
+        {
+            T value{};
+        };
+
+        using node_traits = std::allocator_traits<node_allocator_type>;
+
+        template <typename... Args>
+        list_node* create_node(Args&&... args)
+        {
+            auto* p = node_traits::allocate(alloc_, 1);
+
+            try
+            {
+                return ::new (static_cast<void*>(p)) list_node
+                {
+                    { .priority = next_priority() },
+                    T(std::forward<Args>(args)...)
+                };
+            }
+            catch (...)
+            {
+                node_traits::deallocate(alloc_, p, 1);
+                throw;
+            }
+        }
+
+        void destroy_node(list_node* n)
+        {
+            std::destroy_at(n);
+            node_traits::deallocate(alloc_, n, 1);
+        }
+
+        // xorshift32; the priorities only have to look random to the shape
+        // of the insertions
+        std::uint32_t next_priority()
+        {
+            seed_ ^= seed_ << 13;
+            seed_ ^= seed_ >> 17;
+            seed_ ^= seed_ << 5;
+            return seed_;
+        }
+
+        static size_type subtree_size(const node_base* n)
+        {
+            return (n != nullptr) ? n->size : 0;
+        }
+
+        // links n into the ring and the treap before next_node
+        void link_before(node_base* next_node, node_base* n)
+        {
+            auto* prev_node = next_node->prev;
+
+            n->prev = prev_node;
+            n->next = next_node;
+            prev_node->next = n;
+            next_node->prev = n;
+            ++size_;
+
+            // n goes in as a leaf where the in-order traversal puts it right
+            // before next_node: as next_node's left child if it has none, and
+            // otherwise as the right child of its in-order predecessor, which
+            // is prev_node and can't have a right child
+            if (root_ == nullptr)
+            {
+                root_ = n;
+                return;
+            }
+
+            if (next_node != std::addressof(sentinel_) && next_node->left == nullptr)
+            {
+                next_node->left = n;
+                n->parent = next_node;
+            }
+            else
+            {
+                prev_node->right = n;
+                n->parent = prev_node;
+            }
+
+            for (auto* p = n->parent; p != nullptr; p = p->parent)
+            {
+                ++p->size;
+            }
+
+            while (n->parent != nullptr && n->priority > n->parent->priority)
+            {
+                rotate_up(n);
+            }
+        }
+
+        // takes n out of the ring and the treap
+        void unlink(node_base* n)
+        {
+            n->prev->next = n->next;
+            n->next->prev = n->prev;
+            --size_;
+
+            // rotate n down until it has at most one child, then splice that
+            // child into its place
+            while (n->left != nullptr && n->right != nullptr)
+            {
+                rotate_up((n->left->priority > n->right->priority) ? n->left : n->right);
+            }
+
+            for (auto* p = n->parent; p != nullptr; p = p->parent)
+            {
+                --p->size;
+            }
+
+            auto* child = (n->left != nullptr) ? n->left : n->right;
+            if (child != nullptr)
+            {
+                child->parent = n->parent;
+            }
+            replace_child(n->parent, n, child);
+        }
+
+        // rotates n above its parent, keeping the in-order traversal and the
+        // subtree sizes intact
+        void rotate_up(node_base* n)
+        {
+            auto* p = n->parent;
+            auto* g = p->parent;
+
+            if (p->left == n)
+            {
+                p->left = n->right;
+                if (n->right != nullptr)
+                {
+                    n->right->parent = p;
+                }
+                n->right = p;
+            }
+            else
+            {
+                p->right = n->left;
+                if (n->left != nullptr)
+                {
+                    n->left->parent = p;
+                }
+                n->left = p;
+            }
+
+            p->parent = n;
+            n->parent = g;
+            replace_child(g, p, n);
+
+            n->size = p->size;
+            p->size = subtree_size(p->left) + subtree_size(p->right) + 1;
+        }
+
+        void replace_child(node_base* parent, node_base* old_child, node_base* new_child)
+        {
+            if (parent == nullptr)
+            {
+                root_ = new_child;
+            }
+            else if (parent->left == old_child)
+            {
+                parent->left = new_child;
+            }
+            else
+            {
+                parent->right = new_child;
+            }
+        }
+
+        // takes other's nodes; this list has to be empty
+        void steal_nodes(indexed_list& other) noexcept
+        {
+            sentinel_ = other.sentinel_;
+            root_ = std::exchange(other.root_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            relink_sentinel();
+            other.relink_sentinel();
+        }
+
+        // points the ends of the ring back at this list's sentinel after its
+        // links were copied from another list's sentinel
+        void relink_sentinel() noexcept
+        {
+            if (size_ == 0)
+            {
+                sentinel_.prev = std::addressof(sentinel_);
+                sentinel_.next = std::addressof(sentinel_);
+            }
+            else
+            {
+                sentinel_.next->prev = std::addressof(sentinel_);
+                sentinel_.prev->next = std::addressof(sentinel_);
+            }
+        }
+
+        // const_iterators only refer to nodes owned by this list, so it is
+        // safe to hand out a mutable pointer to the node
+        static node_base* mutable_node(const_iterator pos)
+        {
+            return const_cast<node_base*>(pos.node());
+        }
+
+        node_base sentinel_{ std::addressof(sentinel_), std::addressof(sentinel_) };
+        node_base* root_{ nullptr };
+        size_type size_{ 0 };
+        std::uint32_t seed_{ 0x9e3779b9 };
+        [[no_unique_address]] node_allocator_type alloc_{ };
+    };
+
+    export template <typename T, typename Allocator>
+    bool operator==(const indexed_list<T, Allocator>& lhs,
+        const indexed_list<T, Allocator>& rhs)
+    {
+        return std::ranges::equal(lhs, rhs);
+    }
+
+    export template <typename T, typename Allocator>
+    auto operator<=>(const indexed_list<T, Allocator>& lhs,
+        const indexed_list<T, Allocator>& rhs)
+    {
+        return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(),
+            rhs.begin(), rhs.end());
+    }
+}
@@ -0,0 +1,479 @@
+export module data_structures:intrusive_linked_list;
+
+import std;
+
+namespace caff
+{
+    // The link that an object embeds to be stored in an intrusive_linked_list.
+    // An object can be in one list per hook it declares.
+    export template <typename T>
+    struct intrusive_linked_list_hook
+    {
+        T* next{ nullptr };
+    };
+
+    // NOTE: The iterators hold both the hook of the current position and the
+    // object that owns it. The hook alone can't be turned back into its
+    // object portably, and before_begin() has a hook but no object.
+    export template <typename T, intrusive_linked_list_hook<T> T::* Hook>
+    struct intrusive_linked_list_iterator
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using pointer = value_type*;
+        using reference = value_type&;
+
+        using hook_pointer = intrusive_linked_list_hook<value_type>*;
+
+        intrusive_linked_list_iterator() = default;
+
+        intrusive_linked_list_iterator(hook_pointer hook, pointer value)
+            : hook_{ hook }, value_{ value }
+        {
+        }
+
+        friend bool operator==(const intrusive_linked_list_iterator& lhs,
+            const intrusive_linked_list_iterator& rhs) = default;
+
+        reference operator*() const
+        {
+            return *value_;
+        }
+
+        pointer operator->() const
+        {
+            return value_;
+        }
+
+        intrusive_linked_list_iterator& operator++()
+        {
+            if (hook_ != nullptr)
+            {
+                value_ = hook_->next;
+                hook_ = (value_ != nullptr) ? std::addressof(value_->*Hook) : nullptr;
+            }
+            return *this;
+        }
+
+        intrusive_linked_list_iterator operator++(int)
+        {
+            intrusive_linked_list_iterator tmp{ *this };
+            ++*this;
+            return tmp;
+        }
+
+        hook_pointer hook() const
+        {
+            return hook_;
+        }
+
+        pointer value() const
+        {
+            return value_;
+        }
+
+    private:
+        hook_pointer hook_{ nullptr };
+        pointer value_{ nullptr };
+    };
+
+    export template <typename T, intrusive_linked_list_hook<T> T::* Hook>
+    struct intrusive_linked_list_const_iterator
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        using hook_pointer = const intrusive_linked_list_hook<value_type>*;
+
+        intrusive_linked_list_const_iterator() = default;
+
+        intrusive_linked_list_const_iterator(hook_pointer hook, pointer value)
+            : hook_{ hook }, value_{ value }
+        {
+        }
+
+        intrusive_linked_list_const_iterator(
+            const intrusive_linked_list_iterator<value_type, Hook>& pos)
+            : hook_{ pos.hook() }, value_{ pos.value() }
+        {
+        }
+
+        friend bool operator==(const intrusive_linked_list_const_iterator& lhs,
+            const intrusive_linked_list_const_iterator& rhs) = default;
+
+        reference operator*() const
+        {
+            return *value_;
+        }
+
+        pointer operator->() const
+        {
+            return value_;
+        }
+
+        intrusive_linked_list_const_iterator& operator++()
+        {
+            if (hook_ != nullptr)
+            {
+                value_ = hook_->next;
+                hook_ = (value_ != nullptr) ? std::addressof(value_->*Hook) : nullptr;
+            }
+            return *this;
+        }
+
+        intrusive_linked_list_const_iterator operator++(int)
+        {
+            intrusive_linked_list_const_iterator tmp{ *this };
+            ++*this;
+            return tmp;
+        }
+
+        hook_pointer hook() const
+        {
+            return hook_;
+        }
+
+        pointer value() const
+        {
+            return value_;
+        }
+
+    private:
+        hook_pointer hook_{ nullptr };
+        pointer value_{ nullptr };
+    };
+
+    // A singly linked list of objects that the caller owns, linked through
+    // the intrusive_linked_list_hook member Hook. Linking and unlinking only
+    // write pointers: the list never allocates, copies or destroys elements.
+    //
+    // NOTE: An object must stay alive, and must not be linked into another
+    // list through the same hook, while it is in the list. Unlinked objects
+    // have their hook reset, so they can be inserted again.
+    export template <typename T, intrusive_linked_list_hook<T> T::* Hook>
+    class intrusive_linked_list
+    {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using iterator = intrusive_linked_list_iterator<value_type, Hook>;
+        using const_iterator = intrusive_linked_list_const_iterator<value_type, Hook>;
+        using hook_type = intrusive_linked_list_hook<value_type>;
+
+        intrusive_linked_list() = default;
+
+        intrusive_linked_list(const intrusive_linked_list&) = delete;
+        intrusive_linked_list& operator=(const intrusive_linked_list&) = delete;
+
+        intrusive_linked_list(intrusive_linked_list&& other) noexcept
+        {
+            swap(other);
+        }
+
+        intrusive_linked_list& operator=(intrusive_linked_list&& other) noexcept
+        {
+            if (this != std::addressof(other))
+            {
+                clear();
+                swap(other);
+            }
+
+            return *this;
+        }
+
+        ~intrusive_linked_list()
+        {
+            clear();
+        }
+
+        reference front()
+        {
+            return *head_.next;
+        }
+
+        const_reference front() const
+        {
+            return *head_.next;
+        }
+
+        reference back()
+        {
+            return *tail_;
+        }
+
+        const_reference back() const
+        {
+            return *tail_;
+        }
+
+        iterator before_begin()
+        {
+            return iterator{ std::addressof(head_), nullptr };
+        }
+
+        const_iterator before_begin() const
+        {
+            return const_iterator{ std::addressof(head_), nullptr };
+        }
+
+        const_iterator cbefore_begin() const
+        {
+            return before_begin();
+        }
+
+        // the last element, or before_begin() if the list is empty
+        iterator before_end()
+        {
+            return (tail_ != nullptr) ? iterator_to(*tail_) : before_begin();
+        }
+
+        const_iterator before_end() const
+        {
+            return (tail_ != nullptr) ? iterator_to(*tail_) : before_begin();
+        }
+
+        const_iterator cbefore_end() const
+        {
+            return before_end();
+        }
+
+        iterator begin()
+        {
+            return std::next(before_begin());
+        }
+
+        const_iterator begin() const
+        {
+            return std::next(before_begin());
+        }
+
+        const_iterator cbegin() const
+        {
+            return begin();
+        }
+
+        iterator end()
+        {
+            return iterator{ };
+        }
+
+        const_iterator end() const
+        {
+            return const_iterator{ };
+        }
+
+        const_iterator cend() const
+        {
+            return end();
+        }
+
+        // O(1): an iterator to value, which has to be in this list
+        iterator iterator_to(reference value)
+        {
+            return iterator{ std::addressof(value.*Hook), std::addressof(value) };
+        }
+
+        const_iterator iterator_to(const_reference value) const
+        {
+            return const_iterator{ std::addressof(value.*Hook), std::addressof(value) };
+        }
+
+        bool empty() const
+        {
+            return head_.next == nullptr;
+        }
+
+        size_type size() const
+        {
+            return size_;
+        }
+
+        // unlinks every element; O(n) because each hook is reset
+        void clear()
+        {
+            auto* current = std::exchange(head_.next, nullptr);
+            while (current != nullptr)
+            {
+                current = std::exchange((current->*Hook).next, nullptr);
+            }
+
+            tail_ = nullptr;
+            size_ = 0;
+        }
+
+        iterator insert_after(const_iterator pos, reference value)
+        {
+            auto* prev_hook = mutable_hook(pos);
+
+            (value.*Hook).next = prev_hook->next;
+            prev_hook->next = std::addressof(value);
+            ++size_;
+
+            if (pos.value() == tail_)
+            {
+                tail_ = std::addressof(value);
+            }
+
+            return iterator_to(value);
+        }
+
+        // unlinks the element after pos
+        iterator erase_after(const_iterator pos)
+        {
+            auto* prev_hook = mutable_hook(pos);
+            auto* erased = prev_hook->next;
+
+            prev_hook->next = std::exchange((erased->*Hook).next, nullptr);
+            --size_;
+
+            if (erased == tail_)
+            {
+                tail_ = mutable_value(pos);
+            }
+
+            return make_iterator(prev_hook->next);
+        }
+
+        // unlinks the elements in the range (first, last)
+        iterator erase_after(const_iterator first, const_iterator last)
+        {
+            auto* prev_hook = mutable_hook(first);
+            auto* last_value = mutable_value(last);
+
+            while (prev_hook->next != last_value)
+            {
+                auto* erased = prev_hook->next;
+                prev_hook->next = std::exchange((erased->*Hook).next, nullptr);
+                --size_;
+            }
+
+            if (last_value == nullptr)
+            {
+                tail_ = mutable_value(first);
+            }
+
+            return make_iterator(last_value);
+        }
+
+        // unlinks every element for which pred is true in a single traversal;
+        // returns the number of elements unlinked
+        template <typename UnaryPredicate>
+        size_type remove_if(UnaryPredicate pred)
+        {
+            hook_type* prev_hook = std::addressof(head_);
+            pointer prev_value{ nullptr };
+            size_type count{ 0 };
+
+            while (prev_hook->next != nullptr)
+            {
+                auto* current = prev_hook->next;
+
+                if (pred(std::as_const(*current)))
+                {
+                    prev_hook->next = std::exchange((current->*Hook).next, nullptr);
+                    ++count;
+                }
+                else
+                {
+                    prev_hook = std::addressof(current->*Hook);
+                    prev_value = current;
+                }
+            }
+
+            tail_ = prev_value;
+            size_ -= count;
+            return count;
+        }
+
+        void push_front(reference value)
+        {
+            insert_after(before_begin(), value);
+        }
+
+        void push_back(reference value)
+        {
+            insert_after(before_end(), value);
+        }
+
+        void pop_front()
+        {
+            erase_after(before_begin());
+        }
+
+        // moves all of other's elements after pos
+        void splice_after(const_iterator pos, intrusive_linked_list& other)
+        {
+            if (other.empty())
+            {
+                return;
+            }
+
+            auto* prev_hook = mutable_hook(pos);
+
+            (other.tail_->*Hook).next = prev_hook->next;
+            prev_hook->next = std::exchange(other.head_.next, nullptr);
+
+            if (pos.value() == tail_)
+            {
+                tail_ = other.tail_;
+            }
+
+            size_ += std::exchange(other.size_, 0);
+            other.tail_ = nullptr;
+        }
+
+        void splice_after(const_iterator pos, intrusive_linked_list&& other)
+        {
+            splice_after(pos, other);
+        }
+
+        void swap(intrusive_linked_list& other) noexcept
+        {
+            std::ranges::swap(head_.next, other.head_.next);
+            std::ranges::swap(tail_, other.tail_);
+            std::ranges::swap(size_, other.size_);
+        }
+
+        friend void swap(intrusive_linked_list& lhs, intrusive_linked_list& rhs) noexcept
+        {
+            lhs.swap(rhs);
+        }
+
+        friend bool operator==(const intrusive_linked_list& lhs,
+            const intrusive_linked_list& rhs) requires (std::equality_comparable<T>)
+        {
+            return std::ranges::equal(lhs, rhs);
+        }
+
+    private:
+        iterator make_iterator(pointer value)
+        {
+            return (value != nullptr) ? iterator_to(*value) : end();
+        }
+
+        // const_iterators only refer to this list's head or to elements it
+        // links, so it is safe to hand out mutable pointers
+        static hook_type* mutable_hook(const_iterator pos)
+        {
+            return const_cast<hook_type*>(pos.hook());
+        }
+
+        static pointer mutable_value(const_iterator pos)
+        {
+            return const_cast<pointer>(pos.value());
+        }
+
+        hook_type head_{ };
+        pointer tail_{ nullptr };
+        size_type size_{ 0 };
+    };
+}
@@ -1,14 +1,29 @@
 export module data_structures:linked_list;
 
 import std;
+import :prefetch;
 
 namespace caff
 {
     export template <typename T>
-    struct linked_list_node
+    struct linked_list_node;
+
+    // The link portion of a node. linked_list embeds one of these as the
+    // before_begin() sentinel so that every element, including the first, has
+    // a predecessor that can be relinked in O(1).
+    export template <typename T>
+    struct linked_list_node_base
     {
-        T value{ 0 };
-        linked_list_node* next{ nullptr };
+        linked_list_node<T>* next{ nullptr };
+    };
+
+    // NOTE: linked_list constructs nodes with aggregate initialization, so
+    // value is constructed in place from the emplace arguments and T does not
+    // need to be default constructible.
+    export template <typename T>
+    struct linked_list_node : linked_list_node_base<T>
+    {
+        T value{};
     };
 
     export template <typename T>
@@ -20,7 +35,7 @@ namespace caff
         using pointer = value_type*;
         using reference = value_type&;
 
-        using node_pointer = linked_list_node<value_type>*;
+        using node_pointer = linked_list_node_base<value_type>*;
 
         linked_list_iterator() = default;
 
@@ -33,12 +48,12 @@ namespace caff
 
         reference operator*() const
         {
-            return node_->value;
+            return static_cast<linked_list_node<value_type>*>(node_)->value;
         }
 
         pointer operator->() const
         {
-            return std::addressof(node_->value);
+            return std::addressof(**this);
         }
 
         linked_list_iterator& operator++()
@@ -75,7 +90,7 @@ namespace caff
         using pointer = const value_type*;
         using reference = const value_type&;
 
-        using node_pointer = const linked_list_node<value_type>*;
+        using node_pointer = const linked_list_node_base<value_type>*;
 
         linked_list_const_iterator() = default;
 
@@ -93,12 +108,12 @@ namespace caff
 
         reference operator*() const
         {
-            return node_->value;
+            return static_cast<const linked_list_node<value_type>*>(node_)->value;
         }
 
         pointer operator->() const
         {
-            return std::addressof(node_->value);
+            return std::addressof(**this);
         }
 
         linked_list_const_iterator& operator++()
@@ -126,14 +141,99 @@ namespace caff
         node_pointer node_{ nullptr };
     };
 
+    // Traverses like linked_list_iterator, but keeps a look-ahead cursor a
+    // fixed number of nodes ahead and prefetches each node as the cursor
+    // reaches it, so the node is likely to be cached by the time it is
+    // visited. T is const qualified for read-only traversal.
+    //
+    // NOTE: The cursor still has to chase the next pointers, but its misses
+    // overlap with the work done on the nodes behind it. Nothing is gained
+    // when the loop body is trivial or the nodes are already cached.
+    export template <typename T>
+    struct linked_list_prefetch_iterator
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = std::remove_const_t<T>;
+        using pointer = T*;
+        using reference = T&;
+
+        using node_pointer = std::conditional_t<std::is_const_v<T>,
+            const linked_list_node<value_type>*, linked_list_node<value_type>*>;
+
+        linked_list_prefetch_iterator() = default;
+
+        linked_list_prefetch_iterator(node_pointer n, std::size_t distance)
+            : node_{ n }, ahead_{ n }
+        {
+            for (; distance != 0 && ahead_ != nullptr; --distance)
+            {
+                ahead_ = ahead_->next;
+                prefetch(ahead_);
+            }
+        }
+
+        friend bool operator==(const linked_list_prefetch_iterator& lhs,
+            const linked_list_prefetch_iterator& rhs)
+        {
+            return lhs.node_ == rhs.node_;
+        }
+
+        friend bool operator==(const linked_list_prefetch_iterator& it,
+            std::default_sentinel_t)
+        {
+            return it.node_ == nullptr;
+        }
+
+        reference operator*() const
+        {
+            return node_->value;
+        }
+
+        pointer operator->() const
+        {
+            return std::addressof(**this);
+        }
+
+        linked_list_prefetch_iterator& operator++()
+        {
+            if (node_ != nullptr)
+            {
+                node_ = node_->next;
+            }
+
+            if (ahead_ != nullptr)
+            {
+                ahead_ = ahead_->next;
+                prefetch(ahead_);
+            }
+
+            return *this;
+        }
+
+        linked_list_prefetch_iterator operator++(int)
+        {
+            linked_list_prefetch_iterator tmp{ *this };
+            ++*this;
+            return tmp;
+        }
+
+    private:
+        node_pointer node_{ nullptr };
+        const linked_list_node<value_type>* ahead_{ nullptr };
+    };
+
     static_assert(std::forward_iterator<linked_list_iterator<int>>);
     static_assert(std::forward_iterator<linked_list_const_iterator<int>>);
+    static_assert(std::forward_iterator<linked_list_prefetch_iterator<int>>);
+    static_assert(std::forward_iterator<linked_list_prefetch_iterator<const int>>);
 
-    // NOTE: This is not as efficient as std::forward_list, which uses
-    // functions like before_begin() and insert_after() to help insert
-    // elements without having to traverse nodes to find the insertion
-    // point.
-    export template <typename T>
+    // NOTE: Like std::forward_list, the O(1) way to modify the list is through
+    // before_begin() and the *_after() functions. insert() and erase() are
+    // kept for convenience, but they have to traverse the nodes to find the
+    // predecessor of pos. The list also tracks its last node, so appending
+    // with push_back(), append_range() or insert(end(), ...) is O(1).
+    export template <typename T, typename Allocator = std::allocator<T>>
     class linked_list
     {
     public:
@@ -148,21 +248,44 @@ namespace caff
         using const_iterator = linked_list_const_iterator<value_type>;
         using reverse_iterator = std::reverse_iterator<iterator>;
         using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        using allocator_type = Allocator;
+        using prefetch_iterator = linked_list_prefetch_iterator<value_type>;
+        using const_prefetch_iterator = linked_list_prefetch_iterator<const value_type>;
+
+        // a distance that covers the latency of a miss for a small loop body
+        static constexpr size_type default_prefetch_distance{ 8 };
 
         using node = linked_list_node<value_type>;
+        using node_base = linked_list_node_base<value_type>;
+        using node_allocator_type = typename std::allocator_traits<
+            allocator_type>::template rebind_alloc<node>;
 
         linked_list() = default;
 
-        linked_list(std::initializer_list<T> values)
+        explicit linked_list(const allocator_type& alloc) : alloc_{ alloc }
+        {
+        }
+
+        linked_list(std::initializer_list<T> values,
+            const allocator_type& alloc = allocator_type())
+            : alloc_{ alloc }
         {
             insert(end(), values.begin(), values.end());
         }
 
         linked_list(const linked_list& other)
+            : alloc_{ node_traits::select_on_container_copy_construction(
+                other.alloc_) }
         {
             insert(end(), other.begin(), other.end());
         }
 
+        linked_list(linked_list&& other) noexcept
+            : alloc_{ std::move(other.alloc_) }
+        {
+            steal_nodes(other);
+        }
+
         ~linked_list()
         {
             clear();
@@ -173,12 +296,47 @@ namespace caff
             if (this != std::addressof(other))
             {
                 clear();
+
+                if constexpr (node_traits::propagate_on_container_copy_assignment::value)
+                {
+                    alloc_ = other.alloc_;
+                }
+
                 insert(end(), other.begin(), other.end());
             }
 
             return *this;
         }
 
+        linked_list& operator=(linked_list&& other) noexcept(
+            node_traits::propagate_on_container_move_assignment::value ||
+            node_traits::is_always_equal::value)
+        {
+            if (this != std::addressof(other))
+            {
+                clear();
+
+                if constexpr (node_traits::propagate_on_container_move_assignment::value)
+                {
+                    alloc_ = std::move(other.alloc_);
+                }
+                else if (alloc_ != other.alloc_)
+                {
+                    // the nodes can't be stolen because this list can't free
+                    // them; move the elements instead
+                    insert_after(before_begin(),
+                        std::make_move_iterator(other.begin()),
+                        std::make_move_iterator(other.end()));
+                    other.clear();
+                    return *this;
+                }
+
+                steal_nodes(other);
+            }
+
+            return *this;
+        }
+
         linked_list& operator=(std::initializer_list<T> values)
         {
             clear();
@@ -186,29 +344,76 @@ namespace caff
             return *this;
         }
 
+        allocator_type get_allocator() const
+        {
+            return allocator_type(alloc_);
+        }
+
         reference front()
         {
-            return head_->value;
+            return head_.next->value;
         }
 
         const_reference front() const
         {
-            return head_->value;
+            return head_.next->value;
+        }
+
+        reference back()
+        {
+            return static_cast<node*>(tail_)->value;
+        }
+
+        const_reference back() const
+        {
+            return static_cast<const node*>(tail_)->value;
+        }
+
+        iterator before_begin()
+        {
+            return iterator{ std::addressof(head_) };
+        }
+
+        const_iterator before_begin() const
+        {
+            return const_iterator{ std::addressof(head_) };
+        }
+
+        const_iterator cbefore_begin() const
+        {
+            return const_iterator{ std::addressof(head_) };
+        }
+
+        // the last element, or before_begin() if the list is empty; unlike
+        // end(), elements can be inserted after it
+        iterator before_end()
+        {
+            return iterator{ tail_ };
+        }
+
+        const_iterator before_end() const
+        {
+            return const_iterator{ tail_ };
+        }
+
+        const_iterator cbefore_end() const
+        {
+            return const_iterator{ tail_ };
         }
 
         iterator begin()
         {
-            return iterator{ head_ };
+            return iterator{ head_.next };
         }
 
         const_iterator begin() const
         {
-            return const_iterator{ head_ };
+            return const_iterator{ head_.next };
         }
 
         const_iterator cbegin() const
         {
-            return const_iterator{ head_ };
+            return const_iterator{ head_.next };
         }
 
         iterator end()
@@ -226,9 +431,24 @@ namespace caff
             return const_iterator{ nullptr };
         }
 
+        // the elements in order, prefetching distance nodes ahead of the
+        // traversal; intended for long scans over lists that don't fit in
+        // the cache
+        std::ranges::subrange<prefetch_iterator, std::default_sentinel_t>
+        prefetched(size_type distance = default_prefetch_distance)
+        {
+            return { prefetch_iterator{ head_.next, distance }, std::default_sentinel };
+        }
+
+        std::ranges::subrange<const_prefetch_iterator, std::default_sentinel_t>
+        prefetched(size_type distance = default_prefetch_distance) const
+        {
+            return { const_prefetch_iterator{ head_.next, distance }, std::default_sentinel };
+        }
+
         bool empty() const
         {
-            return head_ == nullptr;
+            return head_.next == nullptr;
         }
 
         std::size_t size() const
@@ -238,157 +458,587 @@ namespace caff
 
         void clear()
         {
-            auto* node = head_;
-            head_ = nullptr;
+            destroy_nodes(std::exchange(head_.next, nullptr), nullptr);
+            tail_ = std::addressof(head_);
             size_ = 0;
-            
-            while (node != nullptr)
+        }
+
+        iterator insert_after(const_iterator pos, const T& value)
+        {
+            return emplace_after(pos, value);
+        }
+
+        iterator insert_after(const_iterator pos, T&& value)
+        {
+            return emplace_after(pos, std::move(value));
+        }
+
+        template <std::input_iterator InputIt>
+        requires (std::constructible_from<T, std::iter_reference_t<InputIt>>)
+        iterator insert_after(const_iterator pos, InputIt first, InputIt last)
+        {
+            auto* prev_node = mutable_node(pos);
+
+            if (first == last)
+            {
+                return iterator{ prev_node };
+            }
+
+            // construct the new nodes, keeping track of the first, last and
+            // count; if one throws, free the ones already made
+            auto* first_node = create_node(nullptr, *first);
+            auto* last_node = first_node;
+            std::size_t new_node_count{ 1 };
+
+            try
+            {
+                for (++first; first != last; ++first)
+                {
+                    auto* new_node = create_node(nullptr, *first);
+                    last_node->next = new_node;
+                    last_node = new_node;
+                    ++new_node_count;
+                }
+            }
+            catch (...)
             {
-                auto* tmp = node;
-                node = node->next;
-                delete tmp;
+                destroy_nodes(first_node, nullptr);
+                throw;
             }
+
+            // splice the new chain in between pos and its next
+            last_node->next = prev_node->next;
+            prev_node->next = first_node;
+            size_ += new_node_count;
+
+            if (prev_node == tail_)
+            {
+                tail_ = last_node;
+            }
+            return iterator{ last_node };
         }
 
-        iterator insert(const_iterator pos, const T& value)
+        iterator insert_after(const_iterator pos, std::initializer_list<T> values)
+        {
+            return insert_after(pos, values.begin(), values.end());
+        }
+
+        template <typename... Args>
+        requires (std::constructible_from<T, Args...>)
+        iterator emplace_after(const_iterator pos, Args&&... args)
         {
-            auto* new_node = new node
+            auto* prev_node = mutable_node(pos);
+            auto* new_node = create_node(prev_node->next,
+                std::forward<Args>(args)...);
+
+            prev_node->next = new_node;
+            ++size_;
+
+            if (prev_node == tail_)
             {
-                .value = value,
-                .next = nullptr
-            };
+                tail_ = new_node;
+            }
 
-            // the new node is the new head_
-            if (pos == begin())
+            return iterator{ new_node };
+        }
+
+        iterator erase_after(const_iterator pos)
+        {
+            auto* prev_node = mutable_node(pos);
+            auto* erased_node = prev_node->next;
+
+            prev_node->next = erased_node->next;
+            destroy_node(erased_node);
+            --size_;
+
+            if (erased_node == tail_)
             {
-                new_node->next = head_;
-                head_ = new_node;
-                ++size_;
-                return begin();
+                tail_ = prev_node;
             }
-            else
+
+            return iterator{ prev_node->next };
+        }
+
+        // erases the elements in the range (first, last)
+        iterator erase_after(const_iterator first, const_iterator last)
+        {
+            auto* prev_node = mutable_node(first);
+            auto* last_node = static_cast<node*>(mutable_node(last));
+
+            size_ -= destroy_nodes(std::exchange(prev_node->next, last_node),
+                last_node);
+
+            if (last_node == nullptr)
             {
-                for (auto current_pos = begin(); current_pos != end();
-                    ++current_pos)
-                {
-                    // next is the insert position; insert the new node in between
-                    // the current and the next
-                    if (current_pos.node()->next == pos.node())
-                    {
-                        new_node->next = current_pos.node()->next;
-                        current_pos.node()->next = new_node;
-                        ++size_;
-                        return current_pos++;
-                    }
-                }
+                tail_ = prev_node;
             }
 
-            // should never happen
-            return end();
+            return iterator{ last_node };
+        }
+
+        // O(n): prefer insert_after(), which doesn't need to find the
+        // predecessor of pos
+        iterator insert(const_iterator pos, const T& value)
+        {
+            return insert_after(before(pos), value);
+        }
+
+        // O(n): prefer insert_after(), which doesn't need to find the
+        // predecessor of pos
+        iterator insert(const_iterator pos, T&& value)
+        {
+            return insert_after(before(pos), std::move(value));
         }
 
+        // O(n): prefer insert_after(), which doesn't need to find the
+        // predecessor of pos
         template <std::input_iterator InputIt>
-        requires (std::same_as<std::iter_value_t<InputIt>, T>)
+        requires (std::constructible_from<T, std::iter_reference_t<InputIt>>)
         iterator insert(const_iterator pos, InputIt first, InputIt last)
         {
-            if (first == last)
+            const auto prev_pos = before(pos);
+            insert_after(prev_pos, first, last);
+            return std::next(iterator{ mutable_node(prev_pos) });
+        }
+
+        // O(n): prefer erase_after(), which doesn't need to find the
+        // predecessor of pos
+        iterator erase(const_iterator pos)
+        {
+            return erase_after(before(pos));
+        }
+
+        // O(n): prefer erase_after(), which doesn't need to find the
+        // predecessor of first
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            return erase_after(before(first), last);
+        }
+
+        // removes every element equal to value in a single traversal; returns
+        // the number of elements removed
+        size_type remove(const T& value)
+        {
+            return remove_if([&value](const T& element)
             {
-                // TODO: use const_cast on pos.node()?
-                for (auto current_pos = begin(); current_pos != end();
-                    ++current_pos)
+                return element == value;
+            });
+        }
+
+        template <typename UnaryPredicate>
+        size_type remove_if(UnaryPredicate pred)
+        {
+            // unlink the matching nodes into a separate chain and free them
+            // all at the end, so pred (or remove's value) can safely refer to
+            // an element of the list
+            node_base removed{ };
+            node_base* removed_last = std::addressof(removed);
+            node_base* prev_node = std::addressof(head_);
+            size_type count{ 0 };
+
+            // frees what has been removed so far and fixes up tail_ and size_,
+            // whether the traversal finished or pred threw part way
+            const auto finish = [&]() noexcept
+            {
+                removed_last->next = nullptr;
+                destroy_nodes(removed.next, nullptr);
+                while (prev_node->next != nullptr)
                 {
-                    if (current_pos.node() == pos.node())
+                    prev_node = prev_node->next;
+                }
+                tail_ = prev_node;
+                size_ -= count;
+            };
+
+            try
+            {
+                while (prev_node->next != nullptr)
+                {
+                    auto* current = prev_node->next;
+
+                    if (pred(current->value))
+                    {
+                        prev_node->next = current->next;
+                        removed_last->next = current;
+                        removed_last = current;
+                        ++count;
+                    }
+                    else
                     {
-                        return iterator{ current_pos.node() };
+                        prev_node = current;
                     }
                 }
+            }
+            catch (...)
+            {
+                finish();
+                throw;
+            }
 
-                // should never happen
-                return end();
+            finish();
+            return count;
+        }
+
+        void push_front(const T& value)
+        {
+            insert_after(before_begin(), value);
+        }
+
+        void push_front(T&& value)
+        {
+            insert_after(before_begin(), std::move(value));
+        }
+
+        template <typename... Args>
+        requires (std::constructible_from<T, Args...>)
+        reference emplace_front(Args&&... args)
+        {
+            return *emplace_after(before_begin(), std::forward<Args>(args)...);
+        }
+
+        void pop_front()
+        {
+            erase_after(before_begin());
+        }
+
+        void push_back(const T& value)
+        {
+            insert_after(before_end(), value);
+        }
+
+        void push_back(T&& value)
+        {
+            insert_after(before_end(), std::move(value));
+        }
+
+        template <typename... Args>
+        requires (std::constructible_from<T, Args...>)
+        reference emplace_back(Args&&... args)
+        {
+            return *emplace_after(before_end(), std::forward<Args>(args)...);
+        }
+
+        template <std::ranges::input_range R>
+        requires (std::constructible_from<T, std::ranges::range_reference_t<R>>)
+        void append_range(R&& values)
+        {
+            for (auto&& value : values)
+            {
+                emplace_after(before_end(), std::forward<decltype(value)>(value));
+            }
+        }
+
+        void swap(linked_list& other) noexcept
+        {
+            if constexpr (node_traits::propagate_on_container_swap::value)
+            {
+                std::ranges::swap(alloc_, other.alloc_);
+            }
+
+            std::ranges::swap(head_.next, other.head_.next);
+            std::ranges::swap(tail_, other.tail_);
+            std::ranges::swap(size_, other.size_);
+
+            // an empty list's tail is its own head, which doesn't move
+            if (empty())
+            {
+                tail_ = std::addressof(head_);
+            }
+
+            if (other.empty())
+            {
+                other.tail_ = std::addressof(other.head_);
+            }
+        }
+
+        friend void swap(linked_list& lhs, linked_list& rhs) noexcept
+        {
+            lhs.swap(rhs);
+        }
+
+        // NOTE: The operations below only relink existing nodes; they never
+        // allocate, copy or move elements, and only unique() frees nodes.
+        // Splicing from another list requires that both lists use equal
+        // allocators.
+
+        // moves all of other's elements after pos
+        void splice_after(const_iterator pos, linked_list& other)
+        {
+            if (other.empty())
+            {
+                return;
+            }
+
+            auto* first_node = other.head_.next;
+            auto* last_node = static_cast<node*>(other.tail_);
+
+            auto* prev_node = mutable_node(pos);
+            last_node->next = prev_node->next;
+            prev_node->next = first_node;
+            size_ += std::exchange(other.size_, 0);
+            other.head_.next = nullptr;
+            other.tail_ = std::addressof(other.head_);
+
+            if (prev_node == tail_)
+            {
+                tail_ = last_node;
+            }
+        }
+
+        void splice_after(const_iterator pos, linked_list&& other)
+        {
+            splice_after(pos, other);
+        }
+
+        // moves the element following it from other to after pos
+        void splice_after(const_iterator pos, linked_list& other,
+            const_iterator it)
+        {
+            auto* prev_node = mutable_node(pos);
+            auto* other_prev_node = mutable_node(it);
+
+            if (prev_node == other_prev_node ||
+                prev_node == other_prev_node->next)
+            {
+                return;
             }
 
-            // construct the new nodes, keeping track of the first, last and count
-            auto* first_node = new node{ .value = *first, .next = nullptr };
+            auto* moved_node = other_prev_node->next;
+            other_prev_node->next = moved_node->next;
+            if (moved_node == other.tail_)
+            {
+                other.tail_ = other_prev_node;
+            }
+
+            moved_node->next = prev_node->next;
+            prev_node->next = moved_node;
+            if (prev_node == tail_)
+            {
+                tail_ = moved_node;
+            }
+
+            --other.size_;
+            ++size_;
+        }
+
+        void splice_after(const_iterator pos, linked_list&& other,
+            const_iterator it)
+        {
+            splice_after(pos, other, it);
+        }
+
+        // moves the elements in the range (first, last) from other to after
+        // pos; linear in the length of the range, which has to be counted
+        void splice_after(const_iterator pos, linked_list& other,
+            const_iterator first, const_iterator last)
+        {
+            auto* other_prev_node = mutable_node(first);
+            if (other_prev_node->next == last.node())
+            {
+                return;
+            }
+
+            auto* first_node = other_prev_node->next;
             auto* last_node = first_node;
-            std::size_t new_node_count{ 1 };
-            
-            for (auto pos = std::next(first); pos != last; ++pos)
+            std::size_t count{ 1 };
+
+            while (last_node->next != last.node())
             {
-                auto* new_node = new node{ .value = *pos, .next = nullptr };
-                last_node->next = new_node;
-                last_node = new_node;
-                ++new_node_count;
+                last_node = last_node->next;
+                ++count;
             }
 
-            // the new nodes are inserted at the front
-            if (pos == begin())
+            other_prev_node->next = last_node->next;
+            if (last_node == other.tail_)
             {
-                last_node->next = head_;
-                head_ = first_node;
-                size_ += new_node_count;
-                return begin();
+                other.tail_ = other_prev_node;
             }
-            else
+
+            auto* prev_node = mutable_node(pos);
+            last_node->next = prev_node->next;
+            prev_node->next = first_node;
+            if (prev_node == tail_)
             {
-                for (auto current_pos = begin(); current_pos != end();
-                    ++current_pos)
-                {
-                    // next is the insert position; insert the new nodes in between
-                    // the current and the next
-                    if (current_pos.node()->next == pos.node())
-                    {
-                        last_node->next = current_pos.node()->next;
-                        current_pos.node()->next = first_node;
-                        size_ += new_node_count;
-                        return current_pos++;
-                    }
-                }
+                tail_ = last_node;
             }
 
-            // should never happen
-            return end();
+            if (std::addressof(other) != this)
+            {
+                other.size_ -= count;
+                size_ += count;
+            }
         }
 
-        iterator erase(const_iterator pos)
+        void splice_after(const_iterator pos, linked_list&& other,
+            const_iterator first, const_iterator last)
+        {
+            splice_after(pos, other, first, last);
+        }
+
+        // merges the sorted other list into this sorted list; equivalent
+        // elements from this list precede those from other. If comp throws,
+        // this list keeps the elements of both, in no particular order, and
+        // other is left empty.
+        void merge(linked_list& other)
         {
-            // erase the head
-            if (pos == begin())
+            merge(other, std::less<>{});
+        }
+
+        void merge(linked_list&& other)
+        {
+            merge(other, std::less<>{});
+        }
+
+        template <typename Compare>
+        void merge(linked_list& other, Compare comp)
+        {
+            if (this == std::addressof(other) || other.empty())
+            {
+                return;
+            }
+
+            // the last element of the merged list is the greater of the two
+            // tails, preferring other's when they are equivalent
+            const bool other_tail_last{ empty() || !comp(other.back(), back()) };
+            auto* new_tail = other_tail_last ? other.tail_ : tail_;
+
+            auto* merged = std::exchange(head_.next, nullptr);
+            auto* other_nodes = std::exchange(other.head_.next, nullptr);
+            other.tail_ = std::addressof(other.head_);
+            size_ += std::exchange(other.size_, 0);
+
+            try
             {
-                auto* temp = head_;
-                head_ = temp->next;
-                delete temp;
-                --size_;
-                return begin();
+                merged = merge_nodes(merged, other_nodes, comp);
             }
-            else
+            catch (...)
+            {
+                link_chain(merged);
+                throw;
+            }
+
+            head_.next = merged;
+            tail_ = new_tail;
+        }
+
+        template <typename Compare>
+        void merge(linked_list&& other, Compare comp)
+        {
+            merge(other, comp);
+        }
+
+        // stable bottom-up merge sort: O(n log n) comparisons and O(1) extra
+        // space. If comp throws, the list keeps every element, in no
+        // particular order.
+        void sort()
+        {
+            sort(std::less<>{});
+        }
+
+        template <typename Compare>
+        void sort(Compare comp)
+        {
+            // runs[i] is either empty or a sorted run of 2^i nodes; runs with
+            // a higher index hold earlier elements, which keeps the sort
+            // stable
+            std::array<node*, std::numeric_limits<std::size_t>::digits> runs{};
+
+            auto* current = std::exchange(head_.next, nullptr);
+            node* carry{ nullptr };
+
+            try
             {
-                for (auto current_pos = begin(); current_pos != end();
-                    ++current_pos)
+                while (current != nullptr)
+                {
+                    carry = current;
+                    current = current->next;
+                    carry->next = nullptr;
+
+                    std::size_t i{ 0 };
+                    for (; runs[i] != nullptr; ++i)
+                    {
+                        carry = merge_nodes(runs[i], carry, comp);
+                    }
+                    runs[i] = std::exchange(carry, nullptr);
+                }
+
+                for (auto& run : runs)
                 {
-                    // next is the erase position; delete the next, then set the
-                    // current next to the next of the next
-                    if (current_pos.node()->next == pos.node())
+                    if (run != nullptr)
                     {
-                        auto* temp = current_pos.node()->next;
-                        current_pos.node()->next = temp->next;
-                        delete temp;
-                        --size_;
-                        return current_pos++;
+                        carry = merge_nodes(run, carry, comp);
                     }
                 }
             }
+            catch (...)
+            {
+                // the merge that threw left its nodes in one chain in its
+                // run, so relinking the runs, carry and the unsorted rest
+                // loses nothing
+                for (auto* run : runs)
+                {
+                    carry = concatenate(run, carry);
+                }
+                link_chain(concatenate(carry, current));
+                throw;
+            }
 
-            return end();
+            link_chain(carry);
         }
 
-        void push_front(const T& value)
+        void reverse()
+        {
+            node* reversed{ nullptr };
+            auto* current = head_.next;
+
+            if (current != nullptr)
+            {
+                tail_ = current;
+            }
+
+            while (current != nullptr)
+            {
+                auto* next = current->next;
+                current->next = reversed;
+                reversed = current;
+                current = next;
+            }
+
+            head_.next = reversed;
+        }
+
+        // removes all but the first element from every group of consecutive
+        // equivalent elements; returns the number of elements removed
+        size_type unique()
         {
-            insert(begin(), value);
+            return unique(std::equal_to<>{});
         }
 
-        void pop_front()
+        template <typename BinaryPredicate>
+        size_type unique(BinaryPredicate pred)
         {
-            erase(begin());
+            size_type removed{ 0 };
+
+            for (auto* current = head_.next; current != nullptr;
+                current = current->next)
+            {
+                while (current->next != nullptr &&
+                    pred(current->value, current->next->value))
+                {
+                    auto* duplicate = current->next;
+                    current->next = duplicate->next;
+                    destroy_node(duplicate);
+                    ++removed;
+                }
+
+                if (current->next == nullptr)
+                {
+                    tail_ = current;
+                }
+            }
+
+            size_ -= removed;
+            return removed;
         }
 
         friend bool operator==(const linked_list& lhs, const linked_list& rhs)
@@ -405,7 +1055,178 @@ namespace caff
         }
 
     private:
-        node* head_{ nullptr };
+        using node_traits = std::allocator_traits<node_allocator_type>;
+
+        // the value is initialized from a prvalue, so it is constructed
+        // directly in the node's storage without a temporary
+        template <typename... Args>
+        node* create_node(node* next, Args&&... args)
+        {
+            auto* p = node_traits::allocate(alloc_, 1);
+
+            try
+            {
+                return ::new (static_cast<void*>(p)) node
+                {
+                    { .next = next },
+                    T(std::forward<Args>(args)...)
+                };
+            }
+            catch (...)
+            {
+                node_traits::deallocate(alloc_, p, 1);
+                throw;
+            }
+        }
+
+        void destroy_node(node* n)
+        {
+            std::destroy_at(n);
+            node_traits::deallocate(alloc_, n, 1);
+        }
+
+        // frees the chain [first, last); returns the number of nodes freed
+        size_type destroy_nodes(node* first, node* last)
+        {
+            size_type count{ 0 };
+
+            while (first != last)
+            {
+                destroy_node(std::exchange(first, first->next));
+                ++count;
+            }
+
+            return count;
+        }
+
+        // merges two sorted, null terminated chains, taking them over and
+        // taking from lhs first when elements are equivalent. If comp throws,
+        // every node of both is left in one chain in lhs.
+        template <typename Compare>
+        static node* merge_nodes(node*& lhs, node*& rhs, Compare& comp)
+        {
+            node_base merged{ };
+            node_base* last = std::addressof(merged);
+
+            try
+            {
+                while (lhs != nullptr && rhs != nullptr)
+                {
+                    if (comp(rhs->value, lhs->value))
+                    {
+                        last->next = rhs;
+                        rhs = rhs->next;
+                    }
+                    else
+                    {
+                        last->next = lhs;
+                        lhs = lhs->next;
+                    }
+                    last = last->next;
+                }
+            }
+            catch (...)
+            {
+                last->next = concatenate(lhs, rhs);
+                lhs = merged.next;
+                rhs = nullptr;
+                throw;
+            }
+
+            last->next = (lhs != nullptr) ? lhs : rhs;
+            lhs = nullptr;
+            rhs = nullptr;
+            return merged.next;
+        }
+
+        // joins two null terminated chains, either of which may be empty
+        static node* concatenate(node* first, node* second) noexcept
+        {
+            if (first == nullptr)
+            {
+                return second;
+            }
+
+            auto* last = first;
+            while (last->next != nullptr)
+            {
+                last = last->next;
+            }
+            last->next = second;
+            return first;
+        }
+
+        // makes the null terminated chain starting at first the contents of
+        // this list, finding the new tail with one pass
+        void link_chain(node* first) noexcept
+        {
+            head_.next = first;
+            tail_ = std::addressof(head_);
+            while (tail_->next != nullptr)
+            {
+                tail_ = tail_->next;
+            }
+        }
+
+        // const_iterators only refer to nodes owned by this list, so it is
+        // safe to hand out a mutable pointer to the node
+        static node_base* mutable_node(const_iterator pos)
+        {
+            return const_cast<node_base*>(pos.node());
+        }
+
+        // takes other's nodes; this list has to be empty
+        void steal_nodes(linked_list& other) noexcept
+        {
+            if (other.empty())
+            {
+                return;
+            }
+
+            head_.next = std::exchange(other.head_.next, nullptr);
+            tail_ = std::exchange(other.tail_, std::addressof(other.head_));
+            size_ = std::exchange(other.size_, 0);
+        }
+
+        // finds the predecessor of pos by traversing from before_begin(),
+        // except for end(), whose predecessor is the tail
+        const_iterator before(const_iterator pos) const
+        {
+            if (pos.node() == nullptr)
+            {
+                return cbefore_end();
+            }
+
+            auto prev_pos = cbefore_begin();
+
+            while (prev_pos.node()->next != pos.node())
+            {
+                ++prev_pos;
+            }
+
+            return prev_pos;
+        }
+
+        node_base head_{ };
+        node_base* tail_{ std::addressof(head_) };
         std::size_t size_{ 0 };
+        [[no_unique_address]] node_allocator_type alloc_{ };
     };
+
+    export template <typename T, typename Allocator, typename U>
+    typename linked_list<T, Allocator>::size_type erase(
+        linked_list<T, Allocator>& list, const U& value)
+    {
+        return list.remove_if([&value](const T& element)
+        {
+            return element == value;
+        });
+    }
+
+    export template <typename T, typename Allocator, typename Predicate>
+    typename linked_list<T, Allocator>::size_type erase_if(
+        linked_list<T, Allocator>& list, Predicate pred)
+    {
+        return list.remove_if(pred);
+    }
 }
@@ -0,0 +1,166 @@
+export module data_structures:lock_free_queue;
+
+import std;
+import :hazard_pointer;
+import :linked_list;
+
+namespace caff
+{
+    // A Michael-Scott queue: a lock-free FIFO of linked_list_nodes with
+    // separate head and tail pointers. head_ always points at a dummy node
+    // whose value has already been dequeued (or, initially, at the
+    // value-less stub_), and the front of the queue is head_->next.
+    // Dequeued nodes are reclaimed through hazard pointers.
+    //
+    // NOTE: Enqueuers race on the last node's next pointer, so every access
+    // to a next pointer goes through std::atomic_ref.
+    export template <typename T>
+    class lock_free_queue
+    {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+
+        using node = linked_list_node<value_type>;
+        using node_base = linked_list_node_base<value_type>;
+
+        lock_free_queue() = default;
+
+        lock_free_queue(const lock_free_queue&) = delete;
+        lock_free_queue& operator=(const lock_free_queue&) = delete;
+
+        ~lock_free_queue()
+        {
+            auto* dummy = head_.load(std::memory_order_relaxed);
+            auto* n = next(dummy);
+
+            if (dummy != std::addressof(stub_))
+            {
+                delete static_cast<node*>(dummy);
+            }
+
+            while (n != nullptr)
+            {
+                delete std::exchange(n, next(n));
+            }
+        }
+
+        void push(const T& value)
+        {
+            emplace(value);
+        }
+
+        void push(T&& value)
+        {
+            emplace(std::move(value));
+        }
+
+        template <typename... Args>
+        requires (std::constructible_from<T, Args...>)
+        void emplace(Args&&... args)
+        {
+            auto* new_node = new node
+            {
+                { .next = nullptr },
+                T(std::forward<Args>(args)...)
+            };
+
+            hazard_pointer hp;
+
+            while (true)
+            {
+                auto* tail = hp.protect(tail_);
+                auto* tail_next = next(tail);
+
+                if (tail != tail_.load(std::memory_order_acquire))
+                {
+                    continue;
+                }
+
+                if (tail_next != nullptr)
+                {
+                    // the tail is lagging behind; help the other enqueuer
+                    tail_.compare_exchange_weak(tail, tail_next);
+                    continue;
+                }
+
+                if (std::atomic_ref{ tail->next }.compare_exchange_weak(
+                    tail_next, new_node, std::memory_order_release,
+                    std::memory_order_relaxed))
+                {
+                    tail_.compare_exchange_strong(tail, new_node);
+                    return;
+                }
+            }
+        }
+
+        std::optional<T> pop()
+        {
+            hazard_pointer hp_head;
+            hazard_pointer hp_next;
+
+            while (true)
+            {
+                auto* head = hp_head.protect(head_);
+                auto* tail = tail_.load(std::memory_order_acquire);
+                auto* head_next = next(head);
+
+                // head_next can't be retired before head_ moves past it, so
+                // it's safe to use once head_ is confirmed unchanged
+                hp_next.reset_protection(head_next);
+                if (head != head_.load())
+                {
+                    continue;
+                }
+
+                if (head_next == nullptr)
+                {
+                    return std::nullopt;
+                }
+
+                if (head == tail)
+                {
+                    // the tail is lagging behind; help the enqueuer
+                    tail_.compare_exchange_weak(tail, head_next);
+                    continue;
+                }
+
+                if (head_.compare_exchange_strong(head, head_next))
+                {
+                    // head_next is the new dummy; its value is only read here
+                    std::optional<T> value{ std::move(head_next->value) };
+
+                    hp_head.reset_protection();
+                    hp_next.reset_protection();
+
+                    if (head != std::addressof(stub_))
+                    {
+                        hazard_retire(static_cast<node*>(head));
+                    }
+
+                    return value;
+                }
+            }
+        }
+
+        // only a snapshot when other threads are modifying the queue
+        bool empty() const
+        {
+            hazard_pointer hp;
+            return next(hp.protect(head_)) == nullptr;
+        }
+
+    private:
+        static node* next(const node_base* n)
+        {
+            return std::atomic_ref{ const_cast<node_base*>(n)->next }.load(
+                std::memory_order_acquire);
+        }
+
+        node_base stub_{ };
+        std::atomic<node_base*> head_{ std::addressof(stub_) };
+        std::atomic<node_base*> tail_{ std::addressof(stub_) };
+    };
+}
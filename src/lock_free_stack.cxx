@@ -0,0 +1,99 @@
+export module data_structures:lock_free_stack;
+
+import std;
+import :hazard_pointer;
+import :linked_list;
+
+namespace caff
+{
+    // A Treiber stack: a lock-free LIFO of linked_list_nodes whose top is
+    // swung with compare-and-swap. Popped nodes are reclaimed through hazard
+    // pointers, which also rules out ABA on the top pointer.
+    //
+    // NOTE: A node's next pointer is only written before the node is
+    // published, so it can stay a plain linked_list_node member.
+    export template <typename T>
+    class lock_free_stack
+    {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+
+        using node = linked_list_node<value_type>;
+
+        lock_free_stack() = default;
+
+        lock_free_stack(const lock_free_stack&) = delete;
+        lock_free_stack& operator=(const lock_free_stack&) = delete;
+
+        ~lock_free_stack()
+        {
+            auto* n = top_.load(std::memory_order_relaxed);
+            while (n != nullptr)
+            {
+                delete std::exchange(n, n->next);
+            }
+        }
+
+        void push(const T& value)
+        {
+            emplace(value);
+        }
+
+        void push(T&& value)
+        {
+            emplace(std::move(value));
+        }
+
+        template <typename... Args>
+        requires (std::constructible_from<T, Args...>)
+        void emplace(Args&&... args)
+        {
+            auto* new_node = new node
+            {
+                { .next = top_.load(std::memory_order_relaxed) },
+                T(std::forward<Args>(args)...)
+            };
+
+            while (!top_.compare_exchange_weak(new_node->next, new_node,
+                std::memory_order_release, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        std::optional<T> pop()
+        {
+            hazard_pointer hp;
+            node* top{ nullptr };
+
+            do
+            {
+                top = hp.protect(top_);
+                if (top == nullptr)
+                {
+                    return std::nullopt;
+                }
+            }
+            while (!top_.compare_exchange_weak(top, top->next,
+                std::memory_order_acquire, std::memory_order_relaxed));
+
+            // only this thread can reach the popped value now; other threads
+            // may still be reading top->next, so the node has to be retired
+            std::optional<T> value{ std::move(top->value) };
+            hp.reset_protection();
+            hazard_retire(top);
+            return value;
+        }
+
+        // only a snapshot when other threads are modifying the stack
+        bool empty() const
+        {
+            return top_.load(std::memory_order_acquire) == nullptr;
+        }
+
+    private:
+        std::atomic<node*> top_{ nullptr };
+    };
+}
@@ -0,0 +1,640 @@
+export module data_structures:lru_cache;
+
+import std;
+import :doubly_linked_list;
+
+namespace caff
+{
+    export template <typename K, typename V>
+    struct cache_entry
+    {
+        K key;
+        V value;
+    };
+
+    // Counters kept by lru_cache and lfu_cache. Rates are computed over the
+    // time since the counters were last reset.
+    export struct cache_stats
+    {
+        std::uint64_t hits{ 0 };
+        std::uint64_t misses{ 0 };
+        std::uint64_t insertions{ 0 };
+        std::uint64_t updates{ 0 };
+        std::uint64_t evictions{ 0 };
+        std::chrono::steady_clock::time_point since{ std::chrono::steady_clock::now() };
+
+        std::uint64_t operations() const
+        {
+            return hits + misses + insertions + updates;
+        }
+
+        double hit_rate() const
+        {
+            const auto lookups = hits + misses;
+            return (lookups == 0) ? 0.0 :
+                static_cast<double>(hits) / static_cast<double>(lookups);
+        }
+
+        double ops_per_second(std::chrono::steady_clock::time_point now =
+            std::chrono::steady_clock::now()) const
+        {
+            const std::chrono::duration<double> elapsed = now - since;
+            return (elapsed.count() <= 0.0) ? 0.0 :
+                static_cast<double>(operations()) / elapsed.count();
+        }
+    };
+
+    // An open addressing hash index from keys to the list iterators of the
+    // entries that hold them, with linear probing. The table is sized once
+    // for the cache's capacity, so it never allocates afterwards. Erasing
+    // shifts the following entries back instead of leaving tombstones, which
+    // keeps probe sequences short under constant churn.
+    //
+    // NOTE: Iterator has to point at something with a key member, and a
+    // value initialized Iterator marks an empty slot.
+    template <typename Iterator, typename Hash, typename KeyEqual,
+        typename Allocator>
+    class cache_index
+    {
+    public:
+        cache_index(std::size_t capacity, const Hash& hash,
+            const KeyEqual& equal, const Allocator& alloc)
+            : slots_(std::bit_ceil(std::max<std::size_t>(2 * capacity, 8)),
+                slot_allocator_type(alloc)),
+              mask_{ slots_.size() - 1 },
+              hash_{ hash },
+              equal_{ equal }
+        {
+        }
+
+        template <typename Key>
+        const Iterator* find(const Key& key) const
+        {
+            const auto i = find_slot(key);
+            return (i == npos) ? nullptr : std::addressof(slots_[i].pos);
+        }
+
+        // pos's key must not already be in the index
+        void insert(Iterator pos)
+        {
+            const auto hash = hash_(pos->key);
+
+            auto i = hash & mask_;
+            while (slots_[i].pos != Iterator{ })
+            {
+                i = (i + 1) & mask_;
+            }
+
+            slots_[i] = { hash, pos };
+        }
+
+        template <typename Key>
+        void erase(const Key& key)
+        {
+            auto i = find_slot(key);
+            if (i == npos)
+            {
+                return;
+            }
+
+            // move back every following entry in the probe run that would
+            // otherwise become unreachable through the hole at i
+            for (auto j = (i + 1) & mask_; slots_[j].pos != Iterator{ };
+                j = (j + 1) & mask_)
+            {
+                const auto home = slots_[j].hash & mask_;
+                const bool reachable = (i <= j) ?
+                    (i < home && home <= j) :
+                    (i < home || home <= j);
+
+                if (!reachable)
+                {
+                    slots_[i] = slots_[j];
+                    i = j;
+                }
+            }
+
+            slots_[i] = { };
+        }
+
+        void clear()
+        {
+            std::ranges::fill(slots_, slot{ });
+        }
+
+    private:
+        struct slot
+        {
+            std::size_t hash{ 0 };
+            Iterator pos{ };
+        };
+
+        using slot_allocator_type = typename std::allocator_traits<
+            Allocator>::template rebind_alloc<slot>;
+
+        static constexpr std::size_t npos{ std::numeric_limits<std::size_t>::max() };
+
+        template <typename Key>
+        std::size_t find_slot(const Key& key) const
+        {
+            const auto hash = hash_(key);
+
+            for (auto i = hash & mask_; slots_[i].pos != Iterator{ };
+                i = (i + 1) & mask_)
+            {
+                if (slots_[i].hash == hash && equal_(slots_[i].pos->key, key))
+                {
+                    return i;
+                }
+            }
+
+            return npos;
+        }
+
+        std::vector<slot, slot_allocator_type> slots_;
+        std::size_t mask_{ 0 };
+        [[no_unique_address]] Hash hash_;
+        [[no_unique_address]] KeyEqual equal_;
+    };
+
+    // A fixed capacity cache that evicts the least recently used entry. The
+    // entries are kept in a doubly_linked_list from most to least recently
+    // used, and a hash index maps each key to its list node, so get, put,
+    // touch and erase are O(1). A hit splices the node to the front, and an
+    // insertion into a full cache reuses the evicted entry's node, so once
+    // the cache is full nothing is allocated.
+    //
+    // NOTE: Caches are neither copyable nor movable, because the index holds
+    // iterators into the list.
+    export template <typename K, typename V, typename Hash = std::hash<K>,
+        typename KeyEqual = std::equal_to<K>,
+        typename Allocator = std::allocator<cache_entry<K, V>>>
+    class lru_cache
+    {
+    public:
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = cache_entry<K, V>;
+        using size_type = std::size_t;
+        using hasher = Hash;
+        using key_equal = KeyEqual;
+        using allocator_type = Allocator;
+
+        using list_type = doubly_linked_list<value_type, typename std::allocator_traits<
+            allocator_type>::template rebind_alloc<value_type>>;
+        using const_iterator = typename list_type::const_iterator;
+
+        explicit lru_cache(size_type capacity, const Hash& hash = Hash(),
+            const KeyEqual& equal = KeyEqual(),
+            const Allocator& alloc = Allocator())
+            : entries_(typename list_type::allocator_type(alloc)),
+              index_{ capacity, hash, equal, alloc },
+              capacity_{ capacity }
+        {
+            if (capacity == 0)
+            {
+                throw std::invalid_argument{ "lru_cache capacity must be positive" };
+            }
+        }
+
+        lru_cache(const lru_cache&) = delete;
+        lru_cache& operator=(const lru_cache&) = delete;
+
+        // the value for key, marking it as most recently used, or null if
+        // key is not cached
+        V* get(const K& key)
+        {
+            const auto* pos = index_.find(key);
+            if (pos == nullptr)
+            {
+                ++stats_.misses;
+                return nullptr;
+            }
+
+            ++stats_.hits;
+            entries_.splice(entries_.begin(), entries_, *pos);
+            return std::addressof((*pos)->value);
+        }
+
+        // like get(), but without changing the recency or the counters
+        const V* peek(const K& key) const
+        {
+            const auto* pos = index_.find(key);
+            return (pos == nullptr) ? nullptr : std::addressof((*pos)->value);
+        }
+
+        bool contains(const K& key) const
+        {
+            return index_.find(key) != nullptr;
+        }
+
+        // marks key as most recently used; returns false if it isn't cached
+        bool touch(const K& key)
+        {
+            const auto* pos = index_.find(key);
+            if (pos == nullptr)
+            {
+                return false;
+            }
+
+            entries_.splice(entries_.begin(), entries_, *pos);
+            return true;
+        }
+
+        // inserts or assigns the value for key and marks it as most recently
+        // used, evicting the least recently used entry if the cache is full;
+        // returns true if key was inserted
+        bool put(const K& key, V value)
+        {
+            if (const auto* pos = index_.find(key); pos != nullptr)
+            {
+                (*pos)->value = std::move(value);
+                entries_.splice(entries_.begin(), entries_, *pos);
+                ++stats_.updates;
+                return false;
+            }
+
+            if (entries_.size() == capacity_)
+            {
+                auto victim = std::prev(entries_.end());
+                index_.erase(victim->key);
+
+                try
+                {
+                    victim->key = key;
+                    victim->value = std::move(value);
+                }
+                catch (...)
+                {
+                    entries_.erase(victim);
+                    throw;
+                }
+
+                entries_.splice(entries_.begin(), entries_, victim);
+                ++stats_.evictions;
+            }
+            else
+            {
+                entries_.emplace_front(key, std::move(value));
+            }
+
+            index_.insert(entries_.begin());
+            ++stats_.insertions;
+            return true;
+        }
+
+        bool erase(const K& key)
+        {
+            const auto* pos = index_.find(key);
+            if (pos == nullptr)
+            {
+                return false;
+            }
+
+            const auto erased = *pos;
+            index_.erase(key);
+            entries_.erase(erased);
+            return true;
+        }
+
+        void clear()
+        {
+            index_.clear();
+            entries_.clear();
+        }
+
+        bool empty() const
+        {
+            return entries_.empty();
+        }
+
+        size_type size() const
+        {
+            return entries_.size();
+        }
+
+        size_type capacity() const
+        {
+            return capacity_;
+        }
+
+        // the entries from most to least recently used
+        const_iterator begin() const
+        {
+            return entries_.begin();
+        }
+
+        const_iterator end() const
+        {
+            return entries_.end();
+        }
+
+        const cache_stats& stats() const
+        {
+            return stats_;
+        }
+
+        void reset_stats()
+        {
+            stats_ = { };
+        }
+
+    private:
+        list_type entries_;
+        cache_index<typename list_type::iterator, Hash, KeyEqual, Allocator> index_;
+        size_type capacity_{ 0 };
+        cache_stats stats_{ };
+    };
+
+    // A fixed capacity cache that evicts the least frequently used entry,
+    // breaking ties by evicting the least recently used one. Entries with
+    // the same use count share a bucket, and the buckets are kept in
+    // increasing order of count, so an entry moves to the next bucket on
+    // each use and the victim is the oldest entry of the first bucket. All
+    // operations are O(1).
+    //
+    // NOTE: Entries move between buckets by splicing, and emptied buckets
+    // are kept for reuse, so once the cache is full nothing is allocated.
+    // Caches are neither copyable nor movable, because the index holds
+    // iterators into the buckets.
+    export template <typename K, typename V, typename Hash = std::hash<K>,
+        typename KeyEqual = std::equal_to<K>,
+        typename Allocator = std::allocator<cache_entry<K, V>>>
+    class lfu_cache
+    {
+    private:
+        template <typename U>
+        using rebind_alloc = typename std::allocator_traits<
+            Allocator>::template rebind_alloc<U>;
+
+        struct bucket;
+        using bucket_list = doubly_linked_list<bucket, rebind_alloc<bucket>>;
+        using bucket_iterator = typename bucket_list::iterator;
+
+        struct entry
+        {
+            K key;
+            V value;
+            bucket_iterator owner;
+        };
+
+        using entry_list = doubly_linked_list<entry, rebind_alloc<entry>>;
+        using entry_iterator = typename entry_list::iterator;
+
+        // the entries used count times, from most to least recently used
+        struct bucket
+        {
+            bucket(std::size_t n, const rebind_alloc<entry>& alloc)
+                : count{ n }, entries{ alloc }
+            {
+            }
+
+            std::size_t count;
+            entry_list entries;
+        };
+
+    public:
+        using key_type = K;
+        using mapped_type = V;
+        using size_type = std::size_t;
+        using hasher = Hash;
+        using key_equal = KeyEqual;
+        using allocator_type = Allocator;
+
+        explicit lfu_cache(size_type capacity, const Hash& hash = Hash(),
+            const KeyEqual& equal = KeyEqual(),
+            const Allocator& alloc = Allocator())
+            : buckets_(rebind_alloc<bucket>(alloc)),
+              spare_buckets_(rebind_alloc<bucket>(alloc)),
+              index_{ capacity, hash, equal, alloc },
+              capacity_{ capacity },
+              entry_alloc_(alloc)
+        {
+            if (capacity == 0)
+            {
+                throw std::invalid_argument{ "lfu_cache capacity must be positive" };
+            }
+        }
+
+        lfu_cache(const lfu_cache&) = delete;
+        lfu_cache& operator=(const lfu_cache&) = delete;
+
+        // the value for key, counting a use, or null if key is not cached
+        V* get(const K& key)
+        {
+            const auto* pos = index_.find(key);
+            if (pos == nullptr)
+            {
+                ++stats_.misses;
+                return nullptr;
+            }
+
+            ++stats_.hits;
+            count_use(*pos);
+            return std::addressof((*pos)->value);
+        }
+
+        // like get(), but without counting a use or changing the counters
+        const V* peek(const K& key) const
+        {
+            const auto* pos = index_.find(key);
+            return (pos == nullptr) ? nullptr : std::addressof((*pos)->value);
+        }
+
+        bool contains(const K& key) const
+        {
+            return index_.find(key) != nullptr;
+        }
+
+        // the number of times key has been used, or 0 if it isn't cached
+        size_type use_count(const K& key) const
+        {
+            const auto* pos = index_.find(key);
+            return (pos == nullptr) ? 0 : (*pos)->owner->count;
+        }
+
+        // counts a use of key; returns false if it isn't cached
+        bool touch(const K& key)
+        {
+            const auto* pos = index_.find(key);
+            if (pos == nullptr)
+            {
+                return false;
+            }
+
+            count_use(*pos);
+            return true;
+        }
+
+        // inserts or assigns the value for key, counting a use, and evicts
+        // the least frequently used entry if the cache is full; returns true
+        // if key was inserted
+        bool put(const K& key, V value)
+        {
+            if (const auto* pos = index_.find(key); pos != nullptr)
+            {
+                (*pos)->value = std::move(value);
+                count_use(*pos);
+                ++stats_.updates;
+                return false;
+            }
+
+            const auto first = first_bucket();
+
+            if (size_ == capacity_)
+            {
+                // first is empty if it was only just made, and then the
+                // victim comes from the bucket after it
+                auto lowest = (first->entries.empty()) ? std::next(first) : first;
+                auto victim = std::prev(lowest->entries.end());
+                index_.erase(victim->key);
+
+                first->entries.splice(first->entries.begin(), lowest->entries, victim);
+                victim->owner = first;
+                release_if_empty(lowest);
+
+                try
+                {
+                    victim->key = key;
+                    victim->value = std::move(value);
+                }
+                catch (...)
+                {
+                    first->entries.erase(victim);
+                    --size_;
+                    release_if_empty(first);
+                    throw;
+                }
+
+                ++stats_.evictions;
+            }
+            else
+            {
+                try
+                {
+                    first->entries.emplace_front(key, std::move(value), first);
+                }
+                catch (...)
+                {
+                    release_if_empty(first);
+                    throw;
+                }
+
+                ++size_;
+            }
+
+            index_.insert(first->entries.begin());
+            ++stats_.insertions;
+            return true;
+        }
+
+        bool erase(const K& key)
+        {
+            const auto* pos = index_.find(key);
+            if (pos == nullptr)
+            {
+                return false;
+            }
+
+            const auto erased = *pos;
+            const auto owner = erased->owner;
+            index_.erase(key);
+            owner->entries.erase(erased);
+            --size_;
+            release_if_empty(owner);
+            return true;
+        }
+
+        void clear()
+        {
+            index_.clear();
+            buckets_.clear();
+            spare_buckets_.clear();
+            size_ = 0;
+        }
+
+        bool empty() const
+        {
+            return size_ == 0;
+        }
+
+        size_type size() const
+        {
+            return size_;
+        }
+
+        size_type capacity() const
+        {
+            return capacity_;
+        }
+
+        const cache_stats& stats() const
+        {
+            return stats_;
+        }
+
+        void reset_stats()
+        {
+            stats_ = { };
+        }
+
+    private:
+        // the bucket for entries used once, at the front of buckets_
+        bucket_iterator first_bucket()
+        {
+            if (!buckets_.empty() && buckets_.front().count == 1)
+            {
+                return buckets_.begin();
+            }
+
+            return make_bucket(buckets_.begin(), 1);
+        }
+
+        // a bucket for count placed before pos, reusing a spare bucket's node
+        // when there is one
+        bucket_iterator make_bucket(bucket_iterator pos, size_type count)
+        {
+            if (spare_buckets_.empty())
+            {
+                return buckets_.emplace(pos, count, entry_alloc_);
+            }
+
+            auto spare = spare_buckets_.begin();
+            spare->count = count;
+            buckets_.splice(pos, spare_buckets_, spare);
+            return spare;
+        }
+
+        void release_if_empty(bucket_iterator b)
+        {
+            if (b->entries.empty())
+            {
+                spare_buckets_.splice(spare_buckets_.begin(), buckets_, b);
+            }
+        }
+
+        // moves the entry to the front of the bucket for one more use
+        void count_use(entry_iterator pos)
+        {
+            const auto owner = pos->owner;
+            auto next = std::next(owner);
+
+            if (next == buckets_.end() || next->count != owner->count + 1)
+            {
+                next = make_bucket(next, owner->count + 1);
+            }
+
+            next->entries.splice(next->entries.begin(), owner->entries, pos);
+            pos->owner = next;
+            release_if_empty(owner);
+        }
+
+        bucket_list buckets_;
+        bucket_list spare_buckets_;
+        cache_index<entry_iterator, Hash, KeyEqual, Allocator> index_;
+        size_type capacity_{ 0 };
+        size_type size_{ 0 };
+        [[no_unique_address]] rebind_alloc<entry> entry_alloc_;
+        cache_stats stats_{ };
+    };
+}
@@ -0,0 +1,224 @@
+export module data_structures:pool_allocator;
+
+import std;
+
+namespace caff
+{
+    // A pool of fixed size chunks. Chunks are carved out of large blocks and
+    // freed chunks are threaded onto an intrusive free list, so once the pool
+    // has grown to its working size, allocate() and deallocate() are a couple
+    // of pointer writes and never call into the global heap.
+    //
+    // NOTE: The pool is not thread-safe.
+    export class fixed_size_pool
+    {
+    public:
+        fixed_size_pool(std::size_t chunk_size, std::size_t chunk_alignment,
+            std::size_t chunks_per_block)
+            : chunk_alignment_{ std::max(chunk_alignment, alignof(free_chunk)) },
+              chunks_per_block_{ std::max(chunks_per_block, std::size_t{ 1 }) }
+        {
+            // every chunk must be able to hold the free list link and start
+            // on a suitably aligned address
+            chunk_size_ = std::max(chunk_size, sizeof(free_chunk));
+            chunk_size_ = (chunk_size_ + chunk_alignment_ - 1) /
+                chunk_alignment_ * chunk_alignment_;
+        }
+
+        fixed_size_pool(const fixed_size_pool&) = delete;
+        fixed_size_pool& operator=(const fixed_size_pool&) = delete;
+
+        ~fixed_size_pool()
+        {
+            for (auto* block : blocks_)
+            {
+                ::operator delete(block, std::align_val_t{ chunk_alignment_ });
+            }
+        }
+
+        void* allocate()
+        {
+            if (free_list_ == nullptr)
+            {
+                allocate_block();
+            }
+
+            auto* chunk = free_list_;
+            free_list_ = chunk->next;
+            return chunk;
+        }
+
+        void deallocate(void* p) noexcept
+        {
+            free_list_ = ::new (p) free_chunk{ free_list_ };
+        }
+
+        std::size_t chunk_size() const
+        {
+            return chunk_size_;
+        }
+
+        std::size_t chunk_alignment() const
+        {
+            return chunk_alignment_;
+        }
+
+        std::size_t chunks_per_block() const
+        {
+            return chunks_per_block_;
+        }
+
+        std::size_t block_count() const
+        {
+            return blocks_.size();
+        }
+
+    private:
+        struct free_chunk
+        {
+            free_chunk* next{ nullptr };
+        };
+
+        void allocate_block()
+        {
+            auto* block = static_cast<std::byte*>(::operator new(
+                chunk_size_ * chunks_per_block_,
+                std::align_val_t{ chunk_alignment_ }));
+            blocks_.push_back(block);
+
+            // thread the chunks onto the free list back to front, so they are
+            // handed out in address order
+            for (std::size_t i = chunks_per_block_; i > 0; --i)
+            {
+                free_list_ = ::new (block + (i - 1) * chunk_size_)
+                    free_chunk{ free_list_ };
+            }
+        }
+
+        std::size_t chunk_size_{ 0 };
+        std::size_t chunk_alignment_{ 0 };
+        std::size_t chunks_per_block_{ 0 };
+        free_chunk* free_list_{ nullptr };
+        std::vector<std::byte*> blocks_;
+    };
+
+    // Owns one fixed_size_pool per chunk size/alignment, so every rebound copy
+    // of a pool_allocator can share the same resource.
+    export class pool_resource
+    {
+    public:
+        explicit pool_resource(std::size_t chunks_per_block)
+            : chunks_per_block_{ chunks_per_block }
+        {
+        }
+
+        fixed_size_pool& pool_for(std::size_t size, std::size_t alignment)
+        {
+            for (auto& pool : pools_)
+            {
+                if (pool->chunk_size() >= size &&
+                    pool->chunk_alignment() >= alignment &&
+                    pool->chunk_size() < size + pool->chunk_alignment())
+                {
+                    return *pool;
+                }
+            }
+
+            return *pools_.emplace_back(std::make_unique<fixed_size_pool>(size,
+                alignment, chunks_per_block_));
+        }
+
+    private:
+        std::size_t chunks_per_block_{ 0 };
+        std::vector<std::unique_ptr<fixed_size_pool>> pools_;
+    };
+
+    // An allocator that hands out single objects from a fixed_size_pool.
+    // Requests for more than one object fall back to std::allocator. Copies and
+    // rebound copies share the same pool_resource and compare equal.
+    //
+    // NOTE: Like fixed_size_pool, this allocator is not thread-safe.
+    export template <typename T, std::size_t ChunksPerBlock = 1024>
+    class pool_allocator
+    {
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::false_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+        using is_always_equal = std::false_type;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = pool_allocator<U, ChunksPerBlock>;
+        };
+
+        pool_allocator()
+            : resource_{ std::make_shared<pool_resource>(ChunksPerBlock) },
+              pool_{ std::addressof(resource_->pool_for(sizeof(T), alignof(T))) }
+        {
+        }
+
+        // declared so that there are no implicit moves: a move copies, and
+        // leaves the source sharing the pool it still allocates from
+        pool_allocator(const pool_allocator&) = default;
+        pool_allocator& operator=(const pool_allocator&) = default;
+
+        template <typename U>
+        pool_allocator(const pool_allocator<U, ChunksPerBlock>& other)
+            : resource_{ other.resource() },
+              pool_{ std::addressof(resource_->pool_for(sizeof(T), alignof(T))) }
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            if (n == 1)
+            {
+                return static_cast<T*>(pool_->allocate());
+            }
+            return std::allocator<T>{}.allocate(n);
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept
+        {
+            if (n == 1)
+            {
+                pool_->deallocate(p);
+            }
+            else
+            {
+                std::allocator<T>{}.deallocate(p, n);
+            }
+        }
+
+        // containers copied from one another get their own pool rather than
+        // sharing the source's pool
+        pool_allocator select_on_container_copy_construction() const
+        {
+            return pool_allocator{};
+        }
+
+        const std::shared_ptr<pool_resource>& resource() const
+        {
+            return resource_;
+        }
+
+        const fixed_size_pool& pool() const
+        {
+            return *pool_;
+        }
+
+    private:
+        std::shared_ptr<pool_resource> resource_;
+        fixed_size_pool* pool_{ nullptr };
+    };
+
+    export template <typename T, typename U, std::size_t N>
+    bool operator==(const pool_allocator<T, N>& lhs,
+        const pool_allocator<U, N>& rhs)
+    {
+        return lhs.resource() == rhs.resource();
+    }
+}
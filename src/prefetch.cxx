@@ -0,0 +1,30 @@
+module;
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+export module data_structures:prefetch;
+
+import std;
+
+namespace caff
+{
+    // the line size of the targets we care about, for laying data out along
+    // cache lines and keeping data written by different threads apart
+    constexpr std::size_t cache_line_bytes{ 64 };
+
+    // Hints that the cache line holding p will be read soon. This never
+    // faults, so p may be null or point anywhere, and it compiles to nothing
+    // where there is no prefetch instruction to use.
+    inline void prefetch(const void* p) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(p);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+        static_cast<void>(p);
+#endif
+    }
+}
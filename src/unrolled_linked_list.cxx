@@ -0,0 +1,702 @@
+export module data_structures:unrolled_linked_list;
+
+import std;
+
+namespace caff
+{
+    // A node holds up to K elements in a contiguous block. The elements in
+    // [0, count) are alive; the rest of the storage is uninitialized.
+    export template <typename T, std::size_t K>
+    struct unrolled_linked_list_node
+    {
+        unrolled_linked_list_node* prev{ nullptr };
+        unrolled_linked_list_node* next{ nullptr };
+        std::size_t count{ 0 };
+        alignas(T) std::byte storage[sizeof(T) * K];
+
+        T* data()
+        {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+
+        const T* data() const
+        {
+            return std::launder(reinterpret_cast<const T*>(storage));
+        }
+    };
+
+    export template <typename T, std::size_t K>
+    struct unrolled_linked_list_iterator
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using pointer = value_type*;
+        using reference = value_type&;
+
+        using node_pointer = unrolled_linked_list_node<value_type, K>*;
+
+        unrolled_linked_list_iterator() = default;
+
+        unrolled_linked_list_iterator(node_pointer n, std::size_t index)
+            : node_{ n }, index_{ index }
+        {
+        }
+
+        friend bool operator==(const unrolled_linked_list_iterator& lhs,
+            const unrolled_linked_list_iterator& rhs) = default;
+
+        reference operator*() const
+        {
+            return node_->data()[index_];
+        }
+
+        pointer operator->() const
+        {
+            return std::addressof(**this);
+        }
+
+        unrolled_linked_list_iterator& operator++()
+        {
+            if (node_ != nullptr && ++index_ == node_->count)
+            {
+                node_ = node_->next;
+                index_ = 0;
+            }
+            return *this;
+        }
+
+        unrolled_linked_list_iterator operator++(int)
+        {
+            unrolled_linked_list_iterator tmp{ *this };
+            ++*this;
+            return tmp;
+        }
+
+        node_pointer node() const
+        {
+            return node_;
+        }
+
+        std::size_t index() const
+        {
+            return index_;
+        }
+
+    private:
+        node_pointer node_{ nullptr };
+        std::size_t index_{ 0 };
+    };
+
+    export template <typename T, std::size_t K>
+    struct unrolled_linked_list_const_iterator
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        using node_pointer = const unrolled_linked_list_node<value_type, K>*;
+
+        unrolled_linked_list_const_iterator() = default;
+
+        unrolled_linked_list_const_iterator(node_pointer n, std::size_t index)
+            : node_{ n }, index_{ index }
+        {
+        }
+
+        unrolled_linked_list_const_iterator(
+            const unrolled_linked_list_iterator<value_type, K>& pos)
+            : node_{ pos.node() }, index_{ pos.index() }
+        {
+        }
+
+        friend bool operator==(const unrolled_linked_list_const_iterator& lhs,
+            const unrolled_linked_list_const_iterator& rhs) = default;
+
+        reference operator*() const
+        {
+            return node_->data()[index_];
+        }
+
+        pointer operator->() const
+        {
+            return std::addressof(**this);
+        }
+
+        unrolled_linked_list_const_iterator& operator++()
+        {
+            if (node_ != nullptr && ++index_ == node_->count)
+            {
+                node_ = node_->next;
+                index_ = 0;
+            }
+            return *this;
+        }
+
+        unrolled_linked_list_const_iterator operator++(int)
+        {
+            unrolled_linked_list_const_iterator tmp{ *this };
+            ++*this;
+            return tmp;
+        }
+
+        node_pointer node() const
+        {
+            return node_;
+        }
+
+        std::size_t index() const
+        {
+            return index_;
+        }
+
+    private:
+        node_pointer node_{ nullptr };
+        std::size_t index_{ 0 };
+    };
+
+    static_assert(std::forward_iterator<unrolled_linked_list_iterator<int, 8>>);
+    static_assert(std::forward_iterator<unrolled_linked_list_const_iterator<int, 8>>);
+
+    // A linked list whose nodes each hold up to K elements, so sequential
+    // scans touch one node per K elements. A full node is split in half when
+    // inserting into it, and a node that drops below half full is merged
+    // with its successor when they fit in a single node.
+    //
+    // NOTE: Unlike linked_list, an iterator identifies its node directly, so
+    // insert() and erase() are O(K) without needing the predecessor. Both
+    // invalidate iterators to the elements of the nodes they touch.
+    export template <typename T, std::size_t K,
+        typename Allocator = std::allocator<T>>
+    class unrolled_linked_list
+    {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using iterator = unrolled_linked_list_iterator<value_type, K>;
+        using const_iterator = unrolled_linked_list_const_iterator<value_type, K>;
+        using allocator_type = Allocator;
+
+        using node = unrolled_linked_list_node<value_type, K>;
+        using node_allocator_type = typename std::allocator_traits<
+            allocator_type>::template rebind_alloc<node>;
+
+        static constexpr size_type node_capacity = K;
+
+        unrolled_linked_list() = default;
+
+        explicit unrolled_linked_list(const allocator_type& alloc)
+            : alloc_{ alloc }
+        {
+        }
+
+        unrolled_linked_list(std::initializer_list<T> values,
+            const allocator_type& alloc = allocator_type())
+            : alloc_{ alloc }
+        {
+            insert(end(), values.begin(), values.end());
+        }
+
+        unrolled_linked_list(const unrolled_linked_list& other)
+            : alloc_{ node_traits::select_on_container_copy_construction(
+                other.alloc_) }
+        {
+            insert(end(), other.begin(), other.end());
+        }
+
+        unrolled_linked_list(unrolled_linked_list&& other) noexcept
+            : head_{ std::exchange(other.head_, nullptr) },
+              tail_{ std::exchange(other.tail_, nullptr) },
+              size_{ std::exchange(other.size_, 0) },
+              alloc_{ std::move(other.alloc_) }
+        {
+        }
+
+        ~unrolled_linked_list()
+        {
+            clear();
+        }
+
+        unrolled_linked_list& operator=(const unrolled_linked_list& other)
+        {
+            if (this != std::addressof(other))
+            {
+                clear();
+
+                if constexpr (node_traits::propagate_on_container_copy_assignment::value)
+                {
+                    alloc_ = other.alloc_;
+                }
+
+                insert(end(), other.begin(), other.end());
+            }
+
+            return *this;
+        }
+
+        unrolled_linked_list& operator=(unrolled_linked_list&& other) noexcept(
+            node_traits::propagate_on_container_move_assignment::value ||
+            node_traits::is_always_equal::value)
+        {
+            if (this != std::addressof(other))
+            {
+                clear();
+
+                if constexpr (node_traits::propagate_on_container_move_assignment::value)
+                {
+                    alloc_ = std::move(other.alloc_);
+                }
+                else if (alloc_ != other.alloc_)
+                {
+                    insert(end(), std::make_move_iterator(other.begin()),
+                        std::make_move_iterator(other.end()));
+                    other.clear();
+                    return *this;
+                }
+
+                head_ = std::exchange(other.head_, nullptr);
+                tail_ = std::exchange(other.tail_, nullptr);
+                size_ = std::exchange(other.size_, 0);
+            }
+
+            return *this;
+        }
+
+        unrolled_linked_list& operator=(std::initializer_list<T> values)
+        {
+            clear();
+            insert(end(), values.begin(), values.end());
+            return *this;
+        }
+
+        allocator_type get_allocator() const
+        {
+            return allocator_type(alloc_);
+        }
+
+        reference front()
+        {
+            return head_->data()[0];
+        }
+
+        const_reference front() const
+        {
+            return head_->data()[0];
+        }
+
+        reference back()
+        {
+            return tail_->data()[tail_->count - 1];
+        }
+
+        const_reference back() const
+        {
+            return tail_->data()[tail_->count - 1];
+        }
+
+        iterator begin()
+        {
+            return iterator{ head_, 0 };
+        }
+
+        const_iterator begin() const
+        {
+            return const_iterator{ head_, 0 };
+        }
+
+        const_iterator cbegin() const
+        {
+            return const_iterator{ head_, 0 };
+        }
+
+        iterator end()
+        {
+            return iterator{ nullptr, 0 };
+        }
+
+        const_iterator end() const
+        {
+            return const_iterator{ nullptr, 0 };
+        }
+
+        const_iterator cend() const
+        {
+            return const_iterator{ nullptr, 0 };
+        }
+
+        bool empty() const
+        {
+            return head_ == nullptr;
+        }
+
+        size_type size() const
+        {
+            return size_;
+        }
+
+        size_type node_count() const
+        {
+            size_type count{ 0 };
+            for (auto* n = head_; n != nullptr; n = n->next)
+            {
+                ++count;
+            }
+            return count;
+        }
+
+        void clear()
+        {
+            auto* n = head_;
+            head_ = nullptr;
+            tail_ = nullptr;
+            size_ = 0;
+
+            while (n != nullptr)
+            {
+                auto* tmp = n;
+                n = n->next;
+                destroy_node(tmp);
+            }
+        }
+
+        iterator insert(const_iterator pos, const T& value)
+        {
+            return emplace(pos, value);
+        }
+
+        iterator insert(const_iterator pos, T&& value)
+        {
+            return emplace(pos, std::move(value));
+        }
+
+        template <std::input_iterator InputIt>
+        requires (std::constructible_from<T, std::iter_reference_t<InputIt>>)
+        iterator insert(const_iterator pos, InputIt first, InputIt last)
+        {
+            if (first == last)
+            {
+                return iterator{ mutable_node(pos), pos.index() };
+            }
+
+            auto result = emplace(pos, *first);
+            auto current = result;
+
+            for (++first; first != last; ++first)
+            {
+                current = emplace(std::next(current), *first);
+
+                // an insertion may have split result's node
+                if (current.node() != result.node() &&
+                    result.index() >= result.node()->count)
+                {
+                    result = iterator{ result.node()->next,
+                        result.index() - result.node()->count };
+                }
+            }
+
+            return result;
+        }
+
+        template <typename... Args>
+        requires (std::constructible_from<T, Args...>)
+        iterator emplace(const_iterator pos, Args&&... args)
+        {
+            auto* n = mutable_node(pos);
+            auto index = pos.index();
+
+            // end() inserts after the last element of the tail
+            if (n == nullptr)
+            {
+                n = tail_;
+                index = (n != nullptr) ? n->count : 0;
+            }
+
+            // construct the value first, in case args refer to an element that
+            // is about to be moved
+            T value(std::forward<Args>(args)...);
+
+            if (n == nullptr)
+            {
+                n = create_node(nullptr);
+                index = 0;
+            }
+            else if (n->count == K)
+            {
+                if (index == K)
+                {
+                    // appending to a full node starts a new node, so
+                    // sequential appends leave every node full
+                    n = create_node(n);
+                    index = 0;
+                }
+                else
+                {
+                    auto* upper = split(n);
+                    if (index > n->count)
+                    {
+                        index -= n->count;
+                        n = upper;
+                    }
+                }
+            }
+
+            shift_right(n, index);
+            std::construct_at(n->data() + index, std::move(value));
+            ++n->count;
+            ++size_;
+            return iterator{ n, index };
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            auto* n = mutable_node(pos);
+            auto index = pos.index();
+
+            std::destroy_at(n->data() + index);
+            shift_left(n, index);
+            --n->count;
+            --size_;
+
+            if (n->count == 0)
+            {
+                auto* next = n->next;
+                unlink(n);
+                destroy_node(n);
+                return iterator{ next, 0 };
+            }
+
+            // keep nodes at least half full by absorbing the next node
+            if (n->count < (K + 1) / 2 && n->next != nullptr &&
+                n->count + n->next->count <= K)
+            {
+                merge_next(n);
+            }
+
+            if (index == n->count)
+            {
+                return iterator{ n->next, 0 };
+            }
+            return iterator{ n, index };
+        }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            auto pos = iterator{ mutable_node(first), first.index() };
+
+            // erase() may merge nodes, which moves last; count the elements
+            // up front instead
+            auto count = std::distance(first, last);
+            for (; count > 0; --count)
+            {
+                pos = erase(pos);
+            }
+
+            return pos;
+        }
+
+        void push_front(const T& value)
+        {
+            emplace(begin(), value);
+        }
+
+        void push_front(T&& value)
+        {
+            emplace(begin(), std::move(value));
+        }
+
+        template <typename... Args>
+        requires (std::constructible_from<T, Args...>)
+        reference emplace_front(Args&&... args)
+        {
+            return *emplace(begin(), std::forward<Args>(args)...);
+        }
+
+        void pop_front()
+        {
+            erase(begin());
+        }
+
+        void push_back(const T& value)
+        {
+            emplace(end(), value);
+        }
+
+        void push_back(T&& value)
+        {
+            emplace(end(), std::move(value));
+        }
+
+        template <typename... Args>
+        requires (std::constructible_from<T, Args...>)
+        reference emplace_back(Args&&... args)
+        {
+            return *emplace(end(), std::forward<Args>(args)...);
+        }
+
+        void swap(unrolled_linked_list& other) noexcept
+        {
+            if constexpr (node_traits::propagate_on_container_swap::value)
+            {
+                std::ranges::swap(alloc_, other.alloc_);
+            }
+
+            std::ranges::swap(head_, other.head_);
+            std::ranges::swap(tail_, other.tail_);
+            std::ranges::swap(size_, other.size_);
+        }
+
+        friend void swap(unrolled_linked_list& lhs, unrolled_linked_list& rhs) noexcept
+        {
+            lhs.swap(rhs);
+        }
+
+        friend bool operator==(const unrolled_linked_list& lhs,
+            const unrolled_linked_list& rhs)
+        {
+            return lhs.size_ == rhs.size_ && std::ranges::equal(lhs, rhs);
+        }
+
+        friend auto operator<=>(const unrolled_linked_list& lhs,
+            const unrolled_linked_list& rhs)
+        {
+            return std::lexicographical_compare_three_way(
+                lhs.begin(), lhs.end(),
+                rhs.begin(), rhs.end()
+            );
+        }
+
+    private:
+        using node_traits = std::allocator_traits<node_allocator_type>;
+
+        static_assert(K > 0, "Node capacity must be at least 1");
+
+        // const_iterators only refer to nodes owned by this list, so it is
+        // safe to hand out a mutable pointer to the node
+        static node* mutable_node(const_iterator pos)
+        {
+            return const_cast<node*>(pos.node());
+        }
+
+        // creates an empty node and links it in after prev, or at the front
+        // if prev is nullptr
+        node* create_node(node* prev)
+        {
+            auto* n = ::new (static_cast<void*>(node_traits::allocate(alloc_, 1))) node;
+
+            n->prev = prev;
+            n->next = (prev != nullptr) ? prev->next : head_;
+
+            if (n->prev != nullptr)
+            {
+                n->prev->next = n;
+            }
+            else
+            {
+                head_ = n;
+            }
+
+            if (n->next != nullptr)
+            {
+                n->next->prev = n;
+            }
+            else
+            {
+                tail_ = n;
+            }
+
+            return n;
+        }
+
+        void destroy_node(node* n)
+        {
+            std::destroy_n(n->data(), n->count);
+            std::destroy_at(n);
+            node_traits::deallocate(alloc_, n, 1);
+        }
+
+        void unlink(node* n)
+        {
+            if (n->prev != nullptr)
+            {
+                n->prev->next = n->next;
+            }
+            else
+            {
+                head_ = n->next;
+            }
+
+            if (n->next != nullptr)
+            {
+                n->next->prev = n->prev;
+            }
+            else
+            {
+                tail_ = n->prev;
+            }
+        }
+
+        // moves the upper half of n into a new node following it
+        node* split(node* n)
+        {
+            auto* upper = create_node(n);
+            const auto keep = n->count / 2;
+
+            std::uninitialized_move(n->data() + keep, n->data() + n->count,
+                upper->data());
+            std::destroy(n->data() + keep, n->data() + n->count);
+            upper->count = n->count - keep;
+            n->count = keep;
+
+            return upper;
+        }
+
+        // moves every element of n->next to the end of n and frees n->next
+        void merge_next(node* n)
+        {
+            auto* next = n->next;
+
+            std::uninitialized_move(next->data(), next->data() + next->count,
+                n->data() + n->count);
+            std::destroy(next->data(), next->data() + next->count);
+            n->count += next->count;
+            next->count = 0;
+
+            unlink(next);
+            destroy_node(next);
+        }
+
+        // opens an uninitialized slot at index
+        static void shift_right(node* n, std::size_t index)
+        {
+            auto* data = n->data();
+            for (auto i = n->count; i > index; --i)
+            {
+                std::construct_at(data + i, std::move(data[i - 1]));
+                std::destroy_at(data + i - 1);
+            }
+        }
+
+        // closes the uninitialized slot at index
+        static void shift_left(node* n, std::size_t index)
+        {
+            auto* data = n->data();
+            for (auto i = index + 1; i < n->count; ++i)
+            {
+                std::construct_at(data + i - 1, std::move(data[i]));
+                std::destroy_at(data + i);
+            }
+        }
+
+        node* head_{ nullptr };
+        node* tail_{ nullptr };
+        size_type size_{ 0 };
+        [[no_unique_address]] node_allocator_type alloc_{ };
+    };
+}
@@ -0,0 +1,190 @@
+export module data_structures:work_stealing_deque;
+
+import std;
+import :hazard_pointer;
+import :prefetch;
+
+namespace caff
+{
+    // A Chase-Lev deque: a lock-free double-ended queue with a single owner
+    // thread, which pushes and pops at the bottom, and any number of thief
+    // threads, which steal from the top. The owner only synchronizes with
+    // thieves when they contend for the last element, so push and pop are
+    // nearly as cheap as on a plain vector. The elements live in a circular
+    // buffer that the owner doubles when it is full; replaced buffers are
+    // reclaimed through hazard pointers, because a thief may still be
+    // reading from one.
+    //
+    // The memory orderings follow Le, Pop, Cohen and Zappa Nardelli,
+    // "Correct and Efficient Work-Stealing for Weak Memory Models" (2013).
+    //
+    // NOTE: Thieves read an element before they know whether they won it, so
+    // elements are kept in atomics and have to be trivially copyable. Store
+    // pointers to anything bigger.
+    export template <typename T>
+    requires (std::is_trivially_copyable_v<T>)
+    class work_stealing_deque
+    {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+
+        static constexpr size_type default_capacity{ 64 };
+
+        // capacity is rounded up to a power of two
+        explicit work_stealing_deque(size_type capacity = default_capacity)
+            : buffer_{ new ring{ std::bit_ceil(std::max<size_type>(capacity, 2)) } }
+        {
+        }
+
+        work_stealing_deque(const work_stealing_deque&) = delete;
+        work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+        ~work_stealing_deque()
+        {
+            delete buffer_.load(std::memory_order_relaxed);
+        }
+
+        // owner only
+        void push(T value)
+        {
+            const auto b = bottom_.load(std::memory_order_relaxed);
+            const auto t = top_.load(std::memory_order_acquire);
+            auto* buffer = buffer_.load(std::memory_order_relaxed);
+
+            if (b - t >= static_cast<std::int64_t>(buffer->capacity))
+            {
+                buffer = grow(buffer, t, b);
+            }
+
+            // a release store rather than the paper's release fence, which
+            // is the same on x86 and visible to ThreadSanitizer
+            buffer->store(b, value);
+            bottom_.store(b + 1, std::memory_order_release);
+        }
+
+        // owner only: takes the most recently pushed element
+        std::optional<T> pop()
+        {
+            const auto b = bottom_.load(std::memory_order_relaxed) - 1;
+            auto* buffer = buffer_.load(std::memory_order_relaxed);
+
+            // claim the bottom element before looking at what thieves took
+            bottom_.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto t = top_.load(std::memory_order_relaxed);
+
+            if (t > b)
+            {
+                bottom_.store(b + 1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+
+            std::optional<T> value{ buffer->load(b) };
+
+            if (t == b)
+            {
+                // the last element: race the thieves for it through top_
+                if (!top_.compare_exchange_strong(t, t + 1,
+                    std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    value.reset();
+                }
+                bottom_.store(b + 1, std::memory_order_relaxed);
+            }
+
+            return value;
+        }
+
+        // any thread: takes the least recently pushed element. Returns
+        // nullopt if the deque is empty or another thread took the element
+        // first, so a failed steal is worth retrying elsewhere, not here.
+        std::optional<T> steal()
+        {
+            auto t = top_.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const auto b = bottom_.load(std::memory_order_acquire);
+
+            if (t >= b)
+            {
+                return std::nullopt;
+            }
+
+            hazard_pointer hp;
+            auto* buffer = hp.protect(buffer_);
+            const T value{ buffer->load(t) };
+
+            if (!top_.compare_exchange_strong(t, t + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                return std::nullopt;
+            }
+
+            return value;
+        }
+
+        // only a snapshot when other threads are using the deque
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        // only a snapshot when other threads are using the deque
+        size_type size() const
+        {
+            const auto b = bottom_.load(std::memory_order_relaxed);
+            const auto t = top_.load(std::memory_order_relaxed);
+            return (b > t) ? static_cast<size_type>(b - t) : 0;
+        }
+
+        // owner only
+        size_type capacity() const
+        {
+            return buffer_.load(std::memory_order_relaxed)->capacity;
+        }
+
+    private:
+        // the indices only ever grow, and map onto the buffer modulo its
+        // capacity
+        struct ring
+        {
+            explicit ring(size_type n)
+                : capacity{ n }, slots{ std::make_unique<std::atomic<T>[]>(n) }
+            {
+            }
+
+            T load(std::int64_t i) const
+            {
+                return slots[static_cast<size_type>(i) & (capacity - 1)].load(
+                    std::memory_order_relaxed);
+            }
+
+            void store(std::int64_t i, T value)
+            {
+                slots[static_cast<size_type>(i) & (capacity - 1)].store(value,
+                    std::memory_order_relaxed);
+            }
+
+            size_type capacity;
+            std::unique_ptr<std::atomic<T>[]> slots;
+        };
+
+        ring* grow(ring* old, std::int64_t top, std::int64_t bottom)
+        {
+            auto* bigger = new ring{ old->capacity * 2 };
+            for (auto i = top; i != bottom; ++i)
+            {
+                bigger->store(i, old->load(i));
+            }
+
+            buffer_.store(bigger, std::memory_order_release);
+            hazard_retire(old);
+            return bigger;
+        }
+
+        // the owner's and the thieves' hot indices sit on separate cache lines
+        alignas(cache_line_bytes) std::atomic<std::int64_t> top_{ 0 };
+        alignas(cache_line_bytes) std::atomic<std::int64_t> bottom_{ 0 };
+        std::atomic<ring*> buffer_{ nullptr };
+    };
+}
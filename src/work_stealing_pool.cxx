@@ -0,0 +1,260 @@
+export module data_structures:work_stealing_pool;
+
+import std;
+import :lock_free_queue;
+import :work_stealing_deque;
+
+namespace caff
+{
+    // A fixed set of worker threads that each run tasks from their own
+    // work_stealing_deque. A task submitted from a worker goes to the bottom
+    // of that worker's deque, so recursive task graphs mostly stay on one
+    // thread and in cache; tasks submitted from other threads go through a
+    // shared lock_free_queue. A worker that runs out of tasks steals the
+    // oldest task of another worker, which tends to be the root of a large
+    // subtree, and sleeps once stealing keeps failing.
+    //
+    // NOTE: Tasks must not throw. A thread that waits for a result inside a
+    // task should use run_until(), which runs other tasks in the meantime,
+    // instead of blocking the worker.
+    export class work_stealing_pool
+    {
+    public:
+        using size_type = std::size_t;
+
+        explicit work_stealing_pool(size_type thread_count =
+            std::max(std::thread::hardware_concurrency(), 1u))
+        {
+            thread_count = std::max<size_type>(thread_count, 1);
+
+            workers_.reserve(thread_count);
+            for (size_type i = 0; i < thread_count; ++i)
+            {
+                workers_.push_back(std::make_unique<worker>());
+            }
+
+            threads_.reserve(thread_count);
+            for (size_type i = 0; i < thread_count; ++i)
+            {
+                threads_.emplace_back([this, i] { work(i); });
+            }
+        }
+
+        work_stealing_pool(const work_stealing_pool&) = delete;
+        work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+        // runs every submitted task before stopping the workers
+        ~work_stealing_pool()
+        {
+            wait();
+
+            stopping_.store(true);
+            epoch_.fetch_add(1);
+            epoch_.notify_all();
+
+            threads_.clear();
+        }
+
+        template <typename F>
+        requires (std::invocable<std::decay_t<F>&>)
+        void submit(F&& f)
+        {
+            auto new_task = std::make_unique<task_impl<std::decay_t<F>>>(
+                std::forward<F>(f));
+
+            pending_.fetch_add(1, std::memory_order_relaxed);
+
+            if (const auto& self = current_worker(); self.pool == this)
+            {
+                workers_[self.index]->deque.push(new_task.release());
+            }
+            else
+            {
+                injected_.push(new_task.release());
+            }
+
+            // pairs with the fence in work() so that either a sleeping
+            // worker sees the task or this thread sees the sleeper
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sleepers_.load(std::memory_order_relaxed) > 0)
+            {
+                epoch_.fetch_add(1);
+                epoch_.notify_one();
+            }
+        }
+
+        // runs tasks on the calling thread until done() returns true
+        template <typename Predicate>
+        void run_until(Predicate done)
+        {
+            const auto& self = current_worker();
+            const auto index = (self.pool == this) ? self.index : no_worker;
+
+            while (!done())
+            {
+                if (auto* t = find_task(index); t != nullptr)
+                {
+                    execute(t);
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        // runs tasks on the calling thread until every submitted task,
+        // including the ones submitted while waiting, has finished
+        void wait()
+        {
+            run_until([this] { return pending_.load(std::memory_order_acquire) == 0; });
+        }
+
+        size_type thread_count() const
+        {
+            return threads_.size();
+        }
+
+    private:
+        struct task
+        {
+            virtual ~task() = default;
+            virtual void run() = 0;
+        };
+
+        template <typename F>
+        struct task_impl final : task
+        {
+            template <typename G>
+            explicit task_impl(G&& g) : f{ std::forward<G>(g) }
+            {
+            }
+
+            void run() override
+            {
+                std::invoke(f);
+            }
+
+            F f;
+        };
+
+        struct worker
+        {
+            work_stealing_deque<task*> deque;
+        };
+
+        struct worker_context
+        {
+            const work_stealing_pool* pool{ nullptr };
+            size_type index{ 0 };
+        };
+
+        static constexpr size_type no_worker{ std::numeric_limits<size_type>::max() };
+
+        // failed rounds of stealing before a worker goes to sleep
+        static constexpr int spins_before_sleep{ 64 };
+
+        static worker_context& current_worker()
+        {
+            static thread_local worker_context context;
+            return context;
+        }
+
+        void work(size_type index)
+        {
+            current_worker() = { this, index };
+            int idle{ 0 };
+
+            while (!stopping_.load())
+            {
+                if (auto* t = find_task(index); t != nullptr)
+                {
+                    execute(t);
+                    idle = 0;
+                    continue;
+                }
+
+                if (++idle < spins_before_sleep)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                // announce the sleep before the last look for work, so a
+                // submit either is seen here or sees this sleeper and moves
+                // the epoch on
+                const auto epoch = epoch_.load();
+                sleepers_.fetch_add(1);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if (auto* t = find_task(index); t != nullptr)
+                {
+                    sleepers_.fetch_sub(1);
+                    execute(t);
+                }
+                else
+                {
+                    if (!stopping_.load())
+                    {
+                        epoch_.wait(epoch);
+                    }
+                    sleepers_.fetch_sub(1);
+                }
+
+                idle = 0;
+            }
+        }
+
+        // the worker's own newest task, else the oldest submitted from
+        // outside, else a task stolen from another worker
+        task* find_task(size_type index)
+        {
+            if (index != no_worker)
+            {
+                if (auto t = workers_[index]->deque.pop(); t.has_value())
+                {
+                    return *t;
+                }
+            }
+
+            if (auto t = injected_.pop(); t.has_value())
+            {
+                return *t;
+            }
+
+            const auto count = workers_.size();
+            const auto first = (index != no_worker) ? index + 1 : 0;
+
+            for (size_type i = 0; i < count; ++i)
+            {
+                const auto victim = (first + i) % count;
+                if (victim == index)
+                {
+                    continue;
+                }
+
+                if (auto t = workers_[victim]->deque.steal(); t.has_value())
+                {
+                    return *t;
+                }
+            }
+
+            return nullptr;
+        }
+
+        void execute(task* t) noexcept
+        {
+            t->run();
+            delete t;
+            pending_.fetch_sub(1, std::memory_order_release);
+        }
+
+        std::vector<std::unique_ptr<worker>> workers_;
+        lock_free_queue<task*> injected_;
+        std::atomic<size_type> pending_{ 0 };
+        std::atomic<size_type> sleepers_{ 0 };
+        std::atomic<std::uint32_t> epoch_{ 0 };
+        std::atomic<bool> stopping_{ false };
+        std::vector<std::jthread> threads_;
+    };
+}
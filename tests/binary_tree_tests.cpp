@@ -209,4 +209,465 @@ TEST_CASE("binary_tree")
             REQUIRE(std::ranges::equal(actual, expected));
         }
     }
-}
\ No newline at end of file
+}
+namespace
+{
+    // sorted runs, the worst case for an unbalanced tree, then an
+    // alternating low/high sequence that zigzags down the tree
+    std::vector<int> adversarial_keys(int n)
+    {
+        std::vector<int> keys;
+
+        for (int i = 0; i < n; ++i)
+        {
+            keys.push_back(i);
+        }
+        for (int i = 2 * n; i > n; --i)
+        {
+            keys.push_back(i);
+        }
+        for (int lo = 3 * n, hi = 4 * n; lo < hi; ++lo, --hi)
+        {
+            keys.push_back(lo);
+            keys.push_back(hi);
+        }
+
+        return keys;
+    }
+
+    template <typename Tree, typename Key>
+    concept tree_can_find = requires (const Tree& tree, const Key& key) { tree.find(key); };
+
+    template <typename Tree>
+    Tree make_tree(const std::vector<int>& keys)
+    {
+        Tree tree;
+        for (const auto key : keys)
+        {
+            tree.insert(key);
+        }
+        return tree;
+    }
+}
+
+TEST_CASE("balanced binary_tree")
+{
+    using namespace caff;
+
+    const auto keys = adversarial_keys(30'000);
+    const auto n = static_cast<double>(keys.size());
+
+    auto sorted = keys;
+    std::ranges::sort(sorted);
+
+    SUBCASE("red-black")
+    {
+        const auto tree = make_tree<binary_tree<int, red_black_balancing>>(keys);
+
+        REQUIRE(tree.size() == keys.size());
+        REQUIRE(std::ranges::equal(tree, sorted));
+        REQUIRE(static_cast<double>(tree.height()) <= 2 * std::log2(n + 1));
+    }
+
+    SUBCASE("avl")
+    {
+        const auto tree = make_tree<binary_tree<int, avl_balancing>>(keys);
+
+        REQUIRE(tree.size() == keys.size());
+        REQUIRE(std::ranges::equal(tree, sorted));
+        REQUIRE(static_cast<double>(tree.height()) <= 1.4405 * std::log2(n + 2));
+    }
+
+    SUBCASE("small trees stay as short as possible")
+    {
+        // three ascending keys need one rotation, seven need four
+        REQUIRE(binary_tree<int, red_black_balancing>{ 1, 2, 3 }.height() == 2);
+        REQUIRE(binary_tree<int, avl_balancing>{ 1, 2, 3 }.height() == 2);
+        REQUIRE(binary_tree<int, avl_balancing>{ 1, 2, 3, 4, 5, 6, 7 }.height() == 3);
+        REQUIRE(binary_tree<int, avl_balancing>{ 3, 1, 2 }.height() == 2);
+        REQUIRE(binary_tree<int, red_black_balancing>{ 3, 1, 2 }.height() == 2);
+    }
+
+    SUBCASE("duplicates")
+    {
+        const binary_tree<int, red_black_balancing> red_black{ 2, 2, 2, 2, 1, 1, 3 };
+        const binary_tree<int, avl_balancing> avl{ 2, 2, 2, 2, 1, 1, 3 };
+        const std::array expected{ 1, 1, 2, 2, 2, 2, 3 };
+
+        REQUIRE(std::ranges::equal(red_black, expected));
+        REQUIRE(std::ranges::equal(avl, expected));
+    }
+
+    SUBCASE("copies keep the shape")
+    {
+        const auto tree = make_tree<binary_tree<int, red_black_balancing>>(keys);
+        auto copy = tree;
+        REQUIRE(copy == tree);
+        REQUIRE(copy.height() == tree.height());
+
+        // inserting into the copy rebalances with the copied colours
+        for (int i = 0; i < 1000; ++i)
+        {
+            copy.insert(-i);
+        }
+        REQUIRE(static_cast<double>(copy.height()) <= 2 * std::log2(n + 1001));
+    }
+
+    SUBCASE("an unbalanced tree can be as deep as it is large")
+    {
+        const auto tree = make_tree<binary_tree<int>>(
+            std::vector<int>(sorted.begin(), sorted.begin() + 20'000));
+
+        REQUIRE(tree.height() == 20'000);
+
+        // copying, comparing and destroying do not recurse down the tree
+        auto copy = tree;
+        REQUIRE(copy == tree);
+        copy.clear();
+        REQUIRE(copy.empty());
+    }
+}
+
+TEST_CASE("binary_tree lookup and erase")
+{
+    using namespace caff;
+
+    SUBCASE("find and contains")
+    {
+        const binary_tree tree{ 4, 2, 6, 1, 3, 5, 7 };
+
+        for (int i = 1; i <= 7; ++i)
+        {
+            REQUIRE(tree.contains(i));
+            REQUIRE(*tree.find(i) == i);
+        }
+
+        REQUIRE_FALSE(tree.contains(0));
+        REQUIRE_FALSE(tree.contains(8));
+        REQUIRE(tree.find(8) == tree.end());
+
+        // iteration carries on from where find stopped
+        auto it = tree.find(5);
+        REQUIRE(*++it == 6);
+        REQUIRE(*++it == 7);
+        REQUIRE(++it == tree.end());
+    }
+
+    SUBCASE("bounds")
+    {
+        const binary_tree<int, red_black_balancing> tree{ 10, 20, 20, 20, 30 };
+
+        REQUIRE(*tree.lower_bound(20) == 20);
+        REQUIRE(*tree.upper_bound(20) == 30);
+        REQUIRE(*tree.lower_bound(15) == 20);
+        REQUIRE(*tree.lower_bound(0) == 10);
+        REQUIRE(tree.lower_bound(31) == tree.end());
+        REQUIRE(tree.upper_bound(30) == tree.end());
+
+        const auto [first, last] = tree.equal_range(20);
+        REQUIRE(std::distance(first, last) == 3);
+
+        const auto [none, also_none] = tree.equal_range(25);
+        REQUIRE(none == also_none);
+        REQUIRE(*none == 30);
+    }
+
+    SUBCASE("erase by key")
+    {
+        binary_tree<int, avl_balancing> tree{ 5, 3, 8, 3, 1, 3, 9 };
+
+        REQUIRE(tree.erase(3) == 3);
+        REQUIRE(tree.size() == 4);
+        REQUIRE_FALSE(tree.contains(3));
+        REQUIRE(std::ranges::equal(tree, std::array{ 1, 5, 8, 9 }));
+
+        REQUIRE(tree.erase(3) == 0);
+        REQUIRE(tree.erase(5) == 1);
+        REQUIRE(tree.erase(1) == 1);
+        REQUIRE(tree.erase(9) == 1);
+        REQUIRE(tree.erase(8) == 1);
+        REQUIRE(tree.empty());
+        REQUIRE(tree.begin() == tree.end());
+    }
+
+    SUBCASE("erase by iterator")
+    {
+        binary_tree<int, red_black_balancing> tree;
+        for (int i = 0; i < 100; ++i)
+        {
+            tree.insert(i);
+        }
+
+        // erase the odd values while walking the tree
+        for (auto it = tree.begin(); it != tree.end();)
+        {
+            it = (*it % 2 != 0) ? tree.erase(it) : std::next(it);
+        }
+
+        REQUIRE(tree.size() == 50);
+        REQUIRE(std::ranges::all_of(tree, [](int value) { return value % 2 == 0; }));
+
+        const auto next = tree.erase(tree.find(98));
+        REQUIRE(next == tree.end());
+    }
+
+    SUBCASE("erasing keeps the tree balanced")
+    {
+        binary_tree<int, red_black_balancing> red_black;
+        binary_tree<int, avl_balancing> avl;
+        for (int i = 0; i < 20'000; ++i)
+        {
+            red_black.insert(i);
+            avl.insert(i);
+        }
+
+        // take out everything but every tenth value, from one end
+        for (int i = 0; i < 20'000; ++i)
+        {
+            if (i % 10 != 0)
+            {
+                REQUIRE(red_black.erase(i) == 1);
+                REQUIRE(avl.erase(i) == 1);
+            }
+        }
+
+        REQUIRE(red_black.size() == 2'000);
+        REQUIRE(avl.size() == 2'000);
+        REQUIRE(static_cast<double>(red_black.height()) <= 2 * std::log2(2'001.0));
+        REQUIRE(static_cast<double>(avl.height()) <= 1.4405 * std::log2(2'002.0));
+    }
+
+    SUBCASE("custom comparator")
+    {
+        const binary_tree<int, red_black_balancing, std::greater<int>> tree{ 1, 5, 3, 4, 2 };
+
+        REQUIRE(std::ranges::equal(tree, std::array{ 5, 4, 3, 2, 1 }));
+        REQUIRE(*tree.lower_bound(6) == 5);
+        REQUIRE(*tree.upper_bound(3) == 2);
+    }
+
+    SUBCASE("transparent lookup")
+    {
+        using namespace std::string_view_literals;
+
+        binary_tree<std::string, red_black_balancing, std::less<>> tree{ "pear", "apple", "fig" };
+
+        REQUIRE(tree.contains("fig"sv));
+        REQUIRE(*tree.find("apple"sv) == "apple");
+        REQUIRE(*tree.lower_bound("b"sv) == "fig");
+        REQUIRE(tree.erase("pear"sv) == 1);
+        REQUIRE(tree.size() == 2);
+
+        // without a transparent comparator only the key type is accepted
+        using opaque = binary_tree<std::string, red_black_balancing>;
+        static_assert(!tree_can_find<opaque, std::string_view>);
+        static_assert(tree_can_find<decltype(tree), std::string_view>);
+    }
+}
+
+TEST_CASE("binary_tree iterators")
+{
+    using namespace caff;
+
+    static_assert(std::bidirectional_iterator<binary_tree<int>::iterator>);
+    static_assert(std::ranges::bidirectional_range<binary_tree<int>>);
+
+    SUBCASE("backwards")
+    {
+        const binary_tree<int, avl_balancing> tree{ 4, 2, 6, 1, 3, 5, 7 };
+
+        auto it = tree.end();
+        for (int expected = 7; expected >= 1; --expected)
+        {
+            REQUIRE(*--it == expected);
+        }
+        REQUIRE(it == tree.begin());
+
+        REQUIRE(std::ranges::equal(std::ranges::subrange(tree.rbegin(), tree.rend()),
+            std::array{ 7, 6, 5, 4, 3, 2, 1 }));
+        REQUIRE(std::ranges::equal(tree | std::views::reverse,
+            std::array{ 7, 6, 5, 4, 3, 2, 1 }));
+    }
+
+    SUBCASE("empty tree")
+    {
+        const binary_tree<int> tree;
+
+        REQUIRE(tree.begin() == tree.end());
+        REQUIRE(tree.rbegin() == tree.rend());
+        REQUIRE(tree.pre_order().empty());
+        REQUIRE(tree.post_order().empty());
+    }
+
+    SUBCASE("copies are independent")
+    {
+        const binary_tree tree{ 2, 1, 3 };
+
+        auto it = tree.begin();
+        const auto copy = it++;
+
+        REQUIRE(*copy == 1);
+        REQUIRE(*it == 2);
+        REQUIRE(*std::prev(it) == 1);
+    }
+
+    SUBCASE("iterators survive rebalancing")
+    {
+        binary_tree<int, red_black_balancing> tree{ 0 };
+
+        const auto first = tree.begin();
+        const auto last = tree.end();
+        for (int i = 1; i < 1000; ++i)
+        {
+            tree.insert(i);
+        }
+
+        REQUIRE(first == tree.begin());
+        REQUIRE(*first == 0);
+        REQUIRE(*std::prev(last) == 999);
+        REQUIRE(std::distance(first, last) == 1000);
+    }
+
+    SUBCASE("pre-order and post-order of a balanced tree")
+    {
+        // {1..7} inserted in order into a red-black tree:
+        //        2
+        //      /   \
+        //     1     4
+        //          / \
+        //         3   6
+        //            / \
+        //           5   7
+        binary_tree<int, red_black_balancing> tree;
+        for (int i = 1; i <= 7; ++i)
+        {
+            tree.insert(i);
+        }
+
+        REQUIRE(std::ranges::equal(tree.pre_order(), std::array{ 2, 1, 4, 3, 6, 5, 7 }));
+        REQUIRE(std::ranges::equal(tree.post_order(), std::array{ 1, 3, 5, 7, 6, 4, 2 }));
+    }
+}
+
+TEST_CASE("binary_tree bulk construction")
+{
+    using namespace caff;
+
+    std::vector<int> sorted(10'000);
+    std::iota(sorted.begin(), sorted.end(), 0);
+
+    auto shuffled = sorted;
+    std::ranges::shuffle(shuffled, std::mt19937{ 42 });
+
+    // as short as any tree of that size can be
+    const auto shortest = static_cast<std::size_t>(std::bit_width(sorted.size()));
+
+    SUBCASE("from sorted values")
+    {
+        const binary_tree unbalanced(sorted);
+        const binary_tree<int, red_black_balancing> red_black(sorted);
+        const binary_tree<int, avl_balancing> avl(sorted);
+
+        REQUIRE(unbalanced.size() == sorted.size());
+        REQUIRE(std::ranges::equal(unbalanced, sorted));
+        REQUIRE(std::ranges::equal(red_black, sorted));
+        REQUIRE(std::ranges::equal(avl, sorted));
+
+        REQUIRE(unbalanced.height() == shortest);
+        REQUIRE(red_black.height() == shortest);
+        REQUIRE(avl.height() == shortest);
+    }
+
+    SUBCASE("from unsorted values")
+    {
+        const binary_tree<int, red_black_balancing> tree(shuffled);
+
+        REQUIRE(std::ranges::equal(tree, sorted));
+        REQUIRE(tree.height() == shortest);
+    }
+
+    SUBCASE("small trees")
+    {
+        for (int n = 0; n <= 20; ++n)
+        {
+            const binary_tree<int, avl_balancing> tree(std::views::iota(0, n));
+
+            REQUIRE(tree.size() == static_cast<std::size_t>(n));
+            REQUIRE(std::ranges::equal(tree, std::views::iota(0, n)));
+            REQUIRE(tree.height() == static_cast<std::size_t>(std::bit_width(static_cast<unsigned>(n))));
+        }
+
+        // the middle value goes on top, the larger half on the left
+        const binary_tree tree(std::array{ 1, 2, 3, 4 });
+        REQUIRE(std::ranges::equal(tree.level_order(), std::array{ 3, 2, 4, 1 }));
+    }
+
+    SUBCASE("from an input range")
+    {
+        std::istringstream input{ "5 3 9 1 7" };
+        const binary_tree<int> tree(std::views::istream<int>(input));
+
+        REQUIRE(std::ranges::equal(tree, std::array{ 1, 3, 5, 7, 9 }));
+    }
+
+    SUBCASE("equal values keep their order")
+    {
+        using entry = std::pair<int, char>;
+        const auto by_key = [](const entry& lhs, const entry& rhs) { return lhs.first < rhs.first; };
+
+        const std::array<entry, 6> values{ { { 2, 'a' }, { 1, 'b' }, { 2, 'c' }, { 1, 'd' }, { 2, 'e' }, { 0, 'f' } } };
+        const binary_tree<entry, red_black_balancing, decltype(by_key)> tree(values, by_key);
+
+        REQUIRE(std::ranges::equal(tree | std::views::values, std::array{ 'f', 'b', 'd', 'a', 'c', 'e' }));
+    }
+
+    SUBCASE("balanced trees stay balanced as they change")
+    {
+        // inserting and erasing only works out if the build left valid
+        // colours and heights behind
+        binary_tree<int, red_black_balancing> red_black(sorted);
+        binary_tree<int, avl_balancing> avl(sorted);
+
+        for (int i = 0; i < 5'000; ++i)
+        {
+            red_black.insert(-i - 1);
+            avl.insert(-i - 1);
+            REQUIRE(red_black.erase(2 * i) == 1);
+            REQUIRE(avl.erase(2 * i) == 1);
+        }
+
+        const auto n = static_cast<double>(red_black.size());
+        REQUIRE(red_black.size() == sorted.size());
+        REQUIRE(std::ranges::equal(red_black, avl));
+        REQUIRE(static_cast<double>(red_black.height()) <= 2 * std::log2(n + 1));
+        REQUIRE(static_cast<double>(avl.height()) <= 1.4405 * std::log2(n + 2));
+    }
+
+    SUBCASE("from another tree")
+    {
+        const auto source = make_tree<binary_tree<int>>(shuffled);
+        const binary_tree<int, avl_balancing> tree(source);
+
+        REQUIRE(std::ranges::equal(tree, source));
+        REQUIRE(tree.height() == shortest);
+    }
+
+    SUBCASE("assign_range")
+    {
+        binary_tree<int, red_black_balancing> tree{ 100, 200 };
+        tree.assign_range(shuffled);
+
+        REQUIRE(std::ranges::equal(tree, sorted));
+        REQUIRE(tree.height() == shortest);
+
+        // a copy of a bulk-built tree is its own
+        auto copy = tree;
+        tree.assign_range(std::array{ 3, 2, 1 });
+
+        REQUIRE(std::ranges::equal(tree, std::array{ 1, 2, 3 }));
+        REQUIRE(std::ranges::equal(copy, sorted));
+
+        tree.assign_range(std::vector<int>{});
+        REQUIRE(tree.empty());
+    }
+}
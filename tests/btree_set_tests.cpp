@@ -0,0 +1,256 @@
+#include <doctest/doctest.h>
+
+import data_structures;
+
+namespace
+{
+    // walks the set and a std::set through the same random inserts and
+    // erases, checking that they agree after every step
+    template <std::size_t NodeBytes>
+    void check_against_std_set(int operations, int key_range)
+    {
+        caff::btree_set<int, NodeBytes> set;
+        std::set<int> expected;
+        std::mt19937 engine{ 7 };
+        std::uniform_int_distribution<int> keys{ 0, key_range };
+
+        for (int i = 0; i < operations; ++i)
+        {
+            const auto key = keys(engine);
+
+            // insert more often than erase at first, so the tree grows, and
+            // the other way around later, so it shrinks again
+            if ((engine() % 3 == 0) == (i < operations / 2))
+            {
+                REQUIRE(set.erase(key) == expected.erase(key));
+            }
+            else
+            {
+                const auto [pos, inserted] = set.insert(key);
+                REQUIRE(inserted == expected.insert(key).second);
+                REQUIRE(*pos == key);
+            }
+
+            REQUIRE(set.size() == expected.size());
+        }
+
+        REQUIRE(std::ranges::equal(set, expected));
+        REQUIRE(std::ranges::equal(set | std::views::reverse, expected | std::views::reverse));
+
+        for (int key = -1; key <= key_range + 1; ++key)
+        {
+            REQUIRE(set.contains(key) == expected.contains(key));
+
+            const auto lower = expected.lower_bound(key);
+            if (lower == expected.end())
+            {
+                REQUIRE(set.lower_bound(key) == set.end());
+            }
+            else
+            {
+                REQUIRE(*set.lower_bound(key) == *lower);
+            }
+        }
+    }
+}
+
+TEST_CASE("btree_set")
+{
+    using namespace caff;
+
+    SUBCASE("member types")
+    {
+        using test_type = btree_set<int>;
+
+        static_assert(std::is_same_v<test_type::value_type, int>);
+        static_assert(std::is_same_v<test_type::size_type, std::size_t>);
+        static_assert(std::is_same_v<test_type::key_compare, std::less<int>>);
+        static_assert(std::bidirectional_iterator<test_type::const_iterator>);
+        static_assert(std::ranges::bidirectional_range<test_type>);
+    }
+
+    SUBCASE("node capacities follow the node size")
+    {
+        static_assert(btree_set<int, 64>::leaf_capacity == 10);
+        static_assert(btree_set<int, 256>::leaf_capacity == 58);
+        static_assert(btree_set<int, 256>::fanout == 21);
+
+        // never fewer than four, however small the node
+        static_assert(btree_set<std::string, 64>::leaf_capacity == 4);
+        static_assert(btree_set<std::string, 64>::fanout == 4);
+    }
+
+    SUBCASE("default constructor")
+    {
+        const btree_set<int> set;
+
+        REQUIRE(set.empty());
+        REQUIRE(set.size() == 0);
+        REQUIRE(set.height() == 0);
+        REQUIRE(set.begin() == set.end());
+        REQUIRE(set.lower_bound(0) == set.end());
+        REQUIRE_FALSE(set.contains(0));
+    }
+
+    SUBCASE("initializer_list constructor")
+    {
+        const btree_set<int> set{ 5, 3, 9, 3, 1, 7 };
+
+        REQUIRE(set.size() == 5);
+        REQUIRE(std::ranges::equal(set, std::array{ 1, 3, 5, 7, 9 }));
+        REQUIRE(std::ranges::equal(set.in_order(), std::array{ 1, 3, 5, 7, 9 }));
+    }
+
+    SUBCASE("range constructor")
+    {
+        const std::vector values{ 5, 3, 9, 3, 1, 7 };
+
+        const btree_set set(values);
+        static_assert(std::is_same_v<decltype(set), const btree_set<int>>);
+        REQUIRE(std::ranges::equal(set, std::array{ 1, 3, 5, 7, 9 }));
+
+        const btree_set<int, 64, std::greater<int>> descending(std::views::iota(0, 1000));
+        REQUIRE(descending.size() == 1000);
+        REQUIRE(descending.height() > 2);
+        REQUIRE(std::ranges::equal(descending, std::views::iota(0, 1000) | std::views::reverse));
+    }
+
+    SUBCASE("assign_range")
+    {
+        btree_set<int, 64> set{ 100, 200 };
+
+        set.assign_range(std::views::iota(0, 500) | std::views::transform([](int i) { return i % 250; }));
+        REQUIRE(set.size() == 250);
+        REQUIRE(std::ranges::equal(set, std::views::iota(0, 250)));
+
+        set.assign_range(std::vector<int>{ });
+        REQUIRE(set.empty());
+        REQUIRE(set.height() == 0);
+    }
+
+    SUBCASE("insert")
+    {
+        btree_set<int, 64> set;
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            const auto [pos, inserted] = set.insert(i);
+            REQUIRE(inserted);
+            REQUIRE(*pos == i);
+        }
+
+        const auto [pos, inserted] = set.insert(500);
+        REQUIRE_FALSE(inserted);
+        REQUIRE(*pos == 500);
+
+        REQUIRE(set.size() == 1000);
+        REQUIRE(set.height() > 2);
+        REQUIRE(std::ranges::equal(set, std::views::iota(0, 1000)));
+    }
+
+    SUBCASE("erase")
+    {
+        btree_set<int, 64> set;
+        for (int i = 0; i < 1000; ++i)
+        {
+            set.insert(i);
+        }
+
+        REQUIRE(set.erase(1000) == 0);
+
+        for (int i = 0; i < 1000; i += 2)
+        {
+            REQUIRE(set.erase(i) == 1);
+        }
+
+        REQUIRE(set.size() == 500);
+        REQUIRE(std::ranges::equal(set, std::views::iota(0, 500)
+            | std::views::transform([](int i) { return 2 * i + 1; })));
+
+        auto pos = set.erase(set.find(501));
+        REQUIRE(*pos == 503);
+
+        while (!set.empty())
+        {
+            pos = set.erase(set.begin());
+        }
+
+        REQUIRE(pos == set.end());
+        REQUIRE(set.height() == 0);
+    }
+
+    SUBCASE("agrees with std::set")
+    {
+        check_against_std_set<64>(20000, 3000);
+        check_against_std_set<256>(20000, 3000);
+    }
+
+    SUBCASE("bounds")
+    {
+        const btree_set<int, 64> set{ 10, 20, 30, 40, 50, 60, 70, 80, 90, 100, 110, 120 };
+
+        REQUIRE(*set.lower_bound(20) == 20);
+        REQUIRE(*set.upper_bound(20) == 30);
+        REQUIRE(*set.lower_bound(25) == 30);
+        REQUIRE(set.upper_bound(120) == set.end());
+        REQUIRE(*std::prev(set.end()) == 120);
+
+        const auto [first, last] = set.equal_range(50);
+        REQUIRE(std::distance(first, last) == 1);
+        REQUIRE(set.find(55) == set.end());
+    }
+
+    SUBCASE("copy and move")
+    {
+        btree_set<int, 64> set;
+        for (int i = 0; i < 500; ++i)
+        {
+            set.insert(i * 7 % 500);
+        }
+
+        btree_set<int, 64> copy(set);
+        REQUIRE(copy == set);
+        REQUIRE(std::ranges::equal(copy | std::views::reverse, set | std::views::reverse));
+
+        copy.erase(3);
+        REQUIRE(copy != set);
+        REQUIRE(set.contains(3));
+
+        btree_set<int, 64> moved(std::move(copy));
+        REQUIRE(moved.size() == 499);
+        REQUIRE(copy.empty());
+
+        copy = moved;
+        REQUIRE(copy == moved);
+
+        set = std::move(moved);
+        REQUIRE(set == copy);
+    }
+
+    SUBCASE("custom comparator")
+    {
+        const btree_set<int, 256, std::greater<int>> set{ 1, 5, 3, 4, 2 };
+
+        REQUIRE(std::ranges::equal(set, std::array{ 5, 4, 3, 2, 1 }));
+        REQUIRE(*set.lower_bound(6) == 5);
+        REQUIRE(*set.upper_bound(3) == 2);
+    }
+
+    SUBCASE("transparent lookup")
+    {
+        using namespace std::string_view_literals;
+
+        btree_set<std::string, 64, std::less<>> set;
+        for (int i = 0; i < 100; ++i)
+        {
+            set.insert(std::to_string(i));
+        }
+
+        REQUIRE(set.contains("42"sv));
+        REQUIRE(*set.find("7"sv) == "7");
+        REQUIRE(*set.lower_bound("98a"sv) == "99");
+        REQUIRE(set.erase("42"sv) == 1);
+        REQUIRE_FALSE(set.contains("42"sv));
+        REQUIRE(set.size() == 99);
+    }
+}
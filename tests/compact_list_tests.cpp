@@ -0,0 +1,245 @@
+#include <doctest/doctest.h>
+import data_structures;
+
+TEST_CASE("compact_list")
+{
+    using namespace caff;
+
+    SUBCASE("member types")
+    {
+        using test_type = compact_list<int>;
+
+        static_assert(std::is_same_v<test_type::value_type, int>);
+        static_assert(std::is_same_v<test_type::size_type, std::size_t>);
+        static_assert(std::is_same_v<test_type::reference, int&>);
+        static_assert(std::is_same_v<test_type::const_reference, const int&>);
+        static_assert(std::is_same_v<test_type::iterator, compact_list_iterator<int>>);
+        static_assert(std::is_same_v<test_type::const_iterator, compact_list_const_iterator<int>>);
+        static_assert(std::is_same_v<test_type::index_type, std::uint32_t>);
+        static_assert(sizeof(test_type::slot) == 12);
+    }
+
+    SUBCASE("default constructor")
+    {
+        const compact_list<int> list;
+        REQUIRE(list.empty());
+        REQUIRE(list.size() == 0);
+        REQUIRE(list.capacity() == 0);
+        REQUIRE(list.begin() == list.end());
+    }
+
+    SUBCASE("initializer_list constructor")
+    {
+        const compact_list<std::string> list{ "a", "b", "c" };
+        REQUIRE(list.size() == 3);
+        REQUIRE(list.capacity() == 3);
+        REQUIRE(list.front() == "a");
+        REQUIRE(list.back() == "c");
+
+        const auto values = list | std::ranges::to<std::vector>();
+        REQUIRE(values == std::vector<std::string>{ "a", "b", "c" });
+
+        const auto reversed = list | std::views::reverse | std::ranges::to<std::vector>();
+        REQUIRE(reversed == std::vector<std::string>{ "c", "b", "a" });
+    }
+
+    SUBCASE("copy and move")
+    {
+        compact_list other{ 1, 2, 3 };
+
+        const compact_list copy{ other };
+        REQUIRE(copy == other);
+
+        const compact_list moved{ std::move(other) };
+        REQUIRE(moved == copy);
+        REQUIRE(other.empty());
+
+        other = moved;
+        REQUIRE(other == moved);
+
+        other = { 4, 5 };
+        REQUIRE(other == compact_list{ 4, 5 });
+    }
+
+    SUBCASE("insert and erase")
+    {
+        compact_list list{ 1, 2, 3 };
+
+        auto pos = list.insert(std::next(list.begin()), 9);
+        REQUIRE(*pos == 9);
+        REQUIRE(list == compact_list{ 1, 9, 2, 3 });
+
+        pos = list.erase(pos);
+        REQUIRE(*pos == 2);
+        REQUIRE(list == compact_list{ 1, 2, 3 });
+
+        pos = list.insert(list.end(), { 4, 5 });
+        REQUIRE(*pos == 4);
+        REQUIRE(list == compact_list{ 1, 2, 3, 4, 5 });
+
+        pos = list.erase(std::next(list.begin()), std::prev(list.end()));
+        REQUIRE(*pos == 5);
+        REQUIRE(list == compact_list{ 1, 5 });
+    }
+
+    SUBCASE("erased slots are reused")
+    {
+        compact_list list{ 1, 2, 3, 4 };
+        const auto capacity = list.capacity();
+
+        for (int i = 0; i < 100; ++i)
+        {
+            list.pop_front();
+            list.push_back(i);
+        }
+
+        REQUIRE(list.capacity() == capacity);
+        REQUIRE(list == compact_list{ 96, 97, 98, 99 });
+    }
+
+    SUBCASE("iterators survive growth")
+    {
+        compact_list<int> list;
+        list.push_back(1);
+        const auto first = list.begin();
+        const auto* address = std::addressof(*first);
+
+        for (int i = 2; i <= 1000; ++i)
+        {
+            list.push_back(i);
+        }
+
+        REQUIRE(list.capacity() >= 1000);
+        REQUIRE(std::addressof(*first) != address);
+        REQUIRE(*first == 1);
+        REQUIRE(*std::next(first) == 2);
+    }
+
+    SUBCASE("emplace and push")
+    {
+        compact_list<std::string> list;
+        list.emplace_back(2, 'b');
+        list.emplace_front("a");
+        list.push_back(std::string(100, 'c'));
+        list.emplace(std::prev(list.end()), "x");
+
+        const auto values = list | std::ranges::to<std::vector>();
+        REQUIRE(values == std::vector<std::string>{ "a", "bb", "x", std::string(100, 'c') });
+
+        list.pop_back();
+        list.pop_front();
+        REQUIRE(list.front() == "bb");
+        REQUIRE(list.back() == "x");
+    }
+
+    SUBCASE("inserting an element of a full list")
+    {
+        // long enough not to fit in the string itself, so reading a freed
+        // one is caught
+        const std::string first(100, 'a');
+        const std::string last(100, 'b');
+
+        compact_list<std::string> list{ first, last };
+        REQUIRE(list.size() == list.capacity());
+
+        list.push_back(list.front());
+        list.insert(list.begin(), *std::prev(list.end()));
+
+        const auto values = list | std::ranges::to<std::vector>();
+        REQUIRE(values == std::vector<std::string>{ first, first, last, first });
+    }
+
+    SUBCASE("compact renumbers nodes in traversal order")
+    {
+        compact_list<int> list;
+        for (int i = 0; i < 100; ++i)
+        {
+            list.push_front(i);
+        }
+        list.erase(std::next(list.begin(), 10), std::next(list.begin(), 20));
+
+        const auto expected = list | std::ranges::to<std::vector>();
+
+        list.compact();
+        REQUIRE(list.capacity() == list.size());
+        REQUIRE(std::ranges::equal(list, expected));
+        REQUIRE(std::ranges::equal(list | std::views::reverse, expected | std::views::reverse));
+
+        // consecutive elements are now adjacent in memory
+        const auto* first = std::addressof(list.front());
+        for (std::size_t i = 0; const auto& value : list)
+        {
+            REQUIRE(reinterpret_cast<const std::byte*>(std::addressof(value)) ==
+                reinterpret_cast<const std::byte*>(first) + i * sizeof(compact_list<int>::slot));
+            ++i;
+        }
+
+        list.push_back(-1);
+        REQUIRE(list.back() == -1);
+    }
+
+    SUBCASE("compact of an empty list frees the slots")
+    {
+        compact_list list{ 1, 2, 3 };
+        list.clear();
+        list.compact();
+        REQUIRE(list.capacity() == 0);
+
+        list.push_back(1);
+        REQUIRE(list == compact_list{ 1 });
+    }
+
+    SUBCASE("matches std::list under random edits")
+    {
+        compact_list<int> list;
+        std::list<int> expected;
+
+        std::mt19937 gen{ 42 };
+        for (int i = 0; i < 2000; ++i)
+        {
+            const auto index = expected.empty() ? 0 :
+                std::uniform_int_distribution<std::size_t>{ 0,
+                    expected.size() - 1 }(gen);
+
+            if (expected.empty() || gen() % 3 != 0)
+            {
+                list.insert(std::next(list.begin(), index), i);
+                expected.insert(std::next(expected.begin(), index), i);
+            }
+            else
+            {
+                list.erase(std::next(list.begin(), index));
+                expected.erase(std::next(expected.begin(), index));
+            }
+
+            if (i % 500 == 0)
+            {
+                list.compact();
+            }
+        }
+
+        REQUIRE(list.size() == expected.size());
+        REQUIRE(std::ranges::equal(list, expected));
+    }
+
+    SUBCASE("allocator")
+    {
+        using allocator_type = std::pmr::polymorphic_allocator<int>;
+
+        std::pmr::monotonic_buffer_resource resource;
+        compact_list<int, allocator_type> list{ { 1, 2, 3 }, allocator_type{ &resource } };
+        REQUIRE(list.get_allocator().resource() == &resource);
+
+        list.compact();
+        REQUIRE(list == compact_list<int, allocator_type>{ 1, 2, 3 });
+    }
+
+    SUBCASE("three-way comparison operator")
+    {
+        const compact_list list{ 1, 3, 5 };
+
+        REQUIRE((list <=> compact_list{ 1, 3, 5 }) == std::strong_ordering::equal);
+        REQUIRE((list <=> compact_list{ 1, 3 }) == std::strong_ordering::greater);
+        REQUIRE((list <=> compact_list{ 1, 4 }) == std::strong_ordering::less);
+    }
+}
@@ -2,7 +2,734 @@
 
 import data_structures;
 
-TEST_CASE("doubly_linked_list tests")
+namespace
 {
+    struct move_only
+    {
+        explicit move_only(int v) : value{ v }
+        {
+        }
+
+        move_only(move_only&&) = default;
+        move_only& operator=(move_only&&) = default;
+
+        int value;
+    };
+
+    // throws when constructed from a negative value
+    struct throws_on_negative
+    {
+        throws_on_negative(int v) : value{ v }
+        {
+            if (v < 0)
+            {
+                throw std::invalid_argument{ "negative" };
+            }
+        }
+
+        int value;
+    };
+
+    // a copy constructor that throws once copies_left runs out, and a move
+    // constructor that may throw, so moving it falls back to copying
+    struct throws_on_copy
+    {
+        explicit throws_on_copy(int v) : value{ v }
+        {
+        }
+
+        throws_on_copy(const throws_on_copy& other) : value{ other.value }
+        {
+            if (copies_left-- == 0)
+            {
+                throw std::runtime_error{ "copy" };
+            }
+        }
+
+        throws_on_copy(throws_on_copy&& other) noexcept(false) : value{ other.value }
+        {
+        }
+
+        static inline int copies_left{ 0 };
+        int value;
+    };
+
+    // shared by every rebound limited_allocator
+    struct allocation_limit
+    {
+        static inline std::size_t allocations_left{ std::numeric_limits<std::size_t>::max() };
+    };
+
+    // throws std::bad_alloc once allocation_limit runs out
+    template <typename T>
+    struct limited_allocator
+    {
+        using value_type = T;
+
+        limited_allocator() = default;
+
+        template <typename U>
+        limited_allocator(const limited_allocator<U>&) noexcept
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            if (allocation_limit::allocations_left == 0)
+            {
+                throw std::bad_alloc{};
+            }
+            --allocation_limit::allocations_left;
+            return std::allocator<T>{}.allocate(n);
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept
+        {
+            std::allocator<T>{}.deallocate(p, n);
+        }
+
+        template <typename U>
+        bool operator==(const limited_allocator<U>&) const noexcept
+        {
+            return true;
+        }
+    };
 }
 
+TEST_CASE("doubly_linked_list tests")
+{
+    using namespace caff;
+
+    SUBCASE("member types")
+    {
+        using test_type = doubly_linked_list<std::string>;
+
+        static_assert(std::is_same_v<test_type::value_type, std::string>);
+        static_assert(std::is_same_v<test_type::size_type, std::size_t>);
+        static_assert(std::is_same_v<test_type::reference, std::string&>);
+        static_assert(std::is_same_v<test_type::const_reference, const std::string&>);
+        static_assert(std::is_same_v<test_type::allocator_type, std::allocator<std::string>>);
+        static_assert(std::bidirectional_iterator<test_type::iterator>);
+        static_assert(std::bidirectional_iterator<test_type::const_iterator>);
+    }
+
+    SUBCASE("default constructor")
+    {
+        const doubly_linked_list<int> list;
+        REQUIRE(list.empty());
+        REQUIRE(list.size() == 0);
+        REQUIRE(list.begin() == list.end());
+    }
+
+    SUBCASE("initializer_list constructor")
+    {
+        const doubly_linked_list<std::string> list{ "a", "b", "c" };
+        REQUIRE(list.size() == 3);
+        REQUIRE(list.front() == "a");
+        REQUIRE(list.back() == "c");
+
+        const auto values = list | std::ranges::to<std::vector>();
+        REQUIRE(values == std::vector<std::string>{ "a", "b", "c" });
+
+        const auto reversed = list | std::views::reverse | std::ranges::to<std::vector>();
+        REQUIRE(reversed == std::vector<std::string>{ "c", "b", "a" });
+    }
+
+    SUBCASE("copy constructor")
+    {
+        const doubly_linked_list other{ 1, 2, 3 };
+        const doubly_linked_list list{ other };
+        REQUIRE(list == other);
+        REQUIRE(list.begin() != other.begin());
+    }
+
+    SUBCASE("move constructor")
+    {
+        doubly_linked_list other{ 1, 2, 3 };
+        const auto* first = std::addressof(other.front());
+
+        const doubly_linked_list list{ std::move(other) };
+        REQUIRE(std::addressof(list.front()) == first);
+        REQUIRE(list.size() == 3);
+        REQUIRE(other.empty());
+        REQUIRE(other.size() == 0);
+    }
+
+    SUBCASE("move assignment operator")
+    {
+        doubly_linked_list other{ 1, 2, 3 };
+        doubly_linked_list list{ 4 };
+
+        list = std::move(other);
+        REQUIRE(list == doubly_linked_list{ 1, 2, 3 });
+        REQUIRE(other.empty());
+    }
+
+    SUBCASE("insert")
+    {
+        doubly_linked_list list{ 1, 2, 3 };
+
+        SUBCASE("insert at begin")
+        {
+            auto pos = list.insert(list.begin(), 0);
+            REQUIRE(*pos == 0);
+            REQUIRE(list == doubly_linked_list{ 0, 1, 2, 3 });
+        }
+
+        SUBCASE("insert in middle returns the new element")
+        {
+            auto pos = list.insert(std::next(list.begin()), 9);
+            REQUIRE(*pos == 9);
+            REQUIRE(*std::prev(pos) == 1);
+            REQUIRE(*std::next(pos) == 2);
+            REQUIRE(list == doubly_linked_list{ 1, 9, 2, 3 });
+        }
+
+        SUBCASE("insert at end")
+        {
+            auto pos = list.insert(list.end(), 4);
+            REQUIRE(*pos == 4);
+            REQUIRE(list.back() == 4);
+        }
+
+        SUBCASE("insert range")
+        {
+            const std::vector other{ 7, 8 };
+            auto pos = list.insert(std::next(list.begin()), other.begin(), other.end());
+            REQUIRE(*pos == 7);
+            REQUIRE(list.size() == 5);
+            REQUIRE(list == doubly_linked_list{ 1, 7, 8, 2, 3 });
+        }
+
+        SUBCASE("insert empty range")
+        {
+            const std::vector<int> other;
+            auto pos = list.insert(std::next(list.begin()), other.begin(), other.end());
+            REQUIRE(*pos == 2);
+            REQUIRE(list.size() == 3);
+        }
+    }
+
+    SUBCASE("insert range is all or nothing")
+    {
+        doubly_linked_list<throws_on_negative> list;
+        list.emplace_back(1);
+        list.emplace_back(2);
+
+        const std::vector values{ 3, 4, -1, 5 };
+        REQUIRE_THROWS_AS(list.insert(std::next(list.begin()), values.begin(), values.end()),
+            std::invalid_argument);
+
+        REQUIRE(list.size() == 2);
+        REQUIRE(list.front().value == 1);
+        REQUIRE(list.back().value == 2);
+    }
+
+    SUBCASE("matches std::list under random edits")
+    {
+        doubly_linked_list<int> list;
+        std::list<int> expected;
+
+        std::mt19937 gen{ 42 };
+        for (int i = 0; i < 2000; ++i)
+        {
+            const auto index = expected.empty() ? 0 :
+                std::uniform_int_distribution<std::size_t>{ 0,
+                    expected.size() - 1 }(gen);
+
+            if (expected.empty() || gen() % 3 != 0)
+            {
+                list.insert(std::next(list.begin(), index), { i, -i });
+                expected.insert(std::next(expected.begin(), index), { i, -i });
+            }
+            else
+            {
+                list.erase(std::next(list.begin(), index));
+                expected.erase(std::next(expected.begin(), index));
+            }
+        }
+
+        REQUIRE(list.size() == expected.size());
+        REQUIRE(std::ranges::equal(list, expected));
+        REQUIRE(std::ranges::equal(list | std::views::reverse, expected | std::views::reverse));
+    }
+
+    SUBCASE("emplace")
+    {
+        doubly_linked_list<std::string> list{ "b" };
+
+        auto pos = list.emplace(list.begin(), 2, 'a');
+        REQUIRE(*pos == "aa");
+        REQUIRE(list.emplace_back(1, 'c') == "c");
+        REQUIRE(list.emplace_front("z") == "z");
+
+        const auto values = list | std::ranges::to<std::vector>();
+        REQUIRE(values == std::vector<std::string>{ "z", "aa", "b", "c" });
+    }
+
+    SUBCASE("push rvalues")
+    {
+        doubly_linked_list<std::string> list;
+
+        std::string value(100, 'x');
+        const auto* data = value.data();
+
+        list.push_back(std::move(value));
+        REQUIRE(list.back().data() == data);
+    }
+
+    SUBCASE("move-only type")
+    {
+        doubly_linked_list<move_only> list;
+        list.emplace_back(2);
+        list.push_front(move_only{ 1 });
+        list.emplace(list.end(), 3);
+
+        const auto values = list
+            | std::views::transform(&move_only::value)
+            | std::ranges::to<std::vector>();
+        REQUIRE(values == std::vector{ 1, 2, 3 });
+    }
+
+    SUBCASE("erase")
+    {
+        doubly_linked_list list{ 1, 2, 3 };
+
+        SUBCASE("erase from front")
+        {
+            auto pos = list.erase(list.begin());
+            REQUIRE(*pos == 2);
+            REQUIRE(list == doubly_linked_list{ 2, 3 });
+        }
+
+        SUBCASE("erase from middle")
+        {
+            auto pos = list.erase(std::next(list.begin()));
+            REQUIRE(*pos == 3);
+            REQUIRE(list == doubly_linked_list{ 1, 3 });
+        }
+
+        SUBCASE("erase from end")
+        {
+            auto pos = list.erase(std::prev(list.end()));
+            REQUIRE(pos == list.end());
+            REQUIRE(list.back() == 2);
+        }
+    }
+
+    SUBCASE("pop")
+    {
+        doubly_linked_list list{ 1, 2, 3 };
+
+        list.pop_front();
+        list.pop_back();
+        REQUIRE(list.size() == 1);
+        REQUIRE(list.front() == 2);
+        REQUIRE(list.back() == 2);
+
+        list.pop_back();
+        REQUIRE(list.empty());
+    }
+
+    SUBCASE("swap")
+    {
+        doubly_linked_list list{ 1, 2, 3 };
+        doubly_linked_list other{ 4 };
+
+        swap(list, other);
+        REQUIRE(list == doubly_linked_list{ 4 });
+        REQUIRE(other == doubly_linked_list{ 1, 2, 3 });
+    }
+
+    SUBCASE("end is a sentinel")
+    {
+        doubly_linked_list list{ 1, 2, 3 };
+        const auto last = list.end();
+
+        REQUIRE(*std::prev(list.end()) == 3);
+        REQUIRE(std::next(list.end()) == list.begin());
+
+        // end() stays valid across insertions and erasures
+        list.push_back(4);
+        list.pop_front();
+        REQUIRE(list.end() == last);
+        REQUIRE(*std::prev(last) == 4);
+
+        list.clear();
+        REQUIRE(list.begin() == last);
+        REQUIRE(std::prev(last) == last);
+    }
+
+    SUBCASE("swap and move keep the sentinels separate")
+    {
+        doubly_linked_list list{ 1, 2, 3 };
+        doubly_linked_list<int> other;
+
+        swap(list, other);
+        REQUIRE(list.empty());
+        REQUIRE(list.begin() == list.end());
+        REQUIRE(*std::prev(other.end()) == 3);
+
+        list = std::move(other);
+        REQUIRE(other.empty());
+        REQUIRE(*std::prev(list.end()) == 3);
+        REQUIRE(std::next(list.begin(), 3) == list.end());
+
+        other.push_back(7);
+        REQUIRE(other.front() == 7);
+        REQUIRE(other.back() == 7);
+    }
+
+    SUBCASE("splice single element")
+    {
+        doubly_linked_list list{ 1, 2, 3 };
+        doubly_linked_list other{ 4, 5 };
+
+        SUBCASE("from another list")
+        {
+            const auto* moved = std::addressof(other.front());
+            list.splice(std::next(list.begin()), other, other.begin());
+
+            REQUIRE(list == doubly_linked_list{ 1, 4, 2, 3 });
+            REQUIRE(other == doubly_linked_list{ 5 });
+            REQUIRE(list.size() == 4);
+            REQUIRE(other.size() == 1);
+            REQUIRE(std::addressof(*std::next(list.begin())) == moved);
+        }
+
+        SUBCASE("within the same list")
+        {
+            list.splice(list.begin(), list, std::prev(list.end()));
+            REQUIRE(list == doubly_linked_list{ 3, 1, 2 });
+
+            list.splice(list.end(), list, list.begin());
+            REQUIRE(list == doubly_linked_list{ 1, 2, 3 });
+            REQUIRE(list.size() == 3);
+        }
+
+        SUBCASE("to its own position")
+        {
+            list.splice(std::next(list.begin()), list, list.begin());
+            list.splice(list.begin(), list, list.begin());
+            REQUIRE(list == doubly_linked_list{ 1, 2, 3 });
+        }
+    }
+
+    SUBCASE("splice whole list")
+    {
+        doubly_linked_list list{ 1, 2, 3 };
+        doubly_linked_list other{ 4, 5 };
+        const auto* first = std::addressof(other.front());
+
+        list.splice(std::next(list.begin()), other);
+        REQUIRE(list == doubly_linked_list{ 1, 4, 5, 2, 3 });
+        REQUIRE(list.size() == 5);
+        REQUIRE(std::addressof(*std::next(list.begin())) == first);
+        REQUIRE(other.empty());
+        REQUIRE(other.begin() == other.end());
+
+        list.splice(list.end(), doubly_linked_list{ 6 });
+        list.splice(list.begin(), other);
+        REQUIRE(list == doubly_linked_list{ 1, 4, 5, 2, 3, 6 });
+        REQUIRE(*std::prev(list.end()) == 6);
+    }
+
+    SUBCASE("splice range")
+    {
+        doubly_linked_list list{ 1, 2, 3 };
+        doubly_linked_list other{ 4, 5, 6, 7 };
+
+        SUBCASE("from another list")
+        {
+            list.splice(list.end(), other, std::next(other.begin()), std::prev(other.end()));
+            REQUIRE(list == doubly_linked_list{ 1, 2, 3, 5, 6 });
+            REQUIRE(other == doubly_linked_list{ 4, 7 });
+            REQUIRE(list.size() == 5);
+            REQUIRE(other.size() == 2);
+            REQUIRE(std::ranges::equal(list | std::views::reverse,
+                std::vector{ 6, 5, 3, 2, 1 }));
+        }
+
+        SUBCASE("within the same list")
+        {
+            list.splice(list.begin(), list, std::next(list.begin()), list.end());
+            REQUIRE(list == doubly_linked_list{ 2, 3, 1 });
+            REQUIRE(list.size() == 3);
+
+            list.splice(list.end(), list, list.begin(), list.begin());
+            REQUIRE(list == doubly_linked_list{ 2, 3, 1 });
+        }
+    }
+
+    SUBCASE("merge")
+    {
+        doubly_linked_list list{ 1, 3, 5, 7 };
+        doubly_linked_list other{ 0, 3, 4, 8, 9 };
+        const auto* moved = std::addressof(*std::next(other.begin(), 2));
+
+        list.merge(other);
+        REQUIRE(list == doubly_linked_list{ 0, 1, 3, 3, 4, 5, 7, 8, 9 });
+        REQUIRE(list.size() == 9);
+        REQUIRE(other.empty());
+        REQUIRE(std::addressof(*std::next(list.begin(), 4)) == moved);
+        REQUIRE(std::ranges::equal(list | std::views::reverse,
+            std::vector{ 9, 8, 7, 5, 4, 3, 3, 1, 0 }));
+
+        SUBCASE("with a comparator")
+        {
+            doubly_linked_list descending{ 9, 2 };
+            descending.merge(doubly_linked_list{ 5, 1 }, std::greater<>{});
+            REQUIRE(descending == doubly_linked_list{ 9, 5, 2, 1 });
+        }
+
+        SUBCASE("into an empty list")
+        {
+            doubly_linked_list<int> empty;
+            empty.merge(list);
+            REQUIRE(empty.size() == 9);
+            REQUIRE(list.empty());
+        }
+
+        SUBCASE("is stable")
+        {
+            using entry = std::pair<int, char>;
+            const auto by_key = [](const entry& lhs, const entry& rhs)
+            {
+                return lhs.first < rhs.first;
+            };
+
+            doubly_linked_list<entry> lhs{ { 1, 'a' }, { 2, 'a' } };
+            doubly_linked_list<entry> rhs{ { 1, 'b' }, { 2, 'b' } };
+            lhs.merge(rhs, by_key);
+            REQUIRE(lhs == doubly_linked_list<entry>{ { 1, 'a' }, { 1, 'b' },
+                { 2, 'a' }, { 2, 'b' } });
+        }
+
+        SUBCASE("a throwing comparator loses no element")
+        {
+            for (int comparisons = 0; comparisons < 8; ++comparisons)
+            {
+                doubly_linked_list lhs{ 1, 3, 5, 7 };
+                doubly_linked_list rhs{ 0, 2, 4, 6, 8 };
+
+                int left{ comparisons };
+                const auto throwing_less = [&left](int a, int b)
+                {
+                    if (left-- == 0)
+                    {
+                        throw std::runtime_error{ "compare" };
+                    }
+                    return a < b;
+                };
+
+                REQUIRE_THROWS_AS(lhs.merge(rhs, throwing_less), std::runtime_error);
+                REQUIRE(lhs.size() == 9);
+                REQUIRE(rhs.empty());
+
+                auto values = lhs | std::ranges::to<std::vector>();
+                REQUIRE(std::ranges::equal(lhs | std::views::reverse, values | std::views::reverse));
+                std::ranges::sort(values);
+                REQUIRE(std::ranges::equal(values, std::views::iota(0, 9)));
+            }
+        }
+    }
+
+    SUBCASE("sort")
+    {
+        SUBCASE("empty and single element lists")
+        {
+            doubly_linked_list<int> list;
+            list.sort();
+            REQUIRE(list.empty());
+            REQUIRE(list.begin() == list.end());
+
+            list.push_back(1);
+            list.sort();
+            REQUIRE(list == doubly_linked_list{ 1 });
+        }
+
+        SUBCASE("matches std::stable_sort and keeps the nodes")
+        {
+            using entry = std::pair<int, int>;
+
+            std::mt19937 gen{ 3 };
+            std::vector<entry> values;
+            for (int i = 0; i < 1000; ++i)
+            {
+                values.emplace_back(static_cast<int>(gen() % 50), i);
+            }
+
+            doubly_linked_list<entry> list;
+            list.insert(list.end(), values.begin(), values.end());
+
+            const auto node_addresses = [&]
+            {
+                auto addresses = list
+                    | std::views::transform([](const entry& e) { return std::addressof(e); })
+                    | std::ranges::to<std::vector>();
+                std::ranges::sort(addresses);
+                return addresses;
+            };
+            const auto addresses = node_addresses();
+
+            const auto by_key = [](const entry& lhs, const entry& rhs)
+            {
+                return lhs.first < rhs.first;
+            };
+            list.sort(by_key);
+            std::ranges::stable_sort(values, by_key);
+
+            REQUIRE(list.size() == values.size());
+            REQUIRE(std::ranges::equal(list, values));
+            REQUIRE(std::ranges::equal(list | std::views::reverse, values | std::views::reverse));
+
+            REQUIRE(node_addresses() == addresses);
+        }
+
+        SUBCASE("with a comparator")
+        {
+            doubly_linked_list list{ 3, 1, 4, 1, 5, 9, 2, 6 };
+            list.sort(std::greater<>{});
+            REQUIRE(list == doubly_linked_list{ 9, 6, 5, 4, 3, 2, 1, 1 });
+            REQUIRE(list.back() == 1);
+        }
+
+        SUBCASE("a throwing comparator loses no element")
+        {
+            std::vector<int> values(100);
+            std::iota(values.begin(), values.end(), 0);
+            std::ranges::shuffle(values, std::mt19937{ 5 });
+
+            for (int comparisons : { 0, 1, 10, 100, 300, 500 })
+            {
+                doubly_linked_list<int> list;
+                list.insert(list.end(), values.begin(), values.end());
+
+                int left{ comparisons };
+                const auto throwing_less = [&left](int a, int b)
+                {
+                    if (left-- == 0)
+                    {
+                        throw std::runtime_error{ "compare" };
+                    }
+                    return a < b;
+                };
+
+                REQUIRE_THROWS_AS(list.sort(throwing_less), std::runtime_error);
+                REQUIRE(list.size() == values.size());
+
+                auto after = list | std::ranges::to<std::vector>();
+                REQUIRE(std::ranges::equal(list | std::views::reverse, after | std::views::reverse));
+                std::ranges::sort(after);
+                REQUIRE(std::ranges::equal(after, std::views::iota(0, 100)));
+            }
+        }
+    }
+
+    SUBCASE("relayout")
+    {
+        // inserting at random positions scatters the traversal order across
+        // the pool's chunks
+        doubly_linked_list<int, pool_allocator<int>> list;
+        std::vector<int> expected;
+
+        std::mt19937 gen{ 5 };
+        for (int i = 0; i < 500; ++i)
+        {
+            const auto index = std::uniform_int_distribution<std::size_t>{ 0,
+                expected.size() }(gen);
+            list.insert(std::next(list.begin(), index), i);
+            expected.insert(std::next(expected.begin(), index), i);
+        }
+        REQUIRE(list.locality() < 0.5);
+
+        list.relayout();
+        REQUIRE(list.size() == expected.size());
+        REQUIRE(std::ranges::equal(list, expected));
+        REQUIRE(std::ranges::equal(list | std::views::reverse, expected | std::views::reverse));
+
+        // the new nodes come out of the pool in address order, apart from
+        // where one of its blocks ends
+        REQUIRE(list.locality() > 0.99);
+
+        SUBCASE("empty and single element lists")
+        {
+            doubly_linked_list<std::string> other;
+            other.relayout();
+            REQUIRE(other.empty());
+            REQUIRE(other.locality() == 1.0);
+
+            other.push_back("a");
+            other.relayout();
+            REQUIRE(other == doubly_linked_list<std::string>{ "a" });
+        }
+
+        SUBCASE("is all or nothing")
+        {
+            doubly_linked_list<throws_on_copy> other;
+            for (int i = 0; i < 4; ++i)
+            {
+                other.emplace_back(i);
+            }
+            const auto* first = std::addressof(other.front());
+
+            throws_on_copy::copies_left = 2;
+            REQUIRE_THROWS_AS(other.relayout(), std::runtime_error);
+            REQUIRE(std::addressof(other.front()) == first);
+            REQUIRE(std::ranges::equal(other | std::views::transform(&throws_on_copy::value),
+                std::views::iota(0, 4)));
+        }
+
+        SUBCASE("is all or nothing when allocating fails")
+        {
+            // std::string moves without throwing, so a failed allocation
+            // must not leave elements moved out of the list
+            doubly_linked_list<std::string, limited_allocator<std::string>> other{
+                "one", "two", "three", "four" };
+            const auto* first = std::addressof(other.front());
+
+            allocation_limit::allocations_left = 2;
+            REQUIRE_THROWS_AS(other.relayout(), std::bad_alloc);
+            allocation_limit::allocations_left = std::numeric_limits<std::size_t>::max();
+
+            REQUIRE(std::addressof(other.front()) == first);
+            REQUIRE(other == doubly_linked_list<std::string, limited_allocator<std::string>>{
+                "one", "two", "three", "four" });
+        }
+    }
+
+    SUBCASE("allocator")
+    {
+        using allocator_type = pool_allocator<int>;
+
+        const allocator_type alloc;
+        doubly_linked_list<int, allocator_type> list{ { 1, 2, 3 }, alloc };
+        REQUIRE(list.get_allocator() == alloc);
+
+        SUBCASE("copy constructor gets its own pool")
+        {
+            const auto copy{ list };
+            REQUIRE(copy.get_allocator() != alloc);
+            REQUIRE(copy == list);
+        }
+
+        SUBCASE("copy assignment keeps the allocator")
+        {
+            doubly_linked_list<int, allocator_type> other{ 4, 5 };
+            const auto other_alloc = other.get_allocator();
+
+            other = list;
+            REQUIRE(other.get_allocator() == other_alloc);
+            REQUIRE(other == list);
+        }
+    }
+
+    SUBCASE("three-way comparison operator")
+    {
+        const doubly_linked_list list{ 1, 3, 5 };
+
+        REQUIRE((list <=> doubly_linked_list{ 1, 3, 5 }) == std::strong_ordering::equal);
+        REQUIRE((list <=> doubly_linked_list{ 1, 3 }) == std::strong_ordering::greater);
+        REQUIRE((list <=> doubly_linked_list{ 1, 4 }) == std::strong_ordering::less);
+    }
+}
@@ -0,0 +1,137 @@
+#include <doctest/doctest.h>
+
+import data_structures;
+
+TEST_CASE("frozen_tree")
+{
+    using namespace caff;
+
+    SUBCASE("member types")
+    {
+        using test_type = frozen_tree<int>;
+
+        static_assert(std::is_same_v<test_type::value_type, int>);
+        static_assert(std::is_same_v<test_type::size_type, std::size_t>);
+        static_assert(std::is_same_v<test_type::key_compare, std::less<int>>);
+        static_assert(std::bidirectional_iterator<test_type::const_iterator>);
+        static_assert(std::ranges::bidirectional_range<test_type>);
+    }
+
+    SUBCASE("default constructor")
+    {
+        const frozen_tree<int> tree;
+
+        REQUIRE(tree.empty());
+        REQUIRE(tree.size() == 0);
+        REQUIRE(tree.begin() == tree.end());
+        REQUIRE(tree.lower_bound(0) == tree.end());
+        REQUIRE_FALSE(tree.contains(0));
+    }
+
+    SUBCASE("from a binary_tree")
+    {
+        binary_tree<int, red_black_balancing> source;
+        for (int i = 0; i < 1000; ++i)
+        {
+            source.insert(i * 2);
+        }
+
+        const frozen_tree tree(source);
+
+        REQUIRE(tree.size() == 1000);
+        REQUIRE(std::ranges::equal(tree, source));
+        REQUIRE(std::ranges::equal(tree.in_order(), source.in_order()));
+    }
+
+    SUBCASE("from unsorted values")
+    {
+        const frozen_tree tree{ 5, 3, 9, 1, 7 };
+
+        REQUIRE(std::ranges::equal(tree, std::array{ 1, 3, 5, 7, 9 }));
+    }
+
+    SUBCASE("lookups agree with a sorted vector")
+    {
+        // every size up to a few complete levels, so the last level is
+        // empty, partly filled and full in turn
+        for (int n = 1; n <= 70; ++n)
+        {
+            std::vector<int> values;
+            for (int i = 0; i < n; ++i)
+            {
+                values.push_back(i * 3);
+            }
+
+            const frozen_tree tree(values);
+            REQUIRE(std::ranges::equal(tree, values));
+
+            for (int key = -1; key <= n * 3; ++key)
+            {
+                const auto expected = std::ranges::lower_bound(values, key);
+                const auto actual = tree.lower_bound(key);
+
+                if (expected == values.end())
+                {
+                    REQUIRE(actual == tree.end());
+                }
+                else
+                {
+                    REQUIRE(*actual == *expected);
+                }
+
+                REQUIRE(tree.contains(key) == (key >= 0 && key % 3 == 0 && key < n * 3));
+            }
+        }
+    }
+
+    SUBCASE("duplicates")
+    {
+        const frozen_tree tree{ 4, 1, 4, 4, 9, 1 };
+
+        REQUIRE(std::ranges::equal(tree, std::array{ 1, 1, 4, 4, 4, 9 }));
+
+        const auto [first, last] = tree.equal_range(4);
+        REQUIRE(std::distance(first, last) == 3);
+        REQUIRE(*last == 9);
+        REQUIRE(*std::prev(first) == 1);
+        REQUIRE(tree.upper_bound(9) == tree.end());
+        REQUIRE(tree.find(5) == tree.end());
+    }
+
+    SUBCASE("backwards")
+    {
+        const frozen_tree tree{ 1, 2, 3, 4, 5, 6 };
+
+        REQUIRE(std::ranges::equal(tree | std::views::reverse, std::array{ 6, 5, 4, 3, 2, 1 }));
+    }
+
+    SUBCASE("custom comparator")
+    {
+        const frozen_tree<int, std::greater<int>> tree{ { 1, 5, 3, 4, 2 } };
+
+        REQUIRE(std::ranges::equal(tree, std::array{ 5, 4, 3, 2, 1 }));
+        REQUIRE(*tree.lower_bound(6) == 5);
+        REQUIRE(*tree.upper_bound(3) == 2);
+    }
+
+    SUBCASE("transparent lookup")
+    {
+        using namespace std::string_view_literals;
+
+        const std::vector<std::string> words{ "pear", "apple", "fig" };
+        const frozen_tree<std::string, std::less<>> tree(words);
+
+        REQUIRE(tree.contains("fig"sv));
+        REQUIRE(*tree.find("pear"sv) == "pear");
+        REQUIRE(*tree.lower_bound("b"sv) == "fig");
+    }
+
+    SUBCASE("storage is cache line aligned")
+    {
+        const frozen_tree tree{ 1, 2, 3 };
+
+        // the root, 2, sits in slot 1, right after the unused slot 0 that
+        // starts the line
+        REQUIRE(reinterpret_cast<std::uintptr_t>(std::addressof(*tree.find(2))) % 64 == 4);
+    }
+}
@@ -0,0 +1,56 @@
+#include <doctest/doctest.h>
+import data_structures;
+
+namespace
+{
+    // retired objects can outlive the test case, so the counter has to be
+    // static
+    std::atomic<int> destroyed{ 0 };
+
+    struct tracked
+    {
+        ~tracked()
+        {
+            destroyed.fetch_add(1);
+        }
+    };
+}
+
+TEST_CASE("hazard_pointer")
+{
+    using namespace caff;
+
+    SUBCASE("protect returns the current value")
+    {
+        int value{ 0 };
+        std::atomic<int*> src{ &value };
+
+        hazard_pointer hp;
+        REQUIRE(hp.protect(src) == &value);
+    }
+
+    SUBCASE("protected objects are not freed until the protection is reset")
+    {
+        destroyed.store(0);
+        std::atomic<tracked*> src{ new tracked{ } };
+
+        hazard_pointer hp;
+        auto* protected_object = hp.protect(src);
+        hazard_retire(protected_object);
+
+        // retire enough unprotected objects to force several scans
+        for (int i = 0; i < 1000; ++i)
+        {
+            hazard_retire(new tracked{ });
+        }
+        REQUIRE(destroyed.load() >= 900);
+        REQUIRE(destroyed.load() < 1001);
+
+        hp.reset_protection();
+        for (int i = 0; i < 1000; ++i)
+        {
+            hazard_retire(new tracked{ });
+        }
+        REQUIRE(destroyed.load() > 1000);
+    }
+}
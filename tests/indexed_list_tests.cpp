@@ -0,0 +1,175 @@
+#include <doctest/doctest.h>
+
+import data_structures;
+
+TEST_CASE("indexed_list")
+{
+    using namespace caff;
+
+    SUBCASE("member types")
+    {
+        using test_type = indexed_list<std::string>;
+
+        static_assert(std::is_same_v<test_type::value_type, std::string>);
+        static_assert(std::is_same_v<test_type::size_type, std::size_t>);
+        static_assert(std::is_same_v<test_type::reference, std::string&>);
+        static_assert(std::is_same_v<test_type::allocator_type, std::allocator<std::string>>);
+        static_assert(std::bidirectional_iterator<test_type::iterator>);
+        static_assert(std::bidirectional_iterator<test_type::const_iterator>);
+    }
+
+    SUBCASE("default constructor")
+    {
+        const indexed_list<int> list;
+        REQUIRE(list.empty());
+        REQUIRE(list.begin() == list.end());
+        REQUIRE(list.nth(0) == list.end());
+        REQUIRE(list.index_of(list.end()) == 0);
+    }
+
+    SUBCASE("nth and index_of")
+    {
+        const indexed_list<std::string> list{ "a", "b", "c", "d" };
+        REQUIRE(list.size() == 4);
+
+        for (std::size_t i = 0; i < list.size(); ++i)
+        {
+            REQUIRE(list.nth(i) == std::next(list.begin(), static_cast<std::ptrdiff_t>(i)));
+            REQUIRE(list.index_of(list.nth(i)) == i);
+        }
+
+        REQUIRE(list[2] == "c");
+        REQUIRE(list.nth(4) == list.end());
+        REQUIRE(list.nth(100) == list.end());
+        REQUIRE(list.index_of(list.end()) == 4);
+    }
+
+    SUBCASE("positional insert and erase")
+    {
+        indexed_list list{ 1, 2, 3 };
+
+        auto pos = list.insert(list.nth(1), 9);
+        REQUIRE(list.index_of(pos) == 1);
+        REQUIRE(list == indexed_list{ 1, 9, 2, 3 });
+
+        pos = list.insert(list.nth(4), { 7, 8 });
+        REQUIRE(list.index_of(pos) == 4);
+        REQUIRE(list == indexed_list{ 1, 9, 2, 3, 7, 8 });
+
+        pos = list.erase(list.nth(2));
+        REQUIRE(*pos == 3);
+        REQUIRE(list.index_of(pos) == 2);
+
+        pos = list.erase(list.nth(1), list.nth(3));
+        REQUIRE(list == indexed_list{ 1, 7, 8 });
+        REQUIRE(list[1] == 7);
+    }
+
+    SUBCASE("front and back")
+    {
+        indexed_list<int> list;
+        list.push_back(2);
+        list.push_front(1);
+        list.emplace_back(3);
+        REQUIRE(list.front() == 1);
+        REQUIRE(list.back() == 3);
+
+        list.pop_front();
+        list.pop_back();
+        REQUIRE(list == indexed_list{ 2 });
+    }
+
+    SUBCASE("iterators stay valid across edits")
+    {
+        indexed_list<int> list;
+        for (int i = 0; i < 100; ++i)
+        {
+            list.push_back(i);
+        }
+
+        const auto pos = list.nth(50);
+        list.erase(list.nth(10), list.nth(20));
+        list.insert(list.begin(), { -1, -1, -1, -1, -1 });
+        REQUIRE(*pos == 50);
+        REQUIRE(list.index_of(pos) == 45);
+    }
+
+    SUBCASE("matches std::vector under random edits")
+    {
+        indexed_list<int> list;
+        std::vector<int> expected;
+
+        std::mt19937 gen{ 13 };
+        for (int i = 0; i < 4000; ++i)
+        {
+            const auto index = std::uniform_int_distribution<std::size_t>{ 0,
+                expected.size() }(gen);
+
+            if (index == expected.size() || gen() % 3 != 0)
+            {
+                list.insert(list.nth(index), i);
+                expected.insert(expected.begin() + static_cast<std::ptrdiff_t>(index), i);
+            }
+            else
+            {
+                list.erase(list.nth(index));
+                expected.erase(expected.begin() + static_cast<std::ptrdiff_t>(index));
+            }
+
+            if (!expected.empty())
+            {
+                const auto probe = std::uniform_int_distribution<std::size_t>{ 0,
+                    expected.size() - 1 }(gen);
+                REQUIRE(list[probe] == expected[probe]);
+                REQUIRE(list.index_of(list.nth(probe)) == probe);
+            }
+        }
+
+        REQUIRE(list.size() == expected.size());
+        REQUIRE(std::ranges::equal(list, expected));
+        REQUIRE(std::ranges::equal(list | std::views::reverse, expected | std::views::reverse));
+
+        for (auto pos = list.begin(); pos != list.end(); ++pos)
+        {
+            REQUIRE(list.index_of(pos) ==
+                static_cast<std::size_t>(std::distance(list.begin(), pos)));
+        }
+    }
+
+    SUBCASE("copy, move and swap")
+    {
+        indexed_list list{ 1, 2, 3 };
+
+        const indexed_list copy{ list };
+        REQUIRE(copy == list);
+        REQUIRE(copy[2] == 3);
+
+        indexed_list moved{ std::move(list) };
+        REQUIRE(list.empty());
+        REQUIRE(moved[1] == 2);
+
+        indexed_list other{ 4 };
+        swap(moved, other);
+        REQUIRE(moved == indexed_list{ 4 });
+        REQUIRE(other[2] == 3);
+        REQUIRE(other.index_of(std::prev(other.end())) == 2);
+
+        list = other;
+        list.push_back(4);
+        REQUIRE(list[3] == 4);
+        REQUIRE((list <=> other) == std::strong_ordering::greater);
+    }
+
+    SUBCASE("allocator")
+    {
+        using allocator_type = pool_allocator<int>;
+
+        const allocator_type alloc;
+        indexed_list<int, allocator_type> list{ { 1, 2, 3 }, alloc };
+        REQUIRE(list.get_allocator() == alloc);
+
+        const auto copy{ list };
+        REQUIRE(copy.get_allocator() != alloc);
+        REQUIRE(copy == list);
+    }
+}
@@ -0,0 +1,229 @@
+#include <doctest/doctest.h>
+import data_structures;
+
+namespace
+{
+    struct item
+    {
+        int value{ 0 };
+        caff::intrusive_linked_list_hook<item> hook{ };
+        caff::intrusive_linked_list_hook<item> other_hook{ };
+
+        friend bool operator==(const item& lhs, const item& rhs)
+        {
+            return lhs.value == rhs.value;
+        }
+    };
+
+    using item_list = caff::intrusive_linked_list<item, &item::hook>;
+
+    std::vector<int> values_of(const item_list& list)
+    {
+        return list
+            | std::views::transform(&item::value)
+            | std::ranges::to<std::vector>();
+    }
+}
+
+TEST_CASE("intrusive_linked_list")
+{
+    using namespace caff;
+
+    std::array<item, 5> items{ { { 1 }, { 2 }, { 3 }, { 4 }, { 5 } } };
+
+    SUBCASE("member types")
+    {
+        static_assert(std::is_same_v<item_list::value_type, item>);
+        static_assert(std::is_same_v<item_list::size_type, std::size_t>);
+        static_assert(std::is_same_v<item_list::reference, item&>);
+        static_assert(std::is_same_v<item_list::const_reference, const item&>);
+        static_assert(std::is_same_v<item_list::iterator, intrusive_linked_list_iterator<item, &item::hook>>);
+        static_assert(std::is_same_v<item_list::const_iterator, intrusive_linked_list_const_iterator<item, &item::hook>>);
+        static_assert(std::forward_iterator<item_list::iterator>);
+        static_assert(std::forward_iterator<item_list::const_iterator>);
+    }
+
+    SUBCASE("default constructor")
+    {
+        const item_list list;
+        REQUIRE(list.empty());
+        REQUIRE(list.size() == 0);
+        REQUIRE(list.begin() == list.end());
+        REQUIRE(list.before_end() == list.before_begin());
+    }
+
+    SUBCASE("push_front and push_back link the objects themselves")
+    {
+        item_list list;
+        list.push_back(items[1]);
+        list.push_front(items[0]);
+        list.push_back(items[2]);
+
+        REQUIRE(list.size() == 3);
+        REQUIRE(std::addressof(list.front()) == std::addressof(items[0]));
+        REQUIRE(std::addressof(list.back()) == std::addressof(items[2]));
+        REQUIRE(values_of(list) == std::vector{ 1, 2, 3 });
+
+        // changes through the objects are visible through the list
+        items[1].value = 9;
+        REQUIRE(values_of(list) == std::vector{ 1, 9, 3 });
+    }
+
+    SUBCASE("iterator_to")
+    {
+        item_list list;
+        for (auto& i : items)
+        {
+            list.push_back(i);
+        }
+
+        auto pos = list.iterator_to(items[2]);
+        REQUIRE(pos->value == 3);
+        REQUIRE(std::next(pos, 3) == list.end());
+    }
+
+    SUBCASE("insert_after")
+    {
+        item_list list;
+        list.push_back(items[0]);
+        list.push_back(items[2]);
+
+        auto pos = list.insert_after(list.begin(), items[1]);
+        REQUIRE(std::addressof(*pos) == std::addressof(items[1]));
+        list.insert_after(list.before_end(), items[3]);
+
+        REQUIRE(list.size() == 4);
+        REQUIRE(list.back().value == 4);
+        REQUIRE(values_of(list) == std::vector{ 1, 2, 3, 4 });
+    }
+
+    SUBCASE("erase_after")
+    {
+        item_list list;
+        for (auto& i : items)
+        {
+            list.push_back(i);
+        }
+
+        SUBCASE("erase after middle")
+        {
+            auto pos = list.erase_after(list.begin());
+            REQUIRE(pos->value == 3);
+            REQUIRE(items[1].hook.next == nullptr);
+            REQUIRE(values_of(list) == std::vector{ 1, 3, 4, 5 });
+        }
+
+        SUBCASE("erase last")
+        {
+            auto pos = list.erase_after(list.iterator_to(items[3]));
+            REQUIRE(pos == list.end());
+            REQUIRE(list.back().value == 4);
+        }
+
+        SUBCASE("erase range to end")
+        {
+            auto pos = list.erase_after(list.begin(), list.end());
+            REQUIRE(pos == list.end());
+            REQUIRE(list.size() == 1);
+            REQUIRE(list.back().value == 1);
+        }
+
+        SUBCASE("pop_front")
+        {
+            list.pop_front();
+            REQUIRE(list.front().value == 2);
+            REQUIRE(list.size() == 4);
+        }
+    }
+
+    SUBCASE("remove_if")
+    {
+        item_list list;
+        for (auto& i : items)
+        {
+            list.push_back(i);
+        }
+
+        REQUIRE(list.remove_if([](const item& i) { return i.value % 2 == 1; }) == 3);
+        REQUIRE(values_of(list) == std::vector{ 2, 4 });
+        REQUIRE(list.back().value == 4);
+
+        // unlinked objects can be linked again
+        list.push_back(items[0]);
+        REQUIRE(values_of(list) == std::vector{ 2, 4, 1 });
+    }
+
+    SUBCASE("clear unlinks every object")
+    {
+        item_list list;
+        for (auto& i : items)
+        {
+            list.push_back(i);
+        }
+
+        list.clear();
+        REQUIRE(list.empty());
+        REQUIRE(std::ranges::all_of(items, [](const item& i) { return i.hook.next == nullptr; }));
+    }
+
+    SUBCASE("splice_after")
+    {
+        item_list list;
+        item_list other;
+        list.push_back(items[0]);
+        list.push_back(items[1]);
+        other.push_back(items[2]);
+        other.push_back(items[3]);
+
+        list.splice_after(list.before_end(), other);
+        REQUIRE(other.empty());
+        REQUIRE(list.size() == 4);
+        REQUIRE(list.back().value == 4);
+        REQUIRE(values_of(list) == std::vector{ 1, 2, 3, 4 });
+    }
+
+    SUBCASE("move and swap")
+    {
+        item_list list;
+        list.push_back(items[0]);
+        list.push_back(items[1]);
+
+        item_list moved{ std::move(list) };
+        REQUIRE(list.empty());
+        REQUIRE(values_of(moved) == std::vector{ 1, 2 });
+
+        swap(list, moved);
+        REQUIRE(moved.empty());
+        REQUIRE(values_of(list) == std::vector{ 1, 2 });
+    }
+
+    SUBCASE("an object can be in one list per hook")
+    {
+        item_list list;
+        intrusive_linked_list<item, &item::other_hook> other;
+
+        for (auto& i : items)
+        {
+            list.push_back(i);
+            other.push_front(i);
+        }
+
+        REQUIRE(values_of(list) == std::vector{ 1, 2, 3, 4, 5 });
+        REQUIRE(std::ranges::equal(other | std::views::transform(&item::value),
+            std::vector{ 5, 4, 3, 2, 1 }));
+    }
+
+    SUBCASE("equality operator")
+    {
+        std::array<item, 2> copies{ { { 1 }, { 2 } } };
+
+        item_list list;
+        item_list other;
+        list.push_back(items[0]);
+        list.push_back(items[1]);
+        other.push_back(copies[0]);
+        other.push_back(copies[1]);
+
+        REQUIRE(list == other);
+    }
+}
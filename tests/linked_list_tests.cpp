@@ -14,6 +14,34 @@ TEST_CASE("linked_list_node")
     }
 }
 
+namespace
+{
+    struct no_default
+    {
+        explicit no_default(int v) : value{ v }
+        {
+        }
+
+        int value;
+
+        friend bool operator==(const no_default&, const no_default&) = default;
+    };
+
+    // throws when constructed from a negative value
+    struct rejects_negative
+    {
+        rejects_negative(int v) : value{ v }
+        {
+            if (v < 0)
+            {
+                throw std::invalid_argument{ "negative" };
+            }
+        }
+
+        int value;
+    };
+}
+
 TEST_CASE("linked_list")
 {
     using namespace caff;
@@ -67,6 +95,36 @@ TEST_CASE("linked_list")
         REQUIRE(values[2] == 3);
     }
 
+    SUBCASE("move constructor")
+    {
+        linked_list other{ 1, 2, 3 };
+        const auto first = other.begin();
+
+        const linked_list list{ std::move(other) };
+        REQUIRE(list.begin() == first);
+        REQUIRE(list.size() == 3);
+        REQUIRE(other.empty());
+        REQUIRE(other.size() == 0);
+
+        const auto values = list | std::ranges::to<std::vector>();
+        REQUIRE(values == std::vector{ 1, 2, 3 });
+    }
+
+    SUBCASE("move assignment operator")
+    {
+        linked_list other{ 4, 5 };
+        const auto first = other.begin();
+
+        linked_list list{ 1, 2, 3 };
+        list = std::move(other);
+        REQUIRE(list.begin() == first);
+        REQUIRE(list.size() == 2);
+        REQUIRE(other.empty());
+
+        const auto values = list | std::ranges::to<std::vector>();
+        REQUIRE(values == std::vector{ 4, 5 });
+    }
+
     SUBCASE("assignment operator")
     {
         SUBCASE("assign to empty list")
@@ -294,6 +352,48 @@ TEST_CASE("linked_list")
         }
     }
 
+    SUBCASE("prefetched")
+    {
+        linked_list list{ 1, 2, 3, 4, 5 };
+
+        SUBCASE("empty list")
+        {
+            const linked_list<int> empty;
+            REQUIRE(std::ranges::empty(empty.prefetched()));
+        }
+
+        SUBCASE("visits every element in order")
+        {
+            for (const std::size_t distance : { 0, 1, 4, 5, 100 })
+            {
+                CAPTURE(distance);
+
+                const auto values = list.prefetched(distance)
+                    | std::ranges::to<std::vector>();
+                REQUIRE(values == std::vector{ 1, 2, 3, 4, 5 });
+            }
+        }
+
+        SUBCASE("non-const list")
+        {
+            for (auto& value : list.prefetched())
+            {
+                value *= 2;
+            }
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 2, 4, 6, 8, 10 });
+        }
+
+        SUBCASE("const list")
+        {
+            const auto& const_list = list;
+            static_assert(std::is_same_v<decltype(*const_list.prefetched().begin()), const int&>);
+
+            REQUIRE(std::ranges::equal(const_list.prefetched(2), const_list));
+        }
+    }
+
     SUBCASE("empty")
     {
         linked_list<int> list;
@@ -464,6 +564,126 @@ TEST_CASE("linked_list")
         }
     }
 
+    SUBCASE("erase range")
+    {
+        linked_list list{ 1, 2, 3, 4, 5 };
+
+        SUBCASE("erase from middle")
+        {
+            auto pos = list.erase(std::next(list.begin()), std::next(list.begin(), 4));
+            REQUIRE(*pos == 5);
+            REQUIRE(list.size() == 2);
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 1, 5 });
+        }
+
+        SUBCASE("erase everything")
+        {
+            auto pos = list.erase(list.begin(), list.end());
+            REQUIRE(pos == list.end());
+            REQUIRE(list.empty());
+            REQUIRE(list.size() == 0);
+        }
+
+        SUBCASE("erase empty range")
+        {
+            auto pos = list.erase(list.begin(), list.begin());
+            REQUIRE(pos == list.begin());
+            REQUIRE(list.size() == 5);
+        }
+    }
+
+    SUBCASE("remove")
+    {
+        linked_list list{ 1, 2, 1, 3, 1, 1 };
+
+        SUBCASE("matching elements")
+        {
+            REQUIRE(list.remove(1) == 4);
+            REQUIRE(list.size() == 2);
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 2, 3 });
+        }
+
+        SUBCASE("no matching elements")
+        {
+            REQUIRE(list.remove(4) == 0);
+            REQUIRE(list.size() == 6);
+        }
+
+        SUBCASE("value refers to an element of the list")
+        {
+            REQUIRE(list.remove(list.front()) == 4);
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 2, 3 });
+        }
+    }
+
+    SUBCASE("remove_if")
+    {
+        linked_list list{ 1, 2, 3, 4, 5, 6 };
+
+        SUBCASE("matching elements")
+        {
+            REQUIRE(list.remove_if([](int value) { return value % 2 == 0; }) == 3);
+            REQUIRE(list.size() == 3);
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 1, 3, 5 });
+        }
+
+        SUBCASE("all elements")
+        {
+            REQUIRE(list.remove_if([](int) { return true; }) == 6);
+            REQUIRE(list.empty());
+            REQUIRE(list.size() == 0);
+        }
+
+        SUBCASE("predicate that throws part way")
+        {
+            const auto throws_on_five = [](int value)
+            {
+                if (value == 5)
+                {
+                    throw std::runtime_error{ "five" };
+                }
+                return value % 2 == 0;
+            };
+
+            REQUIRE_THROWS_AS(list.remove_if(throws_on_five), std::runtime_error);
+            REQUIRE(list.size() == 4);
+
+            // the tail still points at the last node
+            list.push_back(7);
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 1, 3, 5, 6, 7 });
+        }
+    }
+
+    SUBCASE("erase and erase_if")
+    {
+        linked_list list{ 1, 2, 3, 2, 1 };
+
+        SUBCASE("erase")
+        {
+            REQUIRE(erase(list, 2) == 2);
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 1, 3, 1 });
+        }
+
+        SUBCASE("erase_if")
+        {
+            REQUIRE(erase_if(list, [](int value) { return value < 3; }) == 4);
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 3 });
+        }
+    }
+
     SUBCASE("push_front")
     {
         SUBCASE("push to empty list")
@@ -499,6 +719,244 @@ TEST_CASE("linked_list")
         }
     }
 
+    SUBCASE("push_front rvalue")
+    {
+        linked_list<std::string> list;
+
+        std::string value(100, 'x');
+        const auto* data = value.data();
+
+        list.push_front(std::move(value));
+        REQUIRE(list.front().data() == data);
+    }
+
+    SUBCASE("emplace_front")
+    {
+        linked_list<std::string> list{ "b" };
+
+        auto& value = list.emplace_front(3, 'a');
+        REQUIRE(value == "aaa");
+        REQUIRE(std::addressof(value) == std::addressof(list.front()));
+        REQUIRE(list.size() == 2);
+    }
+
+    SUBCASE("push_back")
+    {
+        linked_list<int> list;
+
+        SUBCASE("push to empty list")
+        {
+            list.push_back(1);
+            REQUIRE(list.size() == 1);
+            REQUIRE(list.front() == 1);
+            REQUIRE(list.back() == 1);
+        }
+
+        SUBCASE("push to multi-element list")
+        {
+            list.push_back(1);
+            list.push_back(2);
+            list.push_back(3);
+            REQUIRE(list.size() == 3);
+            REQUIRE(list.back() == 3);
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 1, 2, 3 });
+        }
+
+        SUBCASE("push after pop_front empties the list")
+        {
+            list.push_back(1);
+            list.pop_front();
+            list.push_back(2);
+            REQUIRE(list.front() == 2);
+            REQUIRE(list.back() == 2);
+        }
+    }
+
+    SUBCASE("emplace_back")
+    {
+        linked_list<std::string> list{ "a" };
+
+        auto& value = list.emplace_back(3, 'b');
+        REQUIRE(value == "bbb");
+        REQUIRE(std::addressof(value) == std::addressof(list.back()));
+        REQUIRE(list.size() == 2);
+    }
+
+    SUBCASE("append_range")
+    {
+        linked_list list{ 1, 2 };
+
+        list.append_range(std::vector{ 3, 4 });
+        list.append_range(std::views::iota(5, 7));
+        REQUIRE(list.size() == 6);
+        REQUIRE(list.back() == 6);
+
+        const auto values = list | std::ranges::to<std::vector>();
+        REQUIRE(values == std::vector{ 1, 2, 3, 4, 5, 6 });
+    }
+
+    SUBCASE("before_end")
+    {
+        SUBCASE("empty list")
+        {
+            linked_list<int> list;
+            REQUIRE(list.before_end() == list.before_begin());
+            REQUIRE(list.cbefore_end() == list.cbefore_begin());
+        }
+
+        SUBCASE("non-empty list")
+        {
+            linked_list list{ 1, 2, 3 };
+            REQUIRE(*list.before_end() == 3);
+            REQUIRE(std::next(list.before_end()) == list.end());
+
+            list.insert_after(list.before_end(), 4);
+            REQUIRE(list.back() == 4);
+        }
+    }
+
+    SUBCASE("back follows relinking operations")
+    {
+        linked_list list{ 3, 1, 2 };
+        linked_list other{ 5, 4 };
+
+        SUBCASE("erase_after last")
+        {
+            list.erase_after(list.begin(), list.end());
+            REQUIRE(list.back() == 3);
+        }
+
+        SUBCASE("erase end")
+        {
+            list.erase(std::next(list.begin(), 2));
+            REQUIRE(list.back() == 1);
+        }
+
+        SUBCASE("remove_if")
+        {
+            list.remove_if([](int value) { return value != 1; });
+            REQUIRE(list.back() == 1);
+        }
+
+        SUBCASE("move constructor")
+        {
+            linked_list moved{ std::move(list) };
+            REQUIRE(moved.back() == 2);
+
+            list.push_back(7);
+            REQUIRE(list.front() == 7);
+        }
+
+        SUBCASE("move assignment")
+        {
+            other = std::move(list);
+            REQUIRE(other.back() == 2);
+        }
+
+        SUBCASE("swap with empty list")
+        {
+            linked_list<int> empty;
+            swap(list, empty);
+            REQUIRE(list.empty());
+            REQUIRE(empty.back() == 2);
+
+            list.push_back(7);
+            REQUIRE(list.front() == 7);
+            REQUIRE(list.back() == 7);
+        }
+
+        SUBCASE("splice whole list at end")
+        {
+            list.splice_after(list.before_end(), other);
+            REQUIRE(list.back() == 4);
+            REQUIRE(other.empty());
+
+            other.push_back(7);
+            REQUIRE(other.front() == 7);
+        }
+
+        SUBCASE("splice last element")
+        {
+            list.splice_after(list.before_begin(), other, other.begin());
+            REQUIRE(list.front() == 4);
+            REQUIRE(list.back() == 2);
+            REQUIRE(other.back() == 5);
+        }
+
+        SUBCASE("splice range to end")
+        {
+            other.splice_after(other.before_end(), list, list.begin(),
+                list.end());
+            REQUIRE(list.back() == 3);
+            REQUIRE(other.back() == 2);
+        }
+
+        SUBCASE("merge")
+        {
+            list.sort();
+            other.sort();
+            list.merge(other);
+            REQUIRE(list.back() == 5);
+        }
+
+        SUBCASE("sort")
+        {
+            list.sort();
+            REQUIRE(list.back() == 3);
+        }
+
+        SUBCASE("reverse")
+        {
+            list.reverse();
+            REQUIRE(list.back() == 3);
+        }
+
+        SUBCASE("unique")
+        {
+            list.push_back(2);
+            list.unique();
+            REQUIRE(list.back() == 2);
+        }
+
+        list.push_back(9);
+        other.push_back(9);
+        REQUIRE(list.back() == 9);
+        REQUIRE(other.back() == 9);
+        REQUIRE(*std::next(list.begin(), list.size() - 1) == 9);
+        REQUIRE(*std::next(other.begin(), other.size() - 1) == 9);
+    }
+
+    SUBCASE("non-default constructible type")
+    {
+        linked_list<no_default> list;
+        list.emplace_front(3);
+        list.emplace_after(list.begin(), 4);
+        list.push_front(no_default{ 1 });
+        list.insert_after(list.begin(), no_default{ 2 });
+
+        const linked_list copy{ list };
+        REQUIRE(copy == list);
+
+        const auto values = copy
+            | std::views::transform(&no_default::value)
+            | std::ranges::to<std::vector>();
+        REQUIRE(values == std::vector{ 1, 2, 3, 4 });
+    }
+
+    SUBCASE("swap")
+    {
+        linked_list list{ 1, 2, 3 };
+        linked_list other{ 4 };
+
+        swap(list, other);
+        REQUIRE(list.size() == 1);
+        REQUIRE(list.front() == 4);
+        REQUIRE(other.size() == 3);
+        REQUIRE(other.front() == 1);
+    }
+
     SUBCASE("pop_front")
     {
         SUBCASE("pop from single element list")
@@ -520,6 +978,484 @@ TEST_CASE("linked_list")
         }
     }
 
+    SUBCASE("before_begin")
+    {
+        linked_list list{ 1, 2, 3 };
+
+        SUBCASE("non-const list")
+        {
+            auto pos = list.before_begin();
+            static_assert(std::same_as<decltype(pos),
+                linked_list_iterator<int>>);
+            REQUIRE(std::next(pos) == list.begin());
+        }
+
+        SUBCASE("const list")
+        {
+            auto& const_list = std::as_const(list);
+
+            auto pos = const_list.before_begin();
+            static_assert(std::same_as<decltype(pos),
+                linked_list_const_iterator<int>>);
+            REQUIRE(std::next(pos) == const_list.begin());
+
+            SUBCASE("cbefore_begin")
+            {
+                pos = const_list.cbefore_begin();
+                REQUIRE(std::next(pos) == const_list.begin());
+            }
+        }
+    }
+
+    SUBCASE("insert_after")
+    {
+        SUBCASE("insert into empty list")
+        {
+            linked_list<int> list;
+
+            auto pos = list.insert_after(list.before_begin(), 1);
+            REQUIRE(pos == list.begin());
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values.size() == 1);
+            REQUIRE(values[0] == 1);
+        }
+
+        SUBCASE("insert into non-empty list")
+        {
+            linked_list list{ 1, 2, 3 };
+
+            SUBCASE("insert after before_begin")
+            {
+                auto pos = list.insert_after(list.before_begin(), 0);
+                REQUIRE(*pos == 0);
+                REQUIRE(pos == list.begin());
+
+                const auto values = list | std::ranges::to<std::vector>();
+                REQUIRE(values == std::vector{ 0, 1, 2, 3 });
+            }
+
+            SUBCASE("insert after middle")
+            {
+                auto pos = list.insert_after(std::next(list.begin()), 5);
+                REQUIRE(*pos == 5);
+
+                const auto values = list | std::ranges::to<std::vector>();
+                REQUIRE(values == std::vector{ 1, 2, 5, 3 });
+            }
+
+            SUBCASE("insert after last")
+            {
+                auto pos = list.insert_after(std::next(list.begin(), 2), 4);
+                REQUIRE(*pos == 4);
+                REQUIRE(std::next(pos) == list.end());
+
+                const auto values = list | std::ranges::to<std::vector>();
+                REQUIRE(values == std::vector{ 1, 2, 3, 4 });
+            }
+
+            SUBCASE("insert range")
+            {
+                const std::vector<int> other{ 7, 8 };
+                auto pos = list.insert_after(list.begin(), other.begin(),
+                    other.end());
+                REQUIRE(*pos == 8);
+                REQUIRE(list.size() == 5);
+
+                const auto values = list | std::ranges::to<std::vector>();
+                REQUIRE(values == std::vector{ 1, 7, 8, 2, 3 });
+            }
+
+            SUBCASE("insert range that throws part way")
+            {
+                linked_list<rejects_negative> checked{ 1, 2 };
+                const std::vector<int> other{ 7, 8, -1, 9 };
+
+                REQUIRE_THROWS_AS(checked.insert_after(checked.begin(), other.begin(),
+                    other.end()), std::invalid_argument);
+                REQUIRE(checked.size() == 2);
+                REQUIRE(checked.back().value == 2);
+            }
+
+            SUBCASE("insert empty range")
+            {
+                const std::vector<int> other;
+                auto pos = list.insert_after(list.begin(), other.begin(),
+                    other.end());
+                REQUIRE(pos == list.begin());
+                REQUIRE(list.size() == 3);
+            }
+
+            SUBCASE("insert initializer_list")
+            {
+                list.insert_after(list.before_begin(), { -1, 0 });
+
+                const auto values = list | std::ranges::to<std::vector>();
+                REQUIRE(values == std::vector{ -1, 0, 1, 2, 3 });
+            }
+        }
+    }
+
+    SUBCASE("emplace_after")
+    {
+        linked_list list{ 1, 3 };
+
+        auto pos = list.emplace_after(list.begin(), 2);
+        REQUIRE(*pos == 2);
+        REQUIRE(list.size() == 3);
+
+        const auto values = list | std::ranges::to<std::vector>();
+        REQUIRE(values == std::vector{ 1, 2, 3 });
+    }
+
+    SUBCASE("erase_after")
+    {
+        linked_list list{ 1, 2, 3, 4 };
+
+        SUBCASE("erase after before_begin")
+        {
+            auto pos = list.erase_after(list.before_begin());
+            REQUIRE(pos == list.begin());
+            REQUIRE(*pos == 2);
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 2, 3, 4 });
+        }
+
+        SUBCASE("erase after middle")
+        {
+            auto pos = list.erase_after(std::next(list.begin()));
+            REQUIRE(*pos == 4);
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 1, 2, 4 });
+        }
+
+        SUBCASE("erase last")
+        {
+            auto pos = list.erase_after(std::next(list.begin(), 2));
+            REQUIRE(pos == list.end());
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 1, 2, 3 });
+        }
+
+        SUBCASE("erase range")
+        {
+            auto pos = list.erase_after(list.begin(), std::next(list.begin(), 3));
+            REQUIRE(*pos == 4);
+            REQUIRE(list.size() == 2);
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 1, 4 });
+        }
+
+        SUBCASE("erase range to end")
+        {
+            auto pos = list.erase_after(list.before_begin(), list.end());
+            REQUIRE(pos == list.end());
+            REQUIRE(list.empty());
+            REQUIRE(list.size() == 0);
+        }
+
+        SUBCASE("erase empty range")
+        {
+            auto pos = list.erase_after(list.begin(), std::next(list.begin()));
+            REQUIRE(*pos == 2);
+            REQUIRE(list.size() == 4);
+        }
+    }
+
+    SUBCASE("allocator")
+    {
+        using allocator_type = pool_allocator<int>;
+
+        const allocator_type alloc;
+        linked_list<int, allocator_type> list{ { 1, 2, 3 }, alloc };
+        REQUIRE(list.get_allocator() == alloc);
+
+        SUBCASE("copy constructor gets its own pool")
+        {
+            const auto copy{ list };
+            REQUIRE(copy.get_allocator() != alloc);
+            REQUIRE(copy == list);
+        }
+
+        SUBCASE("copy assignment keeps the allocator")
+        {
+            linked_list<int, allocator_type> other{ 4, 5 };
+            const auto other_alloc = other.get_allocator();
+
+            other = list;
+            REQUIRE(other.get_allocator() == other_alloc);
+            REQUIRE(other == list);
+        }
+    }
+
+    SUBCASE("splice_after")
+    {
+        linked_list list{ 1, 2, 3 };
+        linked_list other{ 4, 5, 6 };
+
+        SUBCASE("whole list")
+        {
+            const auto first = other.begin();
+
+            list.splice_after(list.begin(), other);
+            REQUIRE(std::next(list.begin()) == first);
+            REQUIRE(list.size() == 6);
+            REQUIRE(other.empty());
+            REQUIRE(other.size() == 0);
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 1, 4, 5, 6, 2, 3 });
+        }
+
+        SUBCASE("single element")
+        {
+            list.splice_after(list.before_begin(), other, other.begin());
+            REQUIRE(list.size() == 4);
+            REQUIRE(other.size() == 2);
+
+            REQUIRE((list | std::ranges::to<std::vector>()) == std::vector{ 5, 1, 2, 3 });
+            REQUIRE((other | std::ranges::to<std::vector>()) == std::vector{ 4, 6 });
+        }
+
+        SUBCASE("single element within the same list")
+        {
+            list.splice_after(std::next(list.begin(), 2), list, list.before_begin());
+            REQUIRE(list.size() == 3);
+
+            REQUIRE((list | std::ranges::to<std::vector>()) == std::vector{ 2, 3, 1 });
+        }
+
+        SUBCASE("range")
+        {
+            list.splice_after(std::next(list.begin(), 2), other,
+                other.before_begin(), std::next(other.begin(), 2));
+            REQUIRE(list.size() == 5);
+            REQUIRE(other.size() == 1);
+
+            REQUIRE((list | std::ranges::to<std::vector>()) == std::vector{ 1, 2, 3, 4, 5 });
+            REQUIRE((other | std::ranges::to<std::vector>()) == std::vector{ 6 });
+        }
+
+        SUBCASE("empty range")
+        {
+            list.splice_after(list.begin(), other, other.begin(),
+                std::next(other.begin()));
+            REQUIRE(list.size() == 3);
+            REQUIRE(other.size() == 3);
+        }
+    }
+
+    SUBCASE("merge")
+    {
+        linked_list list{ 1, 3, 5, 7 };
+
+        SUBCASE("default comparison")
+        {
+            linked_list other{ 0, 2, 3, 8 };
+            list.merge(other);
+            REQUIRE(list.size() == 8);
+            REQUIRE(other.empty());
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 0, 1, 2, 3, 3, 5, 7, 8 });
+        }
+
+        SUBCASE("custom comparison")
+        {
+            list.reverse();
+            list.merge(linked_list{ 6, 4, 2 }, std::greater<>{});
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 7, 6, 5, 4, 3, 2, 1 });
+        }
+
+        SUBCASE("is stable")
+        {
+            using pair_type = std::pair<int, char>;
+            const auto by_first = [](const pair_type& lhs, const pair_type& rhs)
+            {
+                return lhs.first < rhs.first;
+            };
+
+            linked_list<pair_type> lhs{ { 1, 'a' }, { 2, 'a' } };
+            linked_list<pair_type> rhs{ { 1, 'b' }, { 2, 'b' } };
+            lhs.merge(rhs, by_first);
+
+            const auto values = lhs
+                | std::views::values
+                | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 'a', 'b', 'a', 'b' });
+        }
+
+        SUBCASE("a throwing comparator loses no element")
+        {
+            for (int comparisons = 0; comparisons < 8; ++comparisons)
+            {
+                linked_list lhs{ 1, 3, 5, 7 };
+                linked_list rhs{ 0, 2, 4, 6, 8 };
+
+                int left{ comparisons };
+                const auto throwing_less = [&left](int a, int b)
+                {
+                    if (left-- == 0)
+                    {
+                        throw std::runtime_error{ "compare" };
+                    }
+                    return a < b;
+                };
+
+                REQUIRE_THROWS_AS(lhs.merge(rhs, throwing_less), std::runtime_error);
+                REQUIRE(lhs.size() + rhs.size() == 9);
+                REQUIRE(std::ranges::distance(lhs) == static_cast<std::ptrdiff_t>(lhs.size()));
+
+                // the tails still point at the last nodes
+                lhs.push_back(9);
+                rhs.push_back(10);
+                REQUIRE(lhs.back() == 9);
+                REQUIRE(rhs.back() == 10);
+
+                auto values = lhs | std::ranges::to<std::vector>();
+                values.insert(values.end(), rhs.begin(), rhs.end());
+                std::ranges::sort(values);
+                REQUIRE(std::ranges::equal(values, std::views::iota(0, 11)));
+            }
+        }
+    }
+
+    SUBCASE("sort")
+    {
+        SUBCASE("empty list")
+        {
+            linked_list<int> list;
+            list.sort();
+            REQUIRE(list.empty());
+        }
+
+        SUBCASE("default comparison")
+        {
+            linked_list list{ 5, 3, 9, 1, 3, 0, 7 };
+            const auto nodes = list
+                | std::views::transform([](const int& value) { return &value; })
+                | std::ranges::to<std::vector>();
+
+            list.sort();
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 0, 1, 3, 3, 5, 7, 9 });
+
+            // the elements themselves were relinked, not copied
+            REQUIRE(std::ranges::all_of(list, [&](const int& value)
+            {
+                return std::ranges::contains(nodes, &value);
+            }));
+        }
+
+        SUBCASE("custom comparison")
+        {
+            linked_list list{ 5, 3, 9, 1 };
+            list.sort(std::greater<>{});
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 9, 5, 3, 1 });
+        }
+
+        SUBCASE("is stable")
+        {
+            std::vector<std::pair<int, int>> expected;
+            linked_list<std::pair<int, int>> list;
+
+            std::mt19937 gen{ 7 };
+            for (int i = 0; i < 1000; ++i)
+            {
+                const auto key = static_cast<int>(gen() % 10);
+                list.push_front({ key, i });
+                expected.insert(expected.begin(), { key, i });
+            }
+
+            const auto by_first = [](const auto& lhs, const auto& rhs)
+            {
+                return lhs.first < rhs.first;
+            };
+            list.sort(by_first);
+            std::ranges::stable_sort(expected, by_first);
+
+            REQUIRE(list.size() == expected.size());
+            REQUIRE(std::ranges::equal(list, expected));
+        }
+
+        SUBCASE("a throwing comparator loses no element")
+        {
+            std::vector<int> values(100);
+            std::iota(values.begin(), values.end(), 0);
+            std::ranges::shuffle(values, std::mt19937{ 5 });
+
+            for (int comparisons : { 0, 1, 10, 100, 300, 500 })
+            {
+                linked_list<int> list;
+                list.insert_after(list.before_begin(), values.begin(), values.end());
+
+                int left{ comparisons };
+                const auto throwing_less = [&left](int a, int b)
+                {
+                    if (left-- == 0)
+                    {
+                        throw std::runtime_error{ "compare" };
+                    }
+                    return a < b;
+                };
+
+                REQUIRE_THROWS_AS(list.sort(throwing_less), std::runtime_error);
+                REQUIRE(list.size() == values.size());
+
+                list.push_back(100);
+                REQUIRE(list.back() == 100);
+
+                auto after = list | std::ranges::to<std::vector>();
+                std::ranges::sort(after);
+                REQUIRE(std::ranges::equal(after, std::views::iota(0, 101)));
+            }
+        }
+    }
+
+    SUBCASE("reverse")
+    {
+        linked_list list{ 1, 2, 3, 4 };
+        list.reverse();
+
+        const auto values = list | std::ranges::to<std::vector>();
+        REQUIRE(values == std::vector{ 4, 3, 2, 1 });
+
+        linked_list<int> empty;
+        empty.reverse();
+        REQUIRE(empty.empty());
+    }
+
+    SUBCASE("unique")
+    {
+        linked_list list{ 1, 1, 2, 3, 3, 3, 1 };
+
+        SUBCASE("default predicate")
+        {
+            REQUIRE(list.unique() == 3);
+            REQUIRE(list.size() == 4);
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 1, 2, 3, 1 });
+        }
+
+        SUBCASE("custom predicate")
+        {
+            REQUIRE(list.unique([](int lhs, int rhs) { return rhs == lhs + 1; }) == 1);
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 1, 1, 3, 3, 3, 1 });
+        }
+    }
+
     SUBCASE("equality operator")
     {
         linked_list list{ 1, 2, 3 };
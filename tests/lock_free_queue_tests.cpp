@@ -0,0 +1,101 @@
+#include <doctest/doctest.h>
+import data_structures;
+
+TEST_CASE("lock_free_queue")
+{
+    using namespace caff;
+
+    SUBCASE("default constructor")
+    {
+        lock_free_queue<int> queue;
+        REQUIRE(queue.empty());
+        REQUIRE(queue.pop() == std::nullopt);
+    }
+
+    SUBCASE("push and pop are FIFO")
+    {
+        lock_free_queue<std::string> queue;
+        queue.push("a");
+        queue.push(std::string{ "b" });
+        queue.emplace(1, 'c');
+        REQUIRE_FALSE(queue.empty());
+
+        REQUIRE(queue.pop() == "a");
+        REQUIRE(queue.pop() == "b");
+        REQUIRE(queue.pop() == "c");
+        REQUIRE(queue.pop() == std::nullopt);
+        REQUIRE(queue.empty());
+    }
+
+    SUBCASE("destructor frees remaining elements")
+    {
+        lock_free_queue<std::string> queue;
+        queue.push(std::string(100, 'x'));
+        queue.push(std::string(100, 'y'));
+        queue.pop();
+    }
+
+    SUBCASE("concurrent producers and consumers")
+    {
+        constexpr int producer_count{ 2 };
+        constexpr int consumer_count{ 2 };
+        constexpr int values_per_producer{ 20'000 };
+
+        lock_free_queue<int> queue;
+        std::atomic<int> consumed{ 0 };
+        std::vector<std::vector<int>> received(consumer_count);
+
+        {
+            std::vector<std::jthread> threads;
+            for (int p = 0; p < producer_count; ++p)
+            {
+                threads.emplace_back([&, p]
+                {
+                    for (int i = 0; i < values_per_producer; ++i)
+                    {
+                        queue.push(p * values_per_producer + i);
+                    }
+                });
+            }
+
+            for (int c = 0; c < consumer_count; ++c)
+            {
+                threads.emplace_back([&, c]
+                {
+                    while (consumed.load() < producer_count * values_per_producer)
+                    {
+                        if (auto value = queue.pop(); value.has_value())
+                        {
+                            received[c].push_back(*value);
+                            consumed.fetch_add(1);
+                        }
+                    }
+                });
+            }
+        }
+
+        // every value arrives exactly once, and each consumer sees the values
+        // of a single producer in the order they were pushed
+        std::vector<int> all;
+        for (const auto& values : received)
+        {
+            for (int p = 0; p < producer_count; ++p)
+            {
+                const auto from_producer = values
+                    | std::views::filter([p](int value)
+                    {
+                        return value / values_per_producer == p;
+                    })
+                    | std::ranges::to<std::vector>();
+                REQUIRE(std::ranges::is_sorted(from_producer));
+            }
+
+            all.insert(all.end(), values.begin(), values.end());
+        }
+
+        std::ranges::sort(all);
+        const auto expected = std::views::iota(0, producer_count * values_per_producer)
+            | std::ranges::to<std::vector>();
+        REQUIRE(all == expected);
+    }
+}
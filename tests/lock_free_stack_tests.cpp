@@ -0,0 +1,76 @@
+#include <doctest/doctest.h>
+import data_structures;
+
+TEST_CASE("lock_free_stack")
+{
+    using namespace caff;
+
+    SUBCASE("default constructor")
+    {
+        lock_free_stack<int> stack;
+        REQUIRE(stack.empty());
+        REQUIRE(stack.pop() == std::nullopt);
+    }
+
+    SUBCASE("push and pop are LIFO")
+    {
+        lock_free_stack<std::string> stack;
+        stack.push("a");
+        stack.push(std::string{ "b" });
+        stack.emplace(1, 'c');
+        REQUIRE_FALSE(stack.empty());
+
+        REQUIRE(stack.pop() == "c");
+        REQUIRE(stack.pop() == "b");
+        REQUIRE(stack.pop() == "a");
+        REQUIRE(stack.pop() == std::nullopt);
+        REQUIRE(stack.empty());
+    }
+
+    SUBCASE("destructor frees remaining elements")
+    {
+        lock_free_stack<std::string> stack;
+        stack.push(std::string(100, 'x'));
+        stack.push(std::string(100, 'y'));
+    }
+
+    SUBCASE("concurrent push and pop")
+    {
+        constexpr int thread_count{ 4 };
+        constexpr int values_per_thread{ 10'000 };
+
+        lock_free_stack<int> stack;
+        std::atomic<long long> popped_sum{ 0 };
+        std::atomic<int> popped_count{ 0 };
+
+        {
+            std::vector<std::jthread> threads;
+            for (int t = 0; t < thread_count; ++t)
+            {
+                threads.emplace_back([&, t]
+                {
+                    for (int i = 0; i < values_per_thread; ++i)
+                    {
+                        stack.push(t * values_per_thread + i);
+
+                        if (auto value = stack.pop(); value.has_value())
+                        {
+                            popped_sum.fetch_add(*value);
+                            popped_count.fetch_add(1);
+                        }
+                    }
+                });
+            }
+        }
+
+        while (auto value = stack.pop())
+        {
+            popped_sum.fetch_add(*value);
+            popped_count.fetch_add(1);
+        }
+
+        constexpr long long total = thread_count * values_per_thread;
+        REQUIRE(popped_count.load() == total);
+        REQUIRE(popped_sum.load() == total * (total - 1) / 2);
+    }
+}
@@ -0,0 +1,415 @@
+#include <doctest/doctest.h>
+
+import data_structures;
+
+namespace
+{
+    // counts every allocation made through any copy of the allocator
+    template <typename T>
+    struct counting_allocator
+    {
+        using value_type = T;
+
+        explicit counting_allocator(std::size_t& count) : count{ std::addressof(count) }
+        {
+        }
+
+        template <typename U>
+        counting_allocator(const counting_allocator<U>& other) : count{ other.count }
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            ++*count;
+            return std::allocator<T>{ }.allocate(n);
+        }
+
+        void deallocate(T* p, std::size_t n)
+        {
+            std::allocator<T>{ }.deallocate(p, n);
+        }
+
+        template <typename U>
+        friend bool operator==(const counting_allocator& lhs, const counting_allocator<U>& rhs)
+        {
+            return lhs.count == rhs.count;
+        }
+
+        std::size_t* count;
+    };
+
+    template <typename Cache>
+    std::vector<int> cached_keys(const Cache& cache, int max_key)
+    {
+        return std::views::iota(0, max_key)
+            | std::views::filter([&](int key) { return cache.contains(key); })
+            | std::ranges::to<std::vector>();
+    }
+}
+
+TEST_CASE("lru_cache")
+{
+    using namespace caff;
+
+    SUBCASE("capacity must be positive")
+    {
+        REQUIRE_THROWS_AS((lru_cache<int, int>{ 0 }), std::invalid_argument);
+    }
+
+    SUBCASE("get and put")
+    {
+        lru_cache<int, std::string> cache{ 2 };
+        REQUIRE(cache.empty());
+        REQUIRE(cache.capacity() == 2);
+
+        REQUIRE(cache.put(1, "one"));
+        REQUIRE(cache.put(2, "two"));
+        REQUIRE(cache.size() == 2);
+        REQUIRE(*cache.get(1) == "one");
+        REQUIRE(cache.get(3) == nullptr);
+
+        REQUIRE_FALSE(cache.put(1, "uno"));
+        REQUIRE(*cache.peek(1) == "uno");
+        REQUIRE(cache.size() == 2);
+    }
+
+    SUBCASE("evicts the least recently used entry")
+    {
+        lru_cache<int, int> cache{ 3 };
+        cache.put(1, 10);
+        cache.put(2, 20);
+        cache.put(3, 30);
+
+        // 1 is used again, so 2 is now the oldest
+        cache.get(1);
+        cache.put(4, 40);
+        REQUIRE(cached_keys(cache, 5) == std::vector{ 1, 3, 4 });
+
+        // touching and updating also count as uses, peeking doesn't
+        cache.touch(3);
+        cache.put(1, 11);
+        cache.peek(4);
+        cache.put(5, 50);
+        REQUIRE(cached_keys(cache, 6) == std::vector{ 1, 3, 5 });
+
+        const auto order = cache
+            | std::views::transform(&cache_entry<int, int>::key)
+            | std::ranges::to<std::vector>();
+        REQUIRE(order == std::vector{ 5, 1, 3 });
+    }
+
+    SUBCASE("erase and clear")
+    {
+        lru_cache<int, int> cache{ 4 };
+        for (int i = 0; i < 4; ++i)
+        {
+            cache.put(i, i);
+        }
+
+        REQUIRE(cache.erase(2));
+        REQUIRE_FALSE(cache.erase(2));
+        REQUIRE(cache.size() == 3);
+        REQUIRE(cached_keys(cache, 4) == std::vector{ 0, 1, 3 });
+
+        cache.clear();
+        REQUIRE(cache.empty());
+        REQUIRE(cache.get(0) == nullptr);
+
+        cache.put(7, 7);
+        REQUIRE(*cache.get(7) == 7);
+    }
+
+    SUBCASE("stats")
+    {
+        lru_cache<int, int> cache{ 1 };
+        cache.put(1, 1);
+        cache.put(1, 2);
+        cache.get(1);
+        cache.get(1);
+        cache.get(1);
+        cache.get(2);
+        cache.put(2, 2);
+
+        const auto& stats = cache.stats();
+        REQUIRE(stats.hits == 3);
+        REQUIRE(stats.misses == 1);
+        REQUIRE(stats.insertions == 2);
+        REQUIRE(stats.updates == 1);
+        REQUIRE(stats.evictions == 1);
+        REQUIRE(stats.operations() == 7);
+        REQUIRE(stats.hit_rate() == 0.75);
+        REQUIRE(stats.ops_per_second(stats.since + std::chrono::seconds{ 2 }) == 3.5);
+
+        cache.reset_stats();
+        REQUIRE(cache.stats().operations() == 0);
+        REQUIRE(cache.stats().hit_rate() == 0.0);
+    }
+
+    SUBCASE("matches a reference model under random use")
+    {
+        constexpr std::size_t capacity{ 16 };
+        lru_cache<int, int> cache{ capacity };
+        std::list<std::pair<int, int>> expected;
+
+        std::mt19937 gen{ 7 };
+        for (int i = 0; i < 5000; ++i)
+        {
+            const auto key = static_cast<int>(gen() % 40);
+            auto found = std::ranges::find(expected, key, &std::pair<int, int>::first);
+
+            if (gen() % 2 == 0)
+            {
+                const auto* value = cache.get(key);
+                REQUIRE((value == nullptr) == (found == expected.end()));
+
+                if (found != expected.end())
+                {
+                    REQUIRE(*value == found->second);
+                    expected.splice(expected.begin(), expected, found);
+                }
+            }
+            else if (gen() % 8 == 0)
+            {
+                REQUIRE(cache.erase(key) == (found != expected.end()));
+
+                if (found != expected.end())
+                {
+                    expected.erase(found);
+                }
+            }
+            else
+            {
+                cache.put(key, i);
+
+                if (found != expected.end())
+                {
+                    expected.erase(found);
+                }
+                else if (expected.size() == capacity)
+                {
+                    expected.pop_back();
+                }
+                expected.emplace_front(key, i);
+            }
+
+            REQUIRE(cache.size() == expected.size());
+        }
+
+        const auto entries = cache
+            | std::views::transform([](const auto& e) { return std::pair{ e.key, e.value }; })
+            | std::ranges::to<std::vector>();
+        REQUIRE(std::ranges::equal(entries, expected));
+    }
+
+    SUBCASE("does not allocate once full")
+    {
+        std::size_t allocations{ 0 };
+        using allocator_type = counting_allocator<cache_entry<int, int>>;
+        const allocator_type alloc{ allocations };
+
+        lru_cache<int, int, std::hash<int>, std::equal_to<int>, allocator_type> cache{
+            8, { }, { }, alloc };
+        for (int i = 0; i < 8; ++i)
+        {
+            cache.put(i, i);
+        }
+
+        const auto warm = allocations;
+        for (int i = 0; i < 1000; ++i)
+        {
+            cache.put(i % 20, i);
+            cache.get(i % 13);
+            cache.touch(i % 7);
+        }
+
+        REQUIRE(allocations == warm);
+        REQUIRE(cache.stats().evictions > 0);
+    }
+}
+
+TEST_CASE("lfu_cache")
+{
+    using namespace caff;
+
+    SUBCASE("capacity must be positive")
+    {
+        REQUIRE_THROWS_AS((lfu_cache<int, int>{ 0 }), std::invalid_argument);
+    }
+
+    SUBCASE("get and put")
+    {
+        lfu_cache<int, std::string> cache{ 2 };
+
+        REQUIRE(cache.put(1, "one"));
+        REQUIRE(cache.use_count(1) == 1);
+        REQUIRE(*cache.get(1) == "one");
+        REQUIRE(cache.use_count(1) == 2);
+
+        REQUIRE_FALSE(cache.put(1, "uno"));
+        REQUIRE(*cache.peek(1) == "uno");
+        REQUIRE(cache.use_count(1) == 3);
+        REQUIRE(cache.use_count(2) == 0);
+        REQUIRE(cache.get(2) == nullptr);
+    }
+
+    SUBCASE("evicts the least frequently used entry")
+    {
+        lfu_cache<int, int> cache{ 3 };
+        cache.put(1, 10);
+        cache.put(2, 20);
+        cache.put(3, 30);
+
+        cache.get(1);
+        cache.get(1);
+        cache.get(3);
+
+        // 2 has been used least
+        cache.put(4, 40);
+        REQUIRE(cached_keys(cache, 5) == std::vector{ 1, 3, 4 });
+
+        // 4 is now the only entry used once
+        cache.put(5, 50);
+        REQUIRE(cached_keys(cache, 6) == std::vector{ 1, 3, 5 });
+        REQUIRE(cache.stats().evictions == 2);
+    }
+
+    SUBCASE("ties are broken by recency")
+    {
+        lfu_cache<int, int> cache{ 3 };
+        cache.put(1, 1);
+        cache.put(2, 2);
+        cache.put(3, 3);
+
+        cache.touch(2);
+        cache.touch(1);
+        cache.touch(3);
+
+        // all have been used twice, and 2 longest ago
+        cache.touch(4);
+        cache.put(4, 4);
+        cache.get(4);
+        REQUIRE(cached_keys(cache, 5) == std::vector{ 1, 3, 4 });
+
+        // 4 was used twice most recently, and 1 longest ago
+        cache.put(5, 5);
+        REQUIRE(cached_keys(cache, 6) == std::vector{ 3, 4, 5 });
+    }
+
+    SUBCASE("erase and clear")
+    {
+        lfu_cache<int, int> cache{ 3 };
+        cache.put(1, 1);
+        cache.put(2, 2);
+        cache.get(2);
+
+        REQUIRE(cache.erase(2));
+        REQUIRE_FALSE(cache.erase(2));
+        REQUIRE(cache.size() == 1);
+
+        cache.put(3, 3);
+        cache.put(4, 4);
+        cache.put(5, 5);
+        REQUIRE(cache.size() == 3);
+        REQUIRE(cached_keys(cache, 6) == std::vector{ 3, 4, 5 });
+
+        cache.clear();
+        REQUIRE(cache.empty());
+        cache.put(6, 6);
+        REQUIRE(cache.use_count(6) == 1);
+    }
+
+    SUBCASE("matches a reference model under random use")
+    {
+        constexpr std::size_t capacity{ 12 };
+        lfu_cache<int, int> cache{ capacity };
+
+        // key -> (use count, last use, value)
+        std::map<int, std::tuple<std::size_t, int, int>> expected;
+
+        std::mt19937 gen{ 11 };
+        for (int i = 0; i < 5000; ++i)
+        {
+            const auto key = static_cast<int>(gen() % 30);
+            const auto found = expected.find(key);
+
+            if (gen() % 2 == 0)
+            {
+                const auto* value = cache.get(key);
+                REQUIRE((value == nullptr) == (found == expected.end()));
+
+                if (found != expected.end())
+                {
+                    auto& [count, last_use, expected_value] = found->second;
+                    REQUIRE(*value == expected_value);
+                    ++count;
+                    last_use = i;
+                }
+            }
+            else
+            {
+                cache.put(key, i);
+
+                if (found != expected.end())
+                {
+                    auto& [count, last_use, value] = found->second;
+                    ++count;
+                    last_use = i;
+                    value = i;
+                }
+                else
+                {
+                    if (expected.size() == capacity)
+                    {
+                        const auto victim = std::ranges::min_element(expected, { },
+                            [](const auto& e) { return std::pair{ std::get<0>(e.second),
+                                std::get<1>(e.second) }; });
+                        expected.erase(victim);
+                    }
+                    expected.emplace(key, std::tuple{ std::size_t{ 1 }, i, i });
+                }
+            }
+
+            REQUIRE(cache.size() == expected.size());
+        }
+
+        for (const auto& [key, e] : expected)
+        {
+            REQUIRE(cache.use_count(key) == std::get<0>(e));
+            REQUIRE(*cache.peek(key) == std::get<2>(e));
+        }
+    }
+
+    SUBCASE("does not allocate once full")
+    {
+        std::size_t allocations{ 0 };
+        using allocator_type = counting_allocator<cache_entry<int, int>>;
+        const allocator_type alloc{ allocations };
+
+        lfu_cache<int, int, std::hash<int>, std::equal_to<int>, allocator_type> cache{
+            8, { }, { }, alloc };
+
+        // a distinct use count per entry, plus the bucket for a new entry,
+        // is the most buckets the cache ever needs at once
+        for (int i = 0; i < 8; ++i)
+        {
+            cache.put(i, i);
+            for (int j = 0; j <= i; ++j)
+            {
+                cache.get(i);
+            }
+        }
+        cache.put(8, 8);
+
+        const auto warm = allocations;
+        for (int i = 0; i < 1000; ++i)
+        {
+            cache.put(i % 20, i);
+            cache.get(i % 13);
+            cache.touch(i % 7);
+        }
+
+        REQUIRE(allocations == warm);
+        REQUIRE(cache.stats().evictions > 0);
+    }
+}
@@ -0,0 +1,145 @@
+#include <doctest/doctest.h>
+import data_structures;
+
+TEST_CASE("fixed_size_pool")
+{
+    using namespace caff;
+
+    SUBCASE("chunk size is rounded up to hold a free list link")
+    {
+        fixed_size_pool pool{ 1, 1, 4 };
+
+        REQUIRE(pool.chunk_size() >= sizeof(void*));
+        REQUIRE(pool.chunk_size() % pool.chunk_alignment() == 0);
+        REQUIRE(pool.block_count() == 0);
+    }
+
+    SUBCASE("chunks are carved out of blocks")
+    {
+        fixed_size_pool pool{ sizeof(int), alignof(int), 4 };
+
+        std::vector<void*> chunks;
+        for (int i = 0; i < 4; ++i)
+        {
+            chunks.push_back(pool.allocate());
+        }
+        REQUIRE(pool.block_count() == 1);
+
+        chunks.push_back(pool.allocate());
+        REQUIRE(pool.block_count() == 2);
+
+        for (auto* chunk : chunks)
+        {
+            pool.deallocate(chunk);
+        }
+    }
+
+    SUBCASE("freed chunks are reused")
+    {
+        fixed_size_pool pool{ sizeof(int), alignof(int), 4 };
+
+        auto* first = pool.allocate();
+        pool.deallocate(first);
+
+        auto* second = pool.allocate();
+        REQUIRE(second == first);
+        REQUIRE(pool.block_count() == 1);
+
+        pool.deallocate(second);
+    }
+}
+
+TEST_CASE("pool_allocator")
+{
+    using namespace caff;
+
+    SUBCASE("copies compare equal")
+    {
+        pool_allocator<int> alloc;
+        pool_allocator<int> copy{ alloc };
+
+        REQUIRE(alloc == copy);
+        REQUIRE(alloc != pool_allocator<int>{});
+    }
+
+    SUBCASE("moves leave the source as it was")
+    {
+        pool_allocator<int> alloc;
+        const auto resource = alloc.resource();
+
+        pool_allocator<int> moved{ std::move(alloc) };
+        REQUIRE(alloc.resource() == resource);
+        REQUIRE(alloc == moved);
+    }
+
+    SUBCASE("rebound copies compare equal")
+    {
+        pool_allocator<int> alloc;
+        pool_allocator<double> rebound{ alloc };
+
+        REQUIRE(alloc == rebound);
+        REQUIRE(pool_allocator<int>{ rebound } == alloc);
+    }
+
+    SUBCASE("allocate and deallocate")
+    {
+        pool_allocator<int, 8> alloc;
+
+        SUBCASE("single object comes from the pool")
+        {
+            auto* p = alloc.allocate(1);
+            REQUIRE(alloc.pool().block_count() == 1);
+
+            alloc.deallocate(p, 1);
+            REQUIRE(alloc.allocate(1) == p);
+            alloc.deallocate(p, 1);
+        }
+
+        SUBCASE("arrays bypass the pool")
+        {
+            auto* p = alloc.allocate(16);
+            REQUIRE(alloc.pool().block_count() == 0);
+            alloc.deallocate(p, 16);
+        }
+    }
+
+    SUBCASE("linked_list node reuse")
+    {
+        linked_list<int, pool_allocator<int, 4>> list{ 1, 2, 3, 4 };
+
+        using node_allocator = decltype(list)::node_allocator_type;
+        const node_allocator alloc{ list.get_allocator() };
+        REQUIRE(alloc.pool().block_count() == 1);
+
+        for (int i = 0; i < 100; ++i)
+        {
+            list.pop_front();
+            list.push_front(i);
+        }
+        REQUIRE(alloc.pool().block_count() == 1);
+
+        list.clear();
+        list = { 5, 6, 7, 8 };
+        REQUIRE(alloc.pool().block_count() == 1);
+
+        const auto values = list | std::ranges::to<std::vector>();
+        REQUIRE(values == std::vector{ 5, 6, 7, 8 });
+    }
+
+    SUBCASE("a moved-from list outlives the list it moved to")
+    {
+        linked_list<int, pool_allocator<int, 4>> list{ 1, 2, 3 };
+
+        {
+            auto moved{ std::move(list) };
+            REQUIRE(moved.size() == 3);
+        }
+
+        // the source's allocator still holds its pool_resource alive
+        list.push_front(4);
+        list.push_front(5);
+
+        const auto values = list | std::ranges::to<std::vector>();
+        REQUIRE(values == std::vector{ 5, 4 });
+    }
+}
@@ -0,0 +1,204 @@
+#include <doctest/doctest.h>
+import data_structures;
+
+TEST_CASE("unrolled_linked_list")
+{
+    using namespace caff;
+
+    SUBCASE("member types")
+    {
+        using test_type = unrolled_linked_list<int, 4>;
+
+        static_assert(std::is_same_v<test_type::value_type, int>);
+        static_assert(std::is_same_v<test_type::size_type, std::size_t>);
+        static_assert(std::is_same_v<test_type::difference_type, std::ptrdiff_t>);
+        static_assert(std::is_same_v<test_type::reference, int&>);
+        static_assert(std::is_same_v<test_type::const_reference, const int&>);
+        static_assert(std::is_same_v<test_type::pointer, int*>);
+        static_assert(std::is_same_v<test_type::const_pointer, const int*>);
+        static_assert(std::is_same_v<test_type::iterator, unrolled_linked_list_iterator<int, 4>>);
+        static_assert(std::is_same_v<test_type::const_iterator, unrolled_linked_list_const_iterator<int, 4>>);
+        static_assert(test_type::node_capacity == 4);
+    }
+
+    SUBCASE("default constructor")
+    {
+        unrolled_linked_list<int, 4> list;
+        REQUIRE(list.empty());
+        REQUIRE(list.size() == 0);
+        REQUIRE(list.begin() == list.end());
+    }
+
+    SUBCASE("initializer_list constructor fills nodes")
+    {
+        const unrolled_linked_list<int, 4> list{ 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+        REQUIRE(list.size() == 9);
+        REQUIRE(list.node_count() == 3);
+        REQUIRE(list.front() == 1);
+        REQUIRE(list.back() == 9);
+
+        const auto values = list | std::ranges::to<std::vector>();
+        REQUIRE(values == std::vector{ 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+    }
+
+    SUBCASE("copy constructor")
+    {
+        const unrolled_linked_list<int, 4> other{ 1, 2, 3, 4, 5 };
+        const unrolled_linked_list<int, 4> list{ other };
+
+        REQUIRE(list == other);
+    }
+
+    SUBCASE("move constructor")
+    {
+        unrolled_linked_list<int, 4> other{ 1, 2, 3, 4, 5 };
+        const auto first = other.begin();
+
+        const unrolled_linked_list<int, 4> list{ std::move(other) };
+        REQUIRE(list.begin() == first);
+        REQUIRE(list.size() == 5);
+        REQUIRE(other.empty());
+    }
+
+    SUBCASE("insert")
+    {
+        unrolled_linked_list<int, 4> list{ 1, 2, 3, 4 };
+
+        SUBCASE("insert into a full node splits it")
+        {
+            auto pos = list.insert(std::next(list.begin()), 9);
+            REQUIRE(*pos == 9);
+            REQUIRE(list.node_count() == 2);
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 1, 9, 2, 3, 4 });
+        }
+
+        SUBCASE("insert into the upper half of a full node")
+        {
+            auto pos = list.insert(std::next(list.begin(), 3), 9);
+            REQUIRE(*pos == 9);
+            REQUIRE(list.node_count() == 2);
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 1, 2, 3, 9, 4 });
+        }
+
+        SUBCASE("insert at end")
+        {
+            auto pos = list.insert(list.end(), 5);
+            REQUIRE(*pos == 5);
+            REQUIRE(list.back() == 5);
+        }
+
+        SUBCASE("insert range")
+        {
+            const std::vector<int> other{ 7, 8, 9, 10, 11 };
+            auto pos = list.insert(std::next(list.begin(), 2), other.begin(),
+                other.end());
+            REQUIRE(*pos == 7);
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 1, 2, 7, 8, 9, 10, 11, 3, 4 });
+        }
+    }
+
+    SUBCASE("erase")
+    {
+        unrolled_linked_list<int, 4> list{ 1, 2, 3, 4, 5, 6 };
+
+        SUBCASE("erase merges an underfull node with its successor")
+        {
+            REQUIRE(list.node_count() == 2);
+
+            list.erase(list.begin());
+            list.erase(list.begin());
+            REQUIRE(list.node_count() == 2);
+
+            auto pos = list.erase(list.begin());
+            REQUIRE(*pos == 4);
+            REQUIRE(list.node_count() == 1);
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 4, 5, 6 });
+        }
+
+        SUBCASE("erase last element")
+        {
+            auto pos = list.erase(std::next(list.begin(), 5));
+            REQUIRE(pos == list.end());
+            REQUIRE(list.back() == 5);
+        }
+
+        SUBCASE("erase range")
+        {
+            auto pos = list.erase(std::next(list.begin()),
+                std::next(list.begin(), 5));
+            REQUIRE(*pos == 6);
+
+            const auto values = list | std::ranges::to<std::vector>();
+            REQUIRE(values == std::vector{ 1, 6 });
+        }
+
+        SUBCASE("erase everything")
+        {
+            list.erase(list.begin(), list.end());
+            REQUIRE(list.empty());
+            REQUIRE(list.node_count() == 0);
+        }
+    }
+
+    SUBCASE("push and pop")
+    {
+        unrolled_linked_list<std::string, 3> list;
+        list.push_back("c");
+        list.push_front("b");
+        list.emplace_front(1, 'a');
+        list.emplace_back("d");
+
+        const auto values = list | std::ranges::to<std::vector>();
+        REQUIRE(values == std::vector<std::string>{ "a", "b", "c", "d" });
+
+        list.pop_front();
+        REQUIRE(list.front() == "b");
+        REQUIRE(list.size() == 3);
+    }
+
+    SUBCASE("matches std::vector under random edits")
+    {
+        unrolled_linked_list<int, 5> list;
+        std::vector<int> expected;
+
+        std::mt19937 gen{ 42 };
+        for (int i = 0; i < 2000; ++i)
+        {
+            const auto index = expected.empty() ? 0 :
+                std::uniform_int_distribution<std::size_t>{ 0,
+                    expected.size() - 1 }(gen);
+
+            if (expected.empty() || gen() % 3 != 0)
+            {
+                list.insert(std::next(list.begin(), index), i);
+                expected.insert(expected.begin() + index, i);
+            }
+            else
+            {
+                list.erase(std::next(list.begin(), index));
+                expected.erase(expected.begin() + index);
+            }
+        }
+
+        REQUIRE(list.size() == expected.size());
+        REQUIRE(std::ranges::equal(list, expected));
+    }
+
+    SUBCASE("three-way comparison operator")
+    {
+        const unrolled_linked_list<int, 2> list{ 1, 3, 5 };
+
+        REQUIRE((list <=> unrolled_linked_list<int, 2>{ 1, 3, 5 }) == std::strong_ordering::equal);
+        REQUIRE((list <=> unrolled_linked_list<int, 2>{ 1, 3 }) == std::strong_ordering::greater);
+        REQUIRE((list <=> unrolled_linked_list<int, 2>{ 1, 4 }) == std::strong_ordering::less);
+    }
+}
@@ -0,0 +1,133 @@
+#include <doctest/doctest.h>
+import data_structures;
+
+TEST_CASE("work_stealing_deque")
+{
+    using namespace caff;
+
+    SUBCASE("default constructor")
+    {
+        work_stealing_deque<int> deque;
+        REQUIRE(deque.empty());
+        REQUIRE(deque.capacity() == work_stealing_deque<int>::default_capacity);
+        REQUIRE(deque.pop() == std::nullopt);
+        REQUIRE(deque.steal() == std::nullopt);
+    }
+
+    SUBCASE("capacity is rounded up to a power of two")
+    {
+        REQUIRE(work_stealing_deque<int>{ 5 }.capacity() == 8);
+        REQUIRE(work_stealing_deque<int>{ 0 }.capacity() == 2);
+    }
+
+    SUBCASE("pop takes the newest element and steal the oldest")
+    {
+        work_stealing_deque<int> deque;
+        deque.push(1);
+        deque.push(2);
+        deque.push(3);
+        REQUIRE(deque.size() == 3);
+
+        REQUIRE(deque.pop() == 3);
+        REQUIRE(deque.steal() == 1);
+        REQUIRE(deque.pop() == 2);
+        REQUIRE(deque.pop() == std::nullopt);
+        REQUIRE(deque.steal() == std::nullopt);
+        REQUIRE(deque.empty());
+    }
+
+    SUBCASE("grows when full")
+    {
+        work_stealing_deque<int> deque{ 2 };
+
+        // wrap the indices around before growing
+        deque.push(0);
+        deque.push(1);
+        REQUIRE(deque.steal() == 0);
+
+        for (int i = 2; i < 100; ++i)
+        {
+            deque.push(i);
+        }
+        REQUIRE(deque.size() == 99);
+        REQUIRE(deque.capacity() == 128);
+
+        for (int i = 1; i < 50; ++i)
+        {
+            REQUIRE(deque.steal() == i);
+        }
+        for (int i = 99; i >= 50; --i)
+        {
+            REQUIRE(deque.pop() == i);
+        }
+        REQUIRE(deque.empty());
+    }
+
+    SUBCASE("concurrent owner and thieves")
+    {
+        constexpr int thief_count{ 3 };
+        constexpr int value_count{ 50'000 };
+
+        // starts small so the owner grows the buffer under the thieves
+        work_stealing_deque<int> deque{ 2 };
+        std::atomic<int> taken{ 0 };
+        std::vector<std::vector<int>> received(thief_count + 1);
+
+        {
+            std::vector<std::jthread> thieves;
+            for (int t = 0; t < thief_count; ++t)
+            {
+                thieves.emplace_back([&, t]
+                {
+                    while (taken.load() < value_count)
+                    {
+                        if (auto value = deque.steal(); value.has_value())
+                        {
+                            received[t].push_back(*value);
+                            taken.fetch_add(1);
+                        }
+                    }
+                });
+            }
+
+            // the owner pops some of its own values as it goes
+            auto& own = received[thief_count];
+            for (int i = 0; i < value_count; ++i)
+            {
+                deque.push(i);
+
+                if (i % 3 == 0)
+                {
+                    if (auto value = deque.pop(); value.has_value())
+                    {
+                        own.push_back(*value);
+                        taken.fetch_add(1);
+                    }
+                }
+            }
+
+            while (taken.load() < value_count)
+            {
+                if (auto value = deque.pop(); value.has_value())
+                {
+                    own.push_back(*value);
+                    taken.fetch_add(1);
+                }
+            }
+        }
+
+        // every value is taken exactly once, and thieves see them in order
+        std::vector<int> all;
+        for (int t = 0; t < thief_count; ++t)
+        {
+            REQUIRE(std::ranges::is_sorted(received[t]));
+        }
+        for (const auto& values : received)
+        {
+            all.insert(all.end(), values.begin(), values.end());
+        }
+
+        std::ranges::sort(all);
+        REQUIRE(std::ranges::equal(all, std::views::iota(0, value_count)));
+    }
+}
@@ -0,0 +1,109 @@
+#include <doctest/doctest.h>
+import data_structures;
+
+namespace
+{
+    long long pool_fib(caff::work_stealing_pool& pool, int n)
+    {
+        if (n < 10)
+        {
+            return (n < 2) ? n : pool_fib(pool, n - 1) + pool_fib(pool, n - 2);
+        }
+
+        long long x{ 0 };
+        std::atomic<bool> done{ false };
+
+        pool.submit([&]
+        {
+            x = pool_fib(pool, n - 1);
+            done.store(true, std::memory_order_release);
+        });
+
+        const auto y = pool_fib(pool, n - 2);
+        pool.run_until([&] { return done.load(std::memory_order_acquire); });
+        return x + y;
+    }
+}
+
+TEST_CASE("work_stealing_pool")
+{
+    using namespace caff;
+
+    SUBCASE("thread count")
+    {
+        REQUIRE(work_stealing_pool{ 3 }.thread_count() == 3);
+        REQUIRE(work_stealing_pool{ 0 }.thread_count() == 1);
+    }
+
+    SUBCASE("runs every submitted task")
+    {
+        work_stealing_pool pool{ 4 };
+        std::atomic<int> sum{ 0 };
+
+        for (int i = 1; i <= 1000; ++i)
+        {
+            pool.submit([&sum, i] { sum.fetch_add(i); });
+        }
+
+        pool.wait();
+        REQUIRE(sum.load() == 500'500);
+    }
+
+    SUBCASE("tasks submitted from tasks are waited for")
+    {
+        work_stealing_pool pool{ 4 };
+        std::atomic<int> leaves{ 0 };
+
+        // a binary tree of tasks, 2^10 leaves deep
+        std::function<void(int)> spawn = [&](int depth)
+        {
+            if (depth == 0)
+            {
+                leaves.fetch_add(1);
+                return;
+            }
+
+            pool.submit([&, depth] { spawn(depth - 1); });
+            pool.submit([&, depth] { spawn(depth - 1); });
+        };
+
+        pool.submit([&] { spawn(10); });
+        pool.wait();
+        REQUIRE(leaves.load() == 1024);
+    }
+
+    SUBCASE("recursive fork and join")
+    {
+        work_stealing_pool pool{ 4 };
+        REQUIRE(pool_fib(pool, 25) == 75'025);
+    }
+
+    SUBCASE("destructor runs pending tasks")
+    {
+        std::atomic<int> count{ 0 };
+        {
+            work_stealing_pool pool{ 2 };
+            for (int i = 0; i < 100; ++i)
+            {
+                pool.submit([&count] { count.fetch_add(1); });
+            }
+        }
+        REQUIRE(count.load() == 100);
+    }
+
+    SUBCASE("idle workers wake up for new tasks")
+    {
+        work_stealing_pool pool{ 2 };
+        std::atomic<bool> ran{ false };
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+        pool.submit([&ran] { ran.store(true); });
+
+        // don't help, so one of the sleeping workers has to run it
+        while (!ran.load())
+        {
+            std::this_thread::yield();
+        }
+        pool.wait();
+    }
+}